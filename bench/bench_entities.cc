@@ -0,0 +1,324 @@
+// note: build & run: cmake --build build --target bench_entities && ./build/bench_entities
+//
+// EntityManagerの主要な処理のマイクロベンチマークです。
+// エンティティ数（100～1,000,000）ごとに各処理を繰り返し計測し、結果を1行1件のJSONで出力します。
+//
+// 使い方: bench_entities [--max N] [--repeat N] [--filter TEXT] [--out PATH]
+//   --max     計測する最大エンティティ数（デフォルト: 1000000）
+//   --repeat  1件あたりの計測回数（デフォルト: 5、中央値と最小値を出力）
+//   --filter  名前にTEXTを含むベンチマークだけを実行
+//   --out     出力先（省略時は標準出力）
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../game_manager/entity_manager.h"
+
+namespace {
+
+using namespace MyGame;
+
+struct Options {
+  size_t max_count = 1000000;
+  size_t repeat = 5;
+  std::string filter;
+  std::string out;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const char* arg = argv[i];
+    const char* value = argv[i + 1];
+    if (std::strcmp(arg, "--max") == 0) {
+      options.max_count = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--repeat") == 0) {
+      options.repeat = std::max<size_t>(std::strtoull(value, nullptr, 10), 1);
+    } else if (std::strcmp(arg, "--filter") == 0) {
+      options.filter = value;
+    } else if (std::strcmp(arg, "--out") == 0) {
+      options.out = value;
+    } else {
+      SDL_Log("Unknown option: %s", arg);
+      return false;
+    }
+  }
+  if (argc % 2 == 0) {
+    SDL_Log("Missing value for %s", argv[argc - 1]);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 計測と結果の出力
+ */
+class BenchRunner {
+ public:
+  // 計測ごとの準備（計測対象外）と計測する処理
+  using Setup = std::function<void()>;
+  using Body = std::function<void()>;
+
+  BenchRunner(const Options& options, FILE* out) : options_(options), out_(out) {}
+
+  /**
+   * @brief ベンチマークを実行するかどうか（--filter）
+   */
+  bool enabled(const char* name) const {
+    return options_.filter.empty() || std::strstr(name, options_.filter.c_str()) != nullptr;
+  }
+
+  /**
+   * @brief 計測して1行のJSONを出力
+   * @param name ベンチマーク名
+   * @param count エンティティ数
+   * @param param 追加のパラメータ（階層の深さ・削除率など、なければ0）
+   * @param setup 毎回の準備（計測しない）
+   * @param body 計測する処理
+   */
+  void run(const char* name, size_t count, double param, const Setup& setup,
+           const Body& body) {
+    std::vector<double> samples;
+    for (size_t i = 0; i < options_.repeat; ++i) {
+      if (setup) setup();
+      Uint64 start = SDL_GetPerformanceCounter();
+      body();
+      Uint64 end = SDL_GetPerformanceCounter();
+      samples.push_back(static_cast<double>(end - start) * 1000.0 /
+                        static_cast<double>(SDL_GetPerformanceFrequency()));
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+    double ns_per_entity = count > 0 ? median * 1.0e6 / static_cast<double>(count) : 0.0;
+
+    std::fprintf(out_,
+                 "{\"name\": \"%s\", \"count\": %zu, \"param\": %g, \"repeat\": %zu, "
+                 "\"median_ms\": %.4f, \"min_ms\": %.4f, \"max_ms\": %.4f, "
+                 "\"ns_per_entity\": %.2f}\n",
+                 name, count, param, samples.size(), median, samples.front(),
+                 samples.back(), ns_per_entity);
+    std::fflush(out_);
+  }
+
+ private:
+  const Options& options_;
+  FILE* out_;
+};
+
+// 最適化で計算が消えないように結果を書き込む先
+volatile float g_sink = 0.0f;
+
+/**
+ * @brief count個の移動する矩形エンティティをrootの直下に追加
+ */
+void addMovers(EntityManager& manager, size_t count) {
+  manager.reserveEntities(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto entity = createRectEntity(static_cast<int>(i % 4), static_cast<float>(i % 1000),
+                                   static_cast<float>(i / 1000), 8.0f, 8.0f,
+                                   SDL_Color{255, 255, 255, 255});
+    entity->getComponent<VelocityMove>()->setVelocity(10.0f, 5.0f);
+    manager.addEntity(std::move(entity));
+  }
+}
+
+void benchCreate(BenchRunner& runner, size_t count) {
+  std::unique_ptr<EntityManager> manager;
+  auto setup = [&]() { manager = std::make_unique<EntityManager>(); };
+
+  if (runner.enabled("create.rect")) {
+    runner.run("create.rect", count, 0, setup, [&]() {
+      for (size_t i = 0; i < count; ++i) {
+        manager->addEntity(createRectEntity(0, static_cast<float>(i), 0.0f, 8.0f, 8.0f,
+                                            SDL_Color{255, 255, 255, 255}));
+      }
+    });
+  }
+  if (runner.enabled("create.rotate_rect")) {
+    runner.run("create.rotate_rect", count, 0, setup, [&]() {
+      for (size_t i = 0; i < count; ++i) {
+        manager->addEntity(createRotateRectEntity(0, static_cast<float>(i), 0.0f, 8.0f,
+                                                  8.0f, SDL_Color{255, 255, 255, 255}));
+      }
+    });
+  }
+  manager.reset();
+}
+
+void benchGetComponent(BenchRunner& runner, size_t count) {
+  if (!runner.enabled("get_component")) return;
+
+  EntityManager manager;
+  std::vector<Entity*> entities;
+  entities.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    EntityHandle handle = manager.addEntity(createRotateRectEntity(
+        0, static_cast<float>(i), 0.0f, 8.0f, 8.0f, SDL_Color{255, 255, 255, 255}));
+    entities.push_back(manager.resolve(handle));
+  }
+
+  // 先頭の型（Locator）と末尾の型（RotatedRectRenderer）、持っていない型（TextRenderer）
+  runner.run("get_component.first", count, 0, nullptr, [&]() {
+    float sum = 0.0f;
+    for (Entity* entity : entities) sum += entity->getComponent<Locator>()->getX();
+    g_sink = sum;
+  });
+  runner.run("get_component.last", count, 0, nullptr, [&]() {
+    float sum = 0.0f;
+    for (Entity* entity : entities) sum += entity->getComponent<RotatedRectRenderer>() ? 1.0f : 0.0f;
+    g_sink = sum;
+  });
+  runner.run("get_component.missing", count, 0, nullptr, [&]() {
+    float sum = 0.0f;
+    for (Entity* entity : entities) sum += entity->getComponent<TextRenderer>() ? 1.0f : 0.0f;
+    g_sink = sum;
+  });
+}
+
+void benchUpdateAll(BenchRunner& runner, size_t count) {
+  if (!runner.enabled("update_all")) return;
+
+  EntityManager manager;
+  addMovers(manager, count);
+  manager.updateAll(16);  // 初回のバッファ確保を計測から外す
+
+  runner.run("update_all.movers", count, 0, nullptr, [&]() { manager.updateAll(16); });
+}
+
+void benchWorldPosition(BenchRunner& runner, size_t count) {
+  if (!runner.enabled("world_position")) return;
+
+  for (size_t depth : {1, 4, 16, 64}) {
+    if (depth > count) break;
+
+    // depth段の親子の鎖をcount / depth本作る
+    EntityManager manager;
+    std::vector<Entity*> tops;
+    std::vector<Entity*> entities;
+    size_t chains = count / depth;
+    entities.reserve(chains * depth);
+    for (size_t c = 0; c < chains; ++c) {
+      auto top = std::make_unique<Entity>(0);
+      top->emplaceComponent<Locator>(static_cast<float>(c), 0.0f);
+      Entity* parent = top.get();
+      tops.push_back(parent);
+      entities.push_back(parent);
+      for (size_t d = 1; d < depth; ++d) {
+        auto child = std::make_unique<Entity>(0);
+        child->emplaceComponent<Locator>(1.0f, 1.0f);
+        child->emplaceComponent<Rotater>(5.0f);
+        Entity* raw = child.get();
+        parent->addChild(std::move(child));
+        parent = raw;
+        entities.push_back(parent);
+      }
+      manager.addEntity(std::move(top));
+    }
+
+    // 毎回鎖の先頭を動かし、全エンティティのワールド座標を求め直す
+    float offset = 0.0f;
+    auto setup = [&]() {
+      offset += 1.0f;
+      for (Entity* top : tops) {
+        top->getComponent<Locator>()->setPosition(offset, 0.0f);
+      }
+    };
+    runner.run("world_position.dirty", entities.size(), static_cast<double>(depth), setup,
+               [&]() {
+                 float sum = 0.0f;
+                 for (Entity* entity : entities) sum += entity->getWorldPosition().first;
+                 g_sink = sum;
+               });
+    runner.run("world_position.cached", entities.size(), static_cast<double>(depth), nullptr,
+               [&]() {
+                 float sum = 0.0f;
+                 for (Entity* entity : entities) sum += entity->getWorldPosition().first;
+                 g_sink = sum;
+               });
+  }
+}
+
+void benchRenderAll(BenchRunner& runner, size_t count, SDL_Renderer* renderer) {
+  if (!renderer || !runner.enabled("render_all")) return;
+
+  EntityManager manager;
+  addMovers(manager, count);
+  manager.updateAll(16);
+
+  // 表示フラグを立てないので描画はせず、収集とソートだけを計測する
+  runner.run("render_all.collect_sort", count, 0, nullptr,
+             [&]() { manager.renderAll(renderer, 0); });
+}
+
+void benchCleanup(BenchRunner& runner, size_t count) {
+  if (!runner.enabled("cleanup")) return;
+
+  for (double ratio : {0.01, 0.1, 0.5, 0.9}) {
+    std::unique_ptr<EntityManager> manager;
+    auto setup = [&]() {
+      manager = std::make_unique<EntityManager>();
+      addMovers(*manager, count);
+      // ratioの割合のエンティティを均等な間隔で削除マーク
+      size_t dead = static_cast<size_t>(static_cast<double>(count) * ratio);
+      const auto& children = manager->getRoot()->getChildren();
+      for (size_t i = 0; i < dead; ++i) {
+        children[i * count / dead]->destroy();
+      }
+    };
+    runner.run("cleanup", count, ratio, setup, [&]() { manager->cleanup(); });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    return EXIT_FAILURE;
+  }
+
+  FILE* out = stdout;
+  if (!options.out.empty()) {
+    out = std::fopen(options.out.c_str(), "w");
+    if (!out) {
+      SDL_Log("Failed to open %s", options.out.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  // renderAllの計測用（表示しないレンダラー）
+  SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+  SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+  SDL_Window* window = nullptr;
+  SDL_Renderer* renderer = nullptr;
+  if (!SDL_Init(SDL_INIT_VIDEO) ||
+      !SDL_CreateWindowAndRenderer("bench_entities", 640, 480, SDL_WINDOW_HIDDEN, &window,
+                                   &renderer)) {
+    SDL_Log("renderAll benchmarks are skipped: %s", SDL_GetError());
+  }
+
+  BenchRunner runner(options, out);
+  for (size_t count = 100; count <= options.max_count; count *= 10) {
+    benchCreate(runner, count);
+    benchGetComponent(runner, count);
+    benchUpdateAll(runner, count);
+    benchWorldPosition(runner, count);
+    benchRenderAll(runner, count, renderer);
+    benchCleanup(runner, count);
+  }
+
+  if (renderer) SDL_DestroyRenderer(renderer);
+  if (window) SDL_DestroyWindow(window);
+  SDL_Quit();
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return EXIT_SUCCESS;
+}
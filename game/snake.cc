@@ -1,5 +1,7 @@
 #include "snake.h"
 
+#include "../game_manager/utilities/game_clock.h"
+
 namespace MyGame::SnakeGame {
 
 #pragma region non-member
@@ -154,7 +156,7 @@ void SnakeGame::snake_step() {
 
 SnakeGame::SnakeGame(SDL_Renderer* renderer) : renderer(renderer) {
   snake_initialize();
-  last_step = SDL_GetTicks();
+  last_step = Utilities::GameClock::getTicks();
 }
 
 SDL_AppResult SnakeGame::handleSdlEvent(SDL_Event* event) {
@@ -240,7 +242,7 @@ SDL_AppResult SnakeGame::handleKeyEvent(SDL_Scancode key_code) {
 // }
 
 SDL_AppResult SnakeGame::update() {
-  const Uint64 now = SDL_GetTicks();
+  const Uint64 now = Utilities::GameClock::getTicks();
   SDL_FRect r;
   unsigned i;
   unsigned j;
@@ -2,14 +2,24 @@
 
 #include <SDL3/SDL.h>
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 
 #include "../game_constant.h"
+#include "../game_manager/contact_solver.h"
 #include "../game_manager/entity_manager.h"
 #include "../game_manager/game_impl.h"
+#include "../game_manager/particle_system.h"
+#include "../game_manager/pathfinding.h"
+#include "../game_manager/prefab.h"
+#include "../game_manager/rollback_buffer.h"
+#include "../game_manager/spatial_hash.h"
+#include "../game_manager/tile_grid.h"
 #include "../game_manager/utilities/fps_counter.h"
+#include "../game_manager/utilities/game_clock.h"
 #include "../game_manager/utilities/texture_loader.h"
+#include "../game_manager/utilities/tiled_map_loader.h"
 #include "../sound/sound.h"
 
 namespace MyGame {
@@ -67,19 +77,24 @@ inline size_t toIndex(TestImpl3StateFlag flag) {
  *
  * 画面端に達したら速度を反転させます。
  * Locator、VelocityMove、RectRendererコンポーネントが必要です。
+ * 処理はTestImpl3が登録するシステムがまとめて行います（タグとしてのみ使用）。
  */
 class BounceOnEdge : public Component {
  public:
-  void update(Entity* entity, Uint64 delta_time) override {
-    auto* locator = entity->getComponent<Locator>();
-    auto* velocity = entity->getComponent<VelocityMove>();
-    auto* renderer = entity->getComponent<RectRenderer>();
+  // 移動中はVelocityMoveがエンティティを起こしておくので、タグ自体は時間に依存しない
+  bool isTimeDependent() const override { return false; }
 
-    if (!locator || !velocity || !renderer) return;
-
-    auto [x, y] = locator->getPosition();
-    auto [w, h] = renderer->getSize();
-    auto [vx, vy] = velocity->getVelocity();
+  /**
+   * @brief 画面外に出ていれば速度を反転
+   * @param locator 座標
+   * @param velocity 反転させる速度
+   * @param renderer 矩形サイズの取得元
+   */
+  static void apply(const Locator& locator, VelocityMove& velocity,
+                    const RectRenderer& renderer) {
+    auto [x, y] = locator.getPosition();
+    auto [w, h] = renderer.getSize();
+    auto [vx, vy] = velocity.getVelocity();
 
     bool changed = false;
     if (x < 0 || x + w > 640) {
@@ -92,63 +107,25 @@ class BounceOnEdge : public Component {
     }
 
     if (changed) {
-      velocity->setVelocity(vx, vy);
+      velocity.setVelocity(vx, vy);
     }
   }
 };
 
 /**
- * @brief 点滅コンポーネント
+ * @brief 点滅する振る舞い
  *
- * 周期的に表示フラグを切り替えます。
+ * 点滅状態の間、interval_msごとに表示フラグを切り替えます。
  */
-class Blink : public Component {
- public:
-  explicit Blink(Uint64 interval_ms = 500)
-      : interval_(interval_ms), timer_(0) {}
-
-  void update(Entity* entity, Uint64 delta_time) override {
-    if (entity->getStateFlag(toIndex(TestImpl3StateFlag::Blinking))) {
-      timer_ += delta_time;
-      if (timer_ > interval_) {
-        size_t visible_idx = toIndex(TestImpl3StateFlag::Visible);
-        entity->setStateFlag(visible_idx, !entity->getStateFlag(visible_idx));
-        timer_ = 0;
-      }
+inline Behavior blinkBehavior(Entity& self, Uint64 interval_ms) {
+  while (true) {
+    co_await wait(interval_ms);
+    if (self.getStateFlag(toIndex(TestImpl3StateFlag::Blinking))) {
+      size_t visible_idx = toIndex(TestImpl3StateFlag::Visible);
+      self.setStateFlag(visible_idx, !self.getStateFlag(visible_idx));
     }
   }
-
- private:
-  Uint64 interval_;
-  Uint64 timer_;
-};
-
-/**
- * @brief ピボットポイントを動的に変更するコンポーネント
- *
- * RotatedRectRendererコンポーネントのピボット位置を周期的に変更します。
- */
-class DynamicPivot : public Component {
- public:
-  explicit DynamicPivot(Uint64 period_ms = 2000)
-      : period_(period_ms), timer_(0) {}
-
-  void update(Entity* entity, Uint64 delta_time) override {
-    auto* renderer = entity->getComponent<RotatedRectRenderer>();
-    if (!renderer) return;
-
-    // ピボットを周期的に変更（円運動させる）
-    timer_ += delta_time;
-    float t = timer_ / static_cast<float>(period_);
-    float pivot_x = 0.5f + 0.4f * std::cos(t);  // 0.1～0.9の範囲
-    float pivot_y = 0.5f + 0.4f * std::sin(t);  // 0.1～0.9の範囲
-    renderer->setPivot(pivot_x, pivot_y);
-  }
-
- private:
-  Uint64 period_;
-  Uint64 timer_;
-};
+}
 
 /**
  * @brief EntityManagerのデモ実装
@@ -162,8 +139,21 @@ class TestImpl3 final : public GameImpl {
   EntityManager entity_manager_;
   Uint64 last_time_;
   Uint64 spawn_timer_;
-  Entity* player_ = nullptr;  // プレイヤーエンティティへの参照
+  EntityHandle player_;  // プレイヤーエンティティへのハンドル
+  Prefab random_rect_prefab_{1};  // ランダム生成する矩形の雛形
   Utilities::FpsCounter fps_counter_;  // FPS計測
+  RollbackBuffer rollback_{120};  // 巻き戻し用の直近ステップの記録（Bキー）
+  Uint64 sim_tick_ = 0;           // 記録したシミュレーションのティック
+  ParticleSystem particles_{20000};  // 噴水のパーティクル
+  ParticleEmitter fountain_;         // 噴水の放出設定
+  SpatialHash collision_{64.0f};     // 動く四角形同士の衝突判定
+  ContactSolver contacts_;           // 重なった四角形の押し戻しと跳ね返り
+  TileGrid tiles_;                   // プレイヤーが通れないタイル（Tiledのマップから読み込む）
+  FlowFieldCache flow_fields_{tiles_};  // プレイヤーのいるタイルへのフローフィールド
+  const FlowField* flow_field_ = nullptr;  // 追跡役がこのステップで従うフィールド
+  Prefab chaser_prefab_{2};          // タイルの上でプレイヤーを追う小さな四角形の雛形
+
+  static constexpr size_t CHASER_COUNT = 64;  // 追跡役の数
 
   // タイムスケール管理
   float target_timescale_ = 1.0f;  // Tキーで切り替えるタイムスケール（1.0 or 0.5）
@@ -183,10 +173,35 @@ class TestImpl3 final : public GameImpl {
 
  public:
   TestImpl3(SDL_Renderer* renderer)
-      : renderer_(renderer), last_time_(SDL_GetTicks()), spawn_timer_(0) {
+      : renderer_(renderer), last_time_(Utilities::GameClock::getTicks()), spawn_timer_(0) {
     // キャンバスサイズを設定（カメラのビューポートと中心位置を調整）
     entity_manager_.setCanvasSize(CANVAS_WIDTH, CANVAS_HEIGHT);
 
+    // 表示フラグのメンバーリストを管理（renderAll()が表示中のエンティティだけを走査する）
+    entity_manager_.trackStateFlag(toIndex(TestImpl3StateFlag::Visible));
+
+    // 固定ステップの間を補間して描画（GameManagerがfixedUpdate()/render()を呼び分ける）
+    entity_manager_.setInterpolationEnabled(true);
+
+    // ゲーム固有のシステムを登録
+    registerSystems();
+
+    // ランダム生成する矩形の雛形（位置・色・速度は生成時に決める）
+    random_rect_prefab_.addComponent<Locator>();
+    random_rect_prefab_.addComponent<VelocityMove>();
+    random_rect_prefab_.addComponent<RectRenderer>(30.0f, 30.0f,
+                                                   SDL_Color{255, 255, 255, 255});
+    random_rect_prefab_.addComponent<BounceOnEdge>();
+    random_rect_prefab_.addComponent<Collider>();
+    random_rect_prefab_.setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
+
+    // 追跡役の雛形（フィールドは中心のタイルで読む）
+    chaser_prefab_.addComponent<Locator>();
+    chaser_prefab_.addComponent<VelocityMove>();
+    chaser_prefab_.addComponent<RectRenderer>(6.0f, 6.0f, SDL_Color{255, 80, 160, 255});
+    chaser_prefab_.addComponent<FlowFieldFollower>(70.0f, 3.0f, 3.0f);
+    chaser_prefab_.setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
+
     // 8x8ドット絵表現用のテクスチャ読み込む
     // note: width/heightは今は使わないかも
     auto [texture, width, height] =
@@ -197,6 +212,15 @@ class TestImpl3 final : public GameImpl {
       texture_ = texture;
     }
 
+    // プレイヤーが通れないタイル（画面下部に置く）
+    Utilities::TiledMap map;
+    if (Utilities::load_tiled_map("resources/tiled_data_old_copy/TiledMaps/PlatformerTest1.tmj",
+                                  map)) {
+      tiles_.loadLayer(map, "blocks");
+      tiles_.setOrigin(0.0f, static_cast<float>(CANVAS_HEIGHT) -
+                                 static_cast<float>(map.height * map.tile_height));
+    }
+
     // サウンドエフェクト用シンセサイザーを初期化
     synthesizer_ = std::make_unique<SimpleSynthesizer>(44100);
     sequencer_ = std::make_unique<Sequencer>(synthesizer_.get(), 120.0f);
@@ -207,6 +231,16 @@ class TestImpl3 final : public GameImpl {
     // 初期BGM再生
     bgm_manager_.play("bgm1");
 
+    // 噴水のパーティクル（右下から上へ放出し、重力で落とす）
+    fountain_.rate = 400.0f;
+    fountain_.spread = 15.0f;
+    fountain_.speed_min = 200.0f;
+    fountain_.speed_max = 260.0f;
+    fountain_.lifetime_min_ms = 1200;
+    fountain_.lifetime_max_ms = 1800;
+    fountain_.color = SDL_Color{120, 200, 255, 255};
+    particles_.setGravity(0.0f, 300.0f);
+
     // テクスチャ読み込み後にエンティティを初期化
     initializeEntities();
   }
@@ -224,9 +258,11 @@ class TestImpl3 final : public GameImpl {
                   entity_manager_.getEntityCount());
           break;
         case SDL_SCANCODE_R:
-          // Rキーでリセット
-          player_ = nullptr;
+          // Rキーでリセット（player_はclear()で自動的に無効になる）
           entity_manager_.clear();
+          rollback_.clear();
+          particles_.clear();
+          collision_.clear();
           initializeEntities();
           break;
         case SDL_SCANCODE_T: {
@@ -391,44 +427,107 @@ class TestImpl3 final : public GameImpl {
     return SDL_APP_CONTINUE;
   }
 
+  /**
+   * @brief 可変ステップでの更新（FixedStepGameImplementationに対応していない呼び出し元用）
+   *
+   * 前回からの経過時間にタイムスケールを掛けて1ステップ進め、補間なしで描画します。
+   */
   SDL_AppResult update() override {
-    Uint64 current_time = SDL_GetTicks();
+    Uint64 current_time = Utilities::GameClock::getTicks();
     Uint64 delta_time = current_time - last_time_;
     last_time_ = current_time;
 
-    // FPS計測（タイムスケールの影響を受けない）
-    fps_counter_.update();
-
     // タイムスケールを適用したdelta_timeを計算
     Uint64 scaled_delta_time = static_cast<Uint64>(delta_time * current_timescale_);
 
-    // プレイヤー入力処理
+    SDL_AppResult result = fixedUpdate(scaled_delta_time);
+    if (result != SDL_APP_CONTINUE) {
+      return result;
+    }
+    return render(1.0f);
+  }
+
+  /**
+   * @brief シミュレーションを1ステップ進める
+   * @param step_ms ステップの時間（ミリ秒、タイムスケール適用済み）
+   */
+  SDL_AppResult fixedUpdate(Uint64 step_ms) {
+    // Bキーを押している間は1ステップずつ巻き戻す（記録が尽きたら停止）
+    const bool* keys = SDL_GetKeyboardState(nullptr);
+    if (keys[SDL_SCANCODE_B]) {
+      if (sim_tick_ > 0 && rollback_.restore(entity_manager_, sim_tick_ - 1)) {
+        --sim_tick_;
+        // restore()はupdateAll()を通らないので、補間の始点を戻した位置に合わせる
+        entity_manager_.resetInterpolation();
+      }
+      return SDL_APP_CONTINUE;
+    }
+
+    // プレイヤー入力処理（タイルの壁の手前で止まるように速度を抑える）
     handlePlayerInput();
+    if (Entity* player = entity_manager_.resolve(player_)) {
+      tiles_.clampVelocity(*player, step_ms);
+    }
+
+    // 追跡役が従うフィールドを選び、追跡役も壁の手前で止まるようにする
+    updateChaserGoal();
+    entity_manager_.view<FlowFieldFollower>().each(
+        [&](Entity& entity, FlowFieldFollower&) { tiles_.clampVelocity(entity, step_ms); });
+
+    // エンティティの更新
+    entity_manager_.updateAll(step_ms);
+
+    // 重なった四角形を押し戻して跳ね返らせる（回転する四角形を含む）
+    collision_.update(entity_manager_);
+    contacts_.solve(entity_manager_, collision_.getCollisions());
 
-    // エンティティの更新（タイムスケールを適用）
-    entity_manager_.updateAll(scaled_delta_time);
+    // 押し戻した後の、このステップの最終的な状態を記録
+    rollback_.capture(entity_manager_, ++sim_tick_);
 
-    // 定期的に新しいエンティティを追加（デモ、タイムスケールを適用）
-    spawn_timer_ += scaled_delta_time;
-    if (spawn_timer_ > 2000 && entity_manager_.getEntityCount() < 50) {
+    // パーティクルの更新（巻き戻しの対象外）
+    particles_.emitOverTime(fountain_, 560.0f, 440.0f, step_ms);
+    particles_.update(step_ms);
+
+    // 定期的に新しいエンティティを追加（デモ）
+    spawn_timer_ += step_ms;
+    if (spawn_timer_ > 2000 && entity_manager_.getEntityCount() < 50 + CHASER_COUNT) {
       spawnRandomEntity();
       spawn_timer_ = 0;
     }
+    return SDL_APP_CONTINUE;
+  }
+
+  /**
+   * @brief 描画
+   * @param alpha 最新のステップから次のステップまでの経過割合（描画補間に使う）
+   */
+  SDL_AppResult render(float alpha) {
+    // FPS計測（タイムスケールの影響を受けない）
+    fps_counter_.update();
 
     // 描画
     SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
     SDL_RenderClear(renderer_);
 
-    // レイヤー順に描画（Visibleフラグをチェック）
+    // レイヤー順に描画（Visibleフラグをチェック、直前のステップとの間を補間）
+    entity_manager_.setInterpolationAlpha(alpha);
     entity_manager_.renderAll(renderer_, toIndex(TestImpl3StateFlag::Visible));
 
+    // プレイヤーが通れないタイル
+    SDL_SetRenderDrawColor(renderer_, 120, 90, 60, 255);
+    tiles_.render(renderer_, entity_manager_.getCamera());
+
+    // パーティクルをまとめて描画（エンティティより手前）
+    SDL_SetRenderDrawBlendMode(renderer_, SDL_BLENDMODE_BLEND);
+    particles_.render(renderer_, entity_manager_.getCamera());
+
     // デバッグ情報
     SDL_SetRenderDrawColor(renderer_, 255, 255, 255, 255);
     char buffer[64];
-    SDL_snprintf(buffer, sizeof(buffer), "Entities: %zu",
-                 entity_manager_.getEntityCount());
+    SDL_snprintf(buffer, sizeof(buffer), "Entities: %zu, Collisions: %zu",
+                 entity_manager_.getEntityCount(), collision_.getCollisions().size());
     SDL_RenderDebugText(renderer_, 10, 10, buffer);
-    SDL_RenderDebugText(renderer_, 10, 20, "R: Reset, C: Cleanup, Q: Quit");
+    SDL_RenderDebugText(renderer_, 10, 20, "R: Reset, C: Cleanup, B: Rewind, Q: Quit");
     SDL_RenderDebugText(renderer_, 10, 30, "1-3: BGM1-3, 5: Stop, 6: Pause, 7: Resume, []: Vol");
 
     // サウンドシンセサイザーとシーケンサーを更新
@@ -443,17 +542,57 @@ class TestImpl3 final : public GameImpl {
   }
 
  private:
+  /**
+   * @brief ゲーム固有のシステムを登録
+   */
+  void registerSystems() {
+    // 画面端での跳ね返り（移動システムの後に実行される）
+    entity_manager_.getScheduler()
+        .addSystem<BounceOnEdge, Locator, VelocityMove, RectRenderer>(
+            "bounce_on_edge", componentSignature<VelocityMove>(),
+            [](Uint64, Entity&, BounceOnEdge&, Locator& locator,
+               VelocityMove& velocity, RectRenderer& renderer) {
+              BounceOnEdge::apply(locator, velocity, renderer);
+            });
+
+    // フローフィールドに沿ってプレイヤーを追う（フィールドはfixedUpdate()がステップごとに選ぶ）
+    entity_manager_.getScheduler().addSystem<FlowFieldFollower, Locator, VelocityMove>(
+        "follow_flow_field", componentSignature<VelocityMove>(),
+        [this](Uint64, Entity&, FlowFieldFollower& follower, Locator& locator,
+               VelocityMove& velocity) {
+          if (flow_field_) follower.apply(*flow_field_, locator, velocity);
+        });
+  }
+
+  /**
+   * @brief 追跡役が従うフィールドを、プレイヤーのいるタイルに向かうものにする
+   *
+   * プレイヤーがグリッドの外にいる場合は、いちばん近い端のタイルをゴールにします。
+   */
+  void updateChaserGoal() {
+    flow_field_ = nullptr;
+    Entity* player = entity_manager_.resolve(player_);
+    Aabb box;
+    if (!player || tiles_.getWidth() == 0 || !computeColliderBounds(*player, box)) return;
+    auto [goal_x, goal_y] =
+        tiles_.worldToTile((box.min_x + box.max_x) * 0.5f, (box.min_y + box.max_y) * 0.5f);
+    goal_x = std::clamp(goal_x, 0, tiles_.getWidth() - 1);
+    goal_y = std::clamp(goal_y, 0, tiles_.getHeight() - 1);
+    flow_field_ = &flow_fields_.get(goal_x, goal_y);
+  }
+
   /**
    * @brief プレイヤーの入力を処理
    */
   void handlePlayerInput() {
-    if (!player_) {
+    Entity* player = entity_manager_.resolve(player_);
+    if (!player) {
       SDL_Log("player not found.");
       return;
     }
     // VelocityMoveコンポーネントとDirectionコンポーネントを取得
-    auto* velocity = player_->getComponent<VelocityMove>();
-    auto* direction = player_->getComponent<DirectionComponent>();
+    auto* velocity = player->getComponent<VelocityMove>();
+    auto* direction = player->getComponent<DirectionComponent>();
     if (!velocity) return;
 
     // ポーズ中は入力を無効化
@@ -619,59 +758,65 @@ class TestImpl3 final : public GameImpl {
   void initializeEntities() {
     // レイヤー0: 背景
     auto bg = createRectEntity(0, 0, 0, 640, 480, SDL_Color{30, 30, 60, 255});
-    bg->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    bg->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     entity_manager_.addEntity(std::move(bg));
 
     // レイヤー1: 動く四角形（前景）
     auto rect1 =
         createRectEntity(1, 100, 100, 50, 50, SDL_Color{255, 100, 100, 255});
-    rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* vel = rect1->getComponent<VelocityMove>()) {
       vel->setVelocity(120.0f, 90.0f);  // 60FPSで2.0, 1.5ピクセル/フレーム相当
     }
-    rect1->addComponent(std::make_unique<BounceOnEdge>());
+    rect1->emplaceComponent<BounceOnEdge>();
+    rect1->emplaceComponent<Collider>();
     entity_manager_.addEntity(std::move(rect1));
 
     auto rect2 =
         createRectEntity(1, 300, 200, 60, 60, SDL_Color{100, 255, 100, 255});
-    rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* vel = rect2->getComponent<VelocityMove>()) {
       vel->setVelocity(-90.0f, 120.0f);  // 60FPSで-1.5, 2.0ピクセル/フレーム相当
     }
-    rect2->addComponent(std::make_unique<BounceOnEdge>());
+    rect2->emplaceComponent<BounceOnEdge>();
+    rect2->emplaceComponent<Collider>();
     entity_manager_.addEntity(std::move(rect2));
 
     // レイヤー2: 点滅する四角形
     auto blink_rect =
         createRectEntity(2, 250, 150, 80, 80, SDL_Color{100, 100, 255, 255});
-    blink_rect->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
-    blink_rect->setStateFlag(toIndex(TestImpl3StateFlag::Blinking), 1);
-    blink_rect->addComponent(std::make_unique<Blink>(500));
-    entity_manager_.addEntity(std::move(blink_rect));
+    blink_rect->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
+    blink_rect->setStateFlag(toIndex(TestImpl3StateFlag::Blinking), true);
+    Entity* blink = entity_manager_.resolve(entity_manager_.addEntity(std::move(blink_rect)));
+    entity_manager_.startBehavior(*blink, blinkBehavior(*blink, 500));
 
     // レイヤー3: 回転する四角形（複数）
     auto rotate_rect1 = createRotateRectEntity(3, 320, 240, 100, 100,
                                                SDL_Color{255, 200, 0, 255});
-    rotate_rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    rotate_rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = rotate_rect1->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(45.0f);  // 45度/秒で回転
     }
+    // その場で回り続ける障害物（VelocityMoveを持たないので押し戻されない）
+    rotate_rect1->removeComponent<VelocityMove>();
+    rotate_rect1->emplaceComponent<Collider>();
     entity_manager_.addEntity(std::move(rotate_rect1));
 
     auto rotate_rect2 = createRotateRectEntity(
         3, 500, 100, 60, 80, SDL_Color{0, 255, 200, 255}, 30.0f);
-    rotate_rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    rotate_rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = rotate_rect2->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(-90.0f);  // -90度/秒で逆回転
     }
     if (auto* vel = rotate_rect2->getComponent<VelocityMove>()) {
       vel->setVelocity(60.0f, 30.0f);  // 移動しながら回転（60FPSで1.0, 0.5ピクセル/フレーム相当）
     }
+    rotate_rect2->emplaceComponent<Collider>();
     entity_manager_.addEntity(std::move(rotate_rect2));
 
     auto rotate_rect3 = createRotateRectEntity(
         3, 150, 350, 70, 70, SDL_Color{255, 100, 200, 255}, 45.0f);
-    rotate_rect3->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    rotate_rect3->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = rotate_rect3->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(120.0f);  // 高速回転
     }
@@ -681,7 +826,7 @@ class TestImpl3 final : public GameImpl {
     // 左上を原点に回転（時計の針のような動き）
     auto pivot_rect1 = createRotateRectEntity(
         4, 100, 100, 120, 10, SDL_Color{255, 255, 100, 255}, 0.0f, 0.0f, 0.0f);
-    pivot_rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    pivot_rect1->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = pivot_rect1->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(30.0f);
     }
@@ -690,7 +835,7 @@ class TestImpl3 final : public GameImpl {
     // 底辺中央を原点に回転（振り子のような動き）
     auto pivot_rect2 = createRotateRectEntity(
         4, 400, 100, 15, 100, SDL_Color{100, 255, 255, 255}, 30.0f, 0.5f, 1.0f);
-    pivot_rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    pivot_rect2->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = pivot_rect2->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(60.0f);
     }
@@ -699,7 +844,7 @@ class TestImpl3 final : public GameImpl {
     // 右端中央を原点に回転（ドアが開くような動き）
     auto pivot_rect3 = createRotateRectEntity(
         4, 550, 300, 80, 120, SDL_Color{255, 150, 150, 255}, 0.0f, 1.0f, 0.5f);
-    pivot_rect3->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    pivot_rect3->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = pivot_rect3->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(-25.0f);
     }
@@ -708,30 +853,38 @@ class TestImpl3 final : public GameImpl {
     // ピボットを動的に変更（複雑な回転運動）
     auto dynamic_pivot = createRotateRectEntity(4, 320, 400, 100, 80,
                                                 SDL_Color{200, 150, 255, 255});
-    dynamic_pivot->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    dynamic_pivot->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     if (auto* ang_vel = dynamic_pivot->getComponent<AngularVelocity>()) {
       ang_vel->setAngularVelocity(90.0f);
     }
-    dynamic_pivot->addComponent(std::make_unique<DynamicPivot>(2000));
-    entity_manager_.addEntity(std::move(dynamic_pivot));
+    EntityHandle dynamic_pivot_handle = entity_manager_.addEntity(std::move(dynamic_pivot));
+    // ピボットを対角線上で往復させ、色も合わせて変える
+    entity_manager_.getTweens().start(dynamic_pivot_handle, TweenProperty::Pivot,
+                                      {0.1f, 0.1f}, {0.9f, 0.9f}, 2000,
+                                      {Easing::SmoothStep, TweenLoop::PingPong});
+    entity_manager_.getTweens().start(
+        dynamic_pivot_handle, TweenProperty::Color,
+        toTweenValue(SDL_Color{200, 150, 255, 255}),
+        toTweenValue(SDL_Color{255, 150, 150, 255}), 2000,
+        {Easing::SmoothStep, TweenLoop::PingPong});
 
     // レイヤー5: プレイヤーキャラクター
     if (texture_) {
       auto player = std::make_unique<Entity>(5);
-      player->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+      player->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
 
       // 座標・スケール
-      player->addComponent(std::make_unique<Locator>(320.0f, 240.0f));
-      player->addComponent(std::make_unique<Scaler>(4.0f, 4.0f));  // 8x8を32x32に拡大
+      player->emplaceComponent<Locator>(320.0f, 240.0f);
+      player->emplaceComponent<Scaler>(4.0f, 4.0f);  // 8x8を32x32に拡大
 
       // 移動（入力処理はhandlePlayerInput()で行う）
-      player->addComponent(std::make_unique<VelocityMove>(0.0f, 0.0f));
+      player->emplaceComponent<VelocityMove>(0.0f, 0.0f);
 
       // 向き（初期は下向き）
-      player->addComponent(std::make_unique<DirectionComponent>(Direction::Down));
+      player->emplaceComponent<DirectionComponent>(Direction::Down);
 
       // スプライト描画（初期タイル: x=0, y=1）
-      player->addComponent(std::make_unique<SpriteRenderer>(texture_, 8, 0, 1));
+      player->emplaceComponent<SpriteRenderer>(texture_, 8, 0, 1);
 
       // 向きごとのスプライトアニメーション
       std::vector<std::pair<int, int>> down_frames = {{0, 1}, {1, 1}};   // 下向き
@@ -739,19 +892,21 @@ class TestImpl3 final : public GameImpl {
       std::vector<std::pair<int, int>> right_frames = {{4, 1}, {5, 1}};  // 右向き
       // 左向きは空（右向きを左右反転）
 
-      player->addComponent(std::make_unique<SpriteAnimator>(down_frames, 500));
-      player->addComponent(std::make_unique<DirectionalSpriteAnimator>(
-          down_frames, up_frames, right_frames));
+      player->emplaceComponent<SpriteAnimator>(down_frames, 500);
+      player->emplaceComponent<DirectionalSpriteAnimator>(
+          down_frames, up_frames, right_frames);
 
-      // プレイヤーへの参照を保存してからEntityManagerに追加
-      player_ = player.get();
-      entity_manager_.addEntity(std::move(player));
+      // EntityManagerに追加し、ハンドルを保存
+      player_ = entity_manager_.addEntity(std::move(player));
     }
 
+    // レイヤー2: タイルの上でプレイヤーを追う四角形
+    spawnChasers();
+
     // レイヤー10: UI（最前面）
     // 静的テキスト（ワールド座標、カメラの影響を受ける）
     auto ui_text = createTextEntity(10, 200, 240, "Entity Demo");
-    ui_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    ui_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     entity_manager_.addEntity(std::move(ui_text));
 
     // 動的テキスト（FPS表示、UI要素として左上にアンカー）
@@ -766,7 +921,7 @@ class TestImpl3 final : public GameImpl {
           return std::string(buffer);
         },
         SDL_Color{255, 255, 255, 255}, &top_left);
-    fps_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    fps_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     entity_manager_.addEntity(std::move(fps_text));
 
     // タイムスケール表示（UI要素として左上にアンカー）
@@ -779,27 +934,41 @@ class TestImpl3 final : public GameImpl {
           return std::string(buffer);
         },
         SDL_Color{255, 255, 0, 255}, &top_left);
-    timescale_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
+    timescale_text->setStateFlag(toIndex(TestImpl3StateFlag::Visible), true);
     entity_manager_.addEntity(std::move(timescale_text));
   }
 
-  void spawnRandomEntity() {
-    float x = SDL_randf() * 540.0f + 50.0f;
-    float y = SDL_randf() * 380.0f + 50.0f;
-    Uint8 r = SDL_rand(256);
-    Uint8 g = SDL_rand(256);
-    Uint8 b = SDL_rand(256);
-
-    auto entity = createRectEntity(1, x, y, 30, 30, SDL_Color{r, g, b, 255});
-    entity->setStateFlag(toIndex(TestImpl3StateFlag::Visible), 1);
-
-    if (auto* vel = entity->getComponent<VelocityMove>()) {
-      vel->setVelocity((SDL_randf() - 0.5f) * 240.0f,
-                       (SDL_randf() - 0.5f) * 240.0f);  // 60FPSで±2ピクセル/フレーム相当
-    }
-    entity->addComponent(std::make_unique<BounceOnEdge>());
+  /**
+   * @brief タイルの通れる場所に追跡役を置く
+   */
+  void spawnChasers() {
+    if (tiles_.getWidth() == 0) return;
+    chaser_prefab_.spawn(entity_manager_, CHASER_COUNT, [this](Entity& entity, size_t) {
+      int x, y;
+      do {
+        x = SDL_rand(tiles_.getWidth());
+        y = SDL_rand(tiles_.getHeight());
+      } while (tiles_.isSolid(x, y));
+      auto [origin_x, origin_y] = tiles_.getOrigin();
+      entity.getComponent<Locator>()->setPosition(origin_x + x * tiles_.getTileWidth() + 1.0f,
+                                                  origin_y + y * tiles_.getTileHeight() + 1.0f);
+    });
+  }
 
-    entity_manager_.addEntity(std::move(entity));
+  void spawnRandomEntity() {
+    random_rect_prefab_.spawn(entity_manager_, 1, [](Entity& entity, size_t) {
+      float x = SDL_randf() * 540.0f + 50.0f;
+      float y = SDL_randf() * 380.0f + 50.0f;
+      Uint8 r = SDL_rand(256);
+      Uint8 g = SDL_rand(256);
+      Uint8 b = SDL_rand(256);
+
+      entity.getComponent<Locator>()->setPosition(x, y);
+      entity.getComponent<RectRenderer>()->setColor(SDL_Color{r, g, b, 255});
+      entity.getComponent<VelocityMove>()->setVelocity(
+          (SDL_randf() - 0.5f) * 240.0f,
+          (SDL_randf() - 0.5f) * 240.0f);  // 60FPSで±2ピクセル/フレーム相当
+    });
   }
 };
 
@@ -16,6 +16,11 @@ constexpr int CANVAS_HEIGHT = 480;
 constexpr int TARGET_FPS = 60;  // 目標フレームレート（30, 60など）
 constexpr bool ENABLE_VSYNC = true;  // VSync有効化（true推奨）
 
+// 固定ステップ設定（FixedStepGameImplementationを満たすゲーム実装のみ）
+// note: コンポーネントの経過時間はミリ秒の整数なので、ステップもミリ秒単位（8ms = 125Hz）
+constexpr Uint64 FIXED_STEP_MS = 8;  // 1ステップの時間
+constexpr int MAX_FIXED_STEPS_PER_FRAME = 8;  // 1フレームで追いつくステップ数の上限
+
 // SDL UserEvent定義
 // タイムスケール関連のイベント
 constexpr Uint32 EVENT_TIMESCALE_CHANGED = SDL_EVENT_USER + 0;  // タイムスケール変更イベント
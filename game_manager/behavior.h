@@ -0,0 +1,266 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "entity_handle.h"
+#include "pool_allocator.h"
+
+namespace MyGame {
+
+class BehaviorScheduler;
+
+/**
+ * @brief コルーチンで書くエンティティの振る舞い
+ *
+ * 待ち時間のあるゲームロジックを、タイマー変数を持つコンポーネントの代わりに
+ * 上から順に読める関数として書けます。EntityManager::startBehavior()で開始し、
+ * EntityManagerがupdateAll()の中で再開します。
+ *
+ * - co_await wait(ms): 指定した時間（タイムスケール適用後のシミュレーション時間）だけ待つ
+ * - co_await nextFrame(): 次のupdateAll()まで待つ
+ *
+ * 待っている間はタイマーホイールに入っているだけで、毎フレームの呼び出しはありません。
+ * コルーチンのフレームはSizeClassAllocatorのプールから確保します。
+ * 対象のエンティティが削除されると、次に再開する時点で再開せずに破棄されます
+ * （そのため、引数で受け取ったEntity&は再開中は常に有効です）。
+ *
+ * 使用例:
+ * @code
+ * Behavior patrol(Entity& self) {
+ *   while (true) {
+ *     self.getComponent<VelocityMove>()->setVelocity(100.0f, 0.0f);
+ *     co_await wait(2000);
+ *     self.getComponent<VelocityMove>()->setVelocity(-100.0f, 0.0f);
+ *     co_await wait(2000);
+ *   }
+ * }
+ *
+ * entity_manager.startBehavior(*entity, patrol(*entity));
+ * @endcode
+ *
+ * note: メインスレッドからのみ使用してください（フレームの確保と再開はメインスレッドで行う）
+ */
+class Behavior {
+ public:
+  struct promise_type {
+    BehaviorScheduler* scheduler = nullptr;  // 再開を管理するスケジューラ（開始時に設定）
+    EntityHandle owner;                      // 対象のエンティティ
+
+    Behavior get_return_object() {
+      return Behavior(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    // 開始後、最初のupdateAll()で実行を始める
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    // 完了後はスケジューラが破棄する
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept { std::terminate(); }
+
+    // コルーチンのフレームはプールから確保
+    static void* operator new(size_t size) {
+      return SizeClassAllocator::shared().allocate(size);
+    }
+    static void operator delete(void* block, size_t size) {
+      SizeClassAllocator::shared().deallocate(block, size);
+    }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Behavior(Behavior&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  Behavior& operator=(Behavior&& other) noexcept {
+    if (this != &other) {
+      if (handle_) handle_.destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  Behavior(const Behavior&) = delete;
+  Behavior& operator=(const Behavior&) = delete;
+
+  /**
+   * @brief デストラクタ（開始しなかった場合はフレームを破棄）
+   */
+  ~Behavior() {
+    if (handle_) handle_.destroy();
+  }
+
+  /**
+   * @brief フレームの所有権を手放す（スケジューラが引き取る）
+   */
+  Handle release() { return std::exchange(handle_, {}); }
+
+ private:
+  explicit Behavior(Handle handle) : handle_(handle) {}
+
+  Handle handle_;
+};
+
+/**
+ * @brief 一定時間待つ（co_awaitで使う）
+ */
+struct WaitAwaiter {
+  Uint64 duration_ms;  // 待つ時間（0なら次のupdateAll()まで）
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(Behavior::Handle handle) const;
+  void await_resume() const noexcept {}
+};
+
+/**
+ * @brief 指定した時間だけ待つ
+ * @param duration_ms 待つ時間（ミリ秒、シミュレーション時間）
+ */
+inline WaitAwaiter wait(Uint64 duration_ms) { return WaitAwaiter{duration_ms}; }
+
+/**
+ * @brief 指定した時間だけ待つ
+ * @param duration 待つ時間（co_await wait(500ms)のように書ける）
+ */
+inline WaitAwaiter wait(std::chrono::milliseconds duration) {
+  return WaitAwaiter{static_cast<Uint64>(std::max<std::chrono::milliseconds::rep>(duration.count(), 0))};
+}
+
+/**
+ * @brief 次のupdateAll()まで待つ
+ */
+inline WaitAwaiter nextFrame() { return WaitAwaiter{0}; }
+
+/**
+ * @brief コルーチンの振る舞いの再開を管理するスケジューラ（EntityManagerが所有）
+ *
+ * 時間待ちのコルーチンは1msごとのスロットを持つタイマーホイールに入れ、
+ * advance()で進んだ時間のスロットだけを調べます。
+ * ホイール1周（WHEEL_SIZE ms）より先の待ちは、同じスロットに入れたまま起床時刻で判定します。
+ */
+class BehaviorScheduler {
+ public:
+  static constexpr size_t WHEEL_SIZE = 1024;  // スロット数（1スロット1ms）
+
+  BehaviorScheduler() = default;
+  BehaviorScheduler(const BehaviorScheduler&) = delete;
+  BehaviorScheduler& operator=(const BehaviorScheduler&) = delete;
+
+  ~BehaviorScheduler() { clear(); }
+
+  /**
+   * @brief 振る舞いを開始（最初の実行は次のadvance()）
+   * @param owner 対象のエンティティ
+   * @param behavior 開始するコルーチン
+   */
+  void start(EntityHandle owner, Behavior behavior) {
+    Behavior::Handle handle = behavior.release();
+    if (!handle) return;
+    handle.promise().scheduler = this;
+    handle.promise().owner = owner;
+    next_frame_.push_back(handle);
+    ++count_;
+  }
+
+  /**
+   * @brief 時間を進め、起床時刻になったコルーチンを再開
+   * @param delta_ms 進める時間（ミリ秒）
+   * @param is_alive (EntityHandle) -> bool。falseのエンティティのコルーチンは再開せずに破棄する
+   */
+  template <typename IsAlive>
+  void advance(Uint64 delta_ms, IsAlive&& is_alive) {
+    // 再開中に追加された待ちは今回の対象にしない（先に対象を集めてから再開する）
+    advancing_ = true;
+    ready_.swap(next_frame_);
+
+    Uint64 from = now_;
+    now_ += delta_ms;
+    size_t slots = static_cast<size_t>(std::min<Uint64>(delta_ms, WHEEL_SIZE));
+    for (size_t i = 1; i <= slots; ++i) {
+      std::vector<Timer>& slot = wheel_[(from + i) % WHEEL_SIZE];
+      for (size_t j = 0; j < slot.size();) {
+        if (slot[j].wake_time <= now_) {
+          ready_.push_back(slot[j].handle);
+          slot[j] = slot.back();
+          slot.pop_back();
+        } else {
+          ++j;
+        }
+      }
+    }
+
+    for (Behavior::Handle handle : ready_) {
+      if (is_alive(handle.promise().owner)) {
+        handle.resume();
+        if (!handle.done()) continue;
+      }
+      handle.destroy();
+      --count_;
+    }
+    ready_.clear();
+    advancing_ = false;
+  }
+
+  /**
+   * @brief すべての振る舞いを破棄
+   *
+   * note: 振る舞いの中（advance()の途中）からは呼べません
+   */
+  void clear() {
+    if (advancing_) {
+      SDL_Log("BehaviorScheduler: clear() cannot be called from a running behavior");
+      return;
+    }
+    for (Behavior::Handle handle : next_frame_) handle.destroy();
+    next_frame_.clear();
+    for (auto& slot : wheel_) {
+      for (const Timer& timer : slot) timer.handle.destroy();
+      slot.clear();
+    }
+    count_ = 0;
+  }
+
+  /**
+   * @brief 実行中（待機中を含む）の振る舞いの数を取得
+   */
+  size_t getCount() const { return count_; }
+
+  /**
+   * @brief 現在のシミュレーション時刻を取得
+   * @return advance()で進めた時間の合計（ミリ秒）
+   */
+  Uint64 getTime() const { return now_; }
+
+ private:
+  friend struct WaitAwaiter;
+
+  struct Timer {
+    Uint64 wake_time;         // 起床時刻
+    Behavior::Handle handle;  // 再開するコルーチン
+  };
+
+  void schedule(Behavior::Handle handle, Uint64 duration_ms) {
+    if (duration_ms == 0) {
+      next_frame_.push_back(handle);
+      return;
+    }
+    Uint64 wake_time = now_ + duration_ms;
+    wheel_[wake_time % WHEEL_SIZE].push_back(Timer{wake_time, handle});
+  }
+
+  Uint64 now_ = 0;                                     // シミュレーション時刻（ミリ秒）
+  size_t count_ = 0;                                   // 実行中の振る舞いの数
+  bool advancing_ = false;                             // advance()の途中か
+  std::vector<Behavior::Handle> next_frame_;           // 次のadvance()で再開するもの
+  std::vector<Behavior::Handle> ready_;                // 今回再開するもの（作業用）
+  std::array<std::vector<Timer>, WHEEL_SIZE> wheel_;  // タイマーホイール
+};
+
+inline void WaitAwaiter::await_suspend(Behavior::Handle handle) const {
+  handle.promise().scheduler->schedule(handle, duration_ms);
+}
+
+}  // namespace MyGame
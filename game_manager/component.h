@@ -2,14 +2,21 @@
 
 #include <SDL3/SDL.h>
 
+#include <cmath>
+#include <functional>
 #include <memory>
+#include <string>
 #include <typeindex>
 #include <unordered_map>
+#include <vector>
+
+#include "pool_allocator.h"
 
 namespace MyGame {
 
 // 前方宣言
 class Entity;
+class SpriteAnimator;
 
 /**
  * @brief コンポーネントの基底クラス
@@ -21,6 +28,14 @@ class Component {
  public:
   virtual ~Component() = default;
 
+  // 個別に確保されるコンポーネント（std::make_unique等）はサイズクラス別プールから確保する
+  static void* operator new(size_t size) {
+    return SizeClassAllocator::shared().allocate(size);
+  }
+  static void operator delete(void* block, size_t size) {
+    SizeClassAllocator::shared().deallocate(block, size);
+  }
+
   /**
    * @brief コンポーネントの更新処理
    * @param entity このコンポーネントが所属するEntity
@@ -34,6 +49,82 @@ class Component {
    * @param renderer SDLレンダラー
    */
   virtual void render(Entity* entity, SDL_Renderer* renderer) {}
+
+  /**
+   * @brief 時間経過で状態が変わるコンポーネントかどうか
+   * @return 毎フレームの更新が必要ならtrue
+   *
+   * 所属Entityのコンポーネントがすべてfalseを返すと、そのEntityはスリープし、
+   * update()やシステムの処理対象から外れます（描画は継続）。
+   * 状態が変わって更新が必要になった場合は、notifyActivityChanged()で所属Entityを起こしてください。
+   * デフォルトはtrue（update()をオーバーライドするコンポーネントは常に更新される）です。
+   */
+  virtual bool isTimeDependent() const { return true; }
+
+  /**
+   * @brief 所属するEntityを取得
+   * @return 所属Entity（未追加の場合はnullptr）
+   */
+  Entity* getOwner() const { return owner_; }
+
+  /**
+   * @brief 所属するEntityを設定（Entity側から呼ばれる、内部用）
+   * @param owner 所属Entity
+   */
+  void setOwner(Entity* owner) { owner_ = owner; }
+
+  /**
+   * @brief コンポーネント型IDを取得
+   * @return 追加時に設定された型ID（componentTypeId<T>()の値）
+   */
+  Uint32 getTypeId() const { return type_id_; }
+
+  /**
+   * @brief コンポーネント型IDを設定（Entity側から呼ばれる、内部用）
+   * @param type_id 型ID
+   */
+  void setTypeId(Uint32 type_id) { type_id_ = type_id; }
+
+  /**
+   * @brief 最後に変更されたティックを取得
+   * @return 変更時のEntityManager::getChangeTick()の値（一度も記録されていなければ0）
+   */
+  Uint64 getChangedTick() const { return changed_tick_; }
+
+  /**
+   * @brief 変更ティックを設定（EntityManager側から呼ばれる、内部用）
+   * @param tick 変更ティック
+   */
+  void setChangedTick(Uint64 tick) { changed_tick_ = tick; }
+
+ protected:
+  /**
+   * @brief 座標・回転・スケールの変更を所属Entityへ通知
+   *
+   * 所属Entityとその子孫のワールド変換キャッシュを無効化します。
+   */
+  void notifyTransformChanged();
+
+  /**
+   * @brief 更新が必要になったことを所属Entityへ通知
+   *
+   * 所属Entityがスリープしている場合は起こします。
+   */
+  void notifyActivityChanged();
+
+  /**
+   * @brief 状態の変更を記録
+   *
+   * 変更ティックを進め、EntityManagerの型ごとの変更リストに載せます。
+   * 値を変えるセッターから呼んでください（EntityManager::forEachChanged()で検出できるようになります）。
+   * 所属EntityがEntityManagerに未登録の場合は、登録時にまとめて記録されます。
+   */
+  void markChanged();
+
+ private:
+  Entity* owner_ = nullptr;  // 所属Entity（非所有）
+  Uint32 type_id_ = 0;       // コンポーネント型ID
+  Uint64 changed_tick_ = 0;  // 最後に変更されたティック
 };
 
 /**
@@ -51,6 +142,8 @@ class Locator : public Component {
    */
   Locator(float x = 0.0f, float y = 0.0f) : x_(x), y_(y) {}
 
+  bool isTimeDependent() const override { return false; }
+
   /**
    * @brief 座標を設定
    * @param x X座標
@@ -59,6 +152,8 @@ class Locator : public Component {
   void setPosition(float x, float y) {
     x_ = x;
     y_ = y;
+    notifyTransformChanged();
+    markChanged();
   }
 
   /**
@@ -97,11 +192,17 @@ class Rotater : public Component {
    */
   explicit Rotater(float angle = 0.0f) : angle_(angle) {}
 
+  bool isTimeDependent() const override { return false; }
+
   /**
    * @brief 回転角度を設定
    * @param angle 回転角度（度数法）
    */
-  void setAngle(float angle) { angle_ = angle; }
+  void setAngle(float angle) {
+    angle_ = angle;
+    notifyTransformChanged();
+    markChanged();
+  }
 
   /**
    * @brief 回転角度を取得
@@ -129,6 +230,8 @@ class Scaler : public Component {
   Scaler(float scale_x = 1.0f, float scale_y = 1.0f)
       : scale_x_(scale_x), scale_y_(scale_y) {}
 
+  bool isTimeDependent() const override { return false; }
+
   /**
    * @brief スケールを設定
    * @param scale_x X方向のスケール
@@ -137,6 +240,8 @@ class Scaler : public Component {
   void setScale(float scale_x, float scale_y) {
     scale_x_ = scale_x;
     scale_y_ = scale_y;
+    notifyTransformChanged();
+    markChanged();
   }
 
   /**
@@ -177,8 +282,23 @@ class VelocityMove : public Component {
   VelocityMove(float vx = 0.0f, float vy = 0.0f)
       : velocity_x_(vx), velocity_y_(vy) {}
 
+  // 速度が0の間はスリープ可能
+  bool isTimeDependent() const override {
+    return velocity_x_ != 0.0f || velocity_y_ != 0.0f;
+  }
+
   void update(Entity* entity, Uint64 delta_time) override;
 
+  /**
+   * @brief 速度をLocatorの座標に適用（移動システム用）
+   * @param locator 移動させるLocator
+   * @param dt_sec 経過時間（秒）
+   */
+  void step(Locator& locator, float dt_sec) const {
+    auto [x, y] = locator.getPosition();
+    locator.setPosition(x + velocity_x_ * dt_sec, y + velocity_y_ * dt_sec);
+  }
+
   /**
    * @brief 速度を設定
    * @param vx X方向の速度
@@ -187,6 +307,8 @@ class VelocityMove : public Component {
   void setVelocity(float vx, float vy) {
     velocity_x_ = vx;
     velocity_y_ = vy;
+    notifyActivityChanged();
+    markChanged();
   }
 
   /**
@@ -216,13 +338,34 @@ class AngularVelocity : public Component {
   explicit AngularVelocity(float angular_vel = 0.0f)
       : angular_velocity_(angular_vel) {}
 
+  // 角速度が0の間はスリープ可能
+  bool isTimeDependent() const override { return angular_velocity_ != 0.0f; }
+
   void update(Entity* entity, Uint64 delta_time) override;
 
+  /**
+   * @brief 角速度をRotaterの角度に適用（回転システム用）
+   * @param rotater 回転させるRotater
+   * @param dt_sec 経過時間（秒）
+   *
+   * 角度は0～360度に正規化されます。
+   */
+  void step(Rotater& rotater, float dt_sec) const {
+    float angle = std::fmod(
+        rotater.getAngle() + angular_velocity_ * dt_sec, 360.0f);
+    if (angle < 0.0f) angle += 360.0f;
+    rotater.setAngle(angle);
+  }
+
   /**
    * @brief 角速度を設定
    * @param angular_vel 角速度（度/秒）
    */
-  void setAngularVelocity(float angular_vel) { angular_velocity_ = angular_vel; }
+  void setAngularVelocity(float angular_vel) {
+    angular_velocity_ = angular_vel;
+    notifyActivityChanged();
+    markChanged();
+  }
 
   /**
    * @brief 角速度を取得
@@ -251,6 +394,8 @@ class RectRenderer : public Component {
   RectRenderer(float width, float height, SDL_Color color)
       : width_(width), height_(height), color_(color) {}
 
+  bool isTimeDependent() const override { return false; }
+
   void render(Entity* entity, SDL_Renderer* renderer) override;
 
   /**
@@ -261,6 +406,7 @@ class RectRenderer : public Component {
   void setSize(float width, float height) {
     width_ = width;
     height_ = height;
+    markChanged();
   }
 
   /**
@@ -273,7 +419,10 @@ class RectRenderer : public Component {
    * @brief 色を設定
    * @param color 色
    */
-  void setColor(SDL_Color color) { color_ = color; }
+  void setColor(SDL_Color color) {
+    color_ = color;
+    markChanged();
+  }
 
   /**
    * @brief 色を取得
@@ -307,6 +456,8 @@ class RotatedRectRenderer : public Component {
       : width_(width), height_(height), color_(color),
         pivot_x_(pivot_x), pivot_y_(pivot_y) {}
 
+  bool isTimeDependent() const override { return false; }
+
   void render(Entity* entity, SDL_Renderer* renderer) override;
 
   /**
@@ -317,6 +468,7 @@ class RotatedRectRenderer : public Component {
   void setSize(float width, float height) {
     width_ = width;
     height_ = height;
+    markChanged();
   }
 
   /**
@@ -329,7 +481,10 @@ class RotatedRectRenderer : public Component {
    * @brief 色を設定
    * @param color 色
    */
-  void setColor(SDL_Color color) { color_ = color; }
+  void setColor(SDL_Color color) {
+    color_ = color;
+    markChanged();
+  }
 
   /**
    * @brief 色を取得
@@ -345,6 +500,7 @@ class RotatedRectRenderer : public Component {
   void setPivot(float pivot_x, float pivot_y) {
     pivot_x_ = pivot_x;
     pivot_y_ = pivot_y;
+    markChanged();
   }
 
   /**
@@ -386,11 +542,16 @@ class UIAnchorComponent : public Component {
   explicit UIAnchorComponent(UIAnchor anchor = UIAnchor::TopLeft)
       : anchor_(anchor) {}
 
+  bool isTimeDependent() const override { return false; }
+
   /**
    * @brief アンカーを設定
    * @param anchor アンカー位置
    */
-  void setAnchor(UIAnchor anchor) { anchor_ = anchor; }
+  void setAnchor(UIAnchor anchor) {
+    anchor_ = anchor;
+    markChanged();
+  }
 
   /**
    * @brief アンカーを取得
@@ -451,6 +612,9 @@ class TextRenderer : public Component {
                SDL_Color color = {255, 255, 255, 255})
       : color_(color), text_provider_(text_provider) {}
 
+  // 動的テキストのみ毎フレーム更新が必要
+  bool isTimeDependent() const override { return text_provider_ != nullptr; }
+
   void update(Entity* entity, Uint64 delta_time) override;
   void render(Entity* entity, SDL_Renderer* renderer) override;
 
@@ -458,7 +622,10 @@ class TextRenderer : public Component {
    * @brief テキストを設定（静的テキスト）
    * @param text 新しいテキスト
    */
-  void setText(const std::string& text) { text_ = text; }
+  void setText(const std::string& text) {
+    text_ = text;
+    markChanged();
+  }
 
   /**
    * @brief テキストを取得
@@ -470,7 +637,10 @@ class TextRenderer : public Component {
    * @brief 色を設定
    * @param color 色
    */
-  void setColor(SDL_Color color) { color_ = color; }
+  void setColor(SDL_Color color) {
+    color_ = color;
+    markChanged();
+  }
 
   /**
    * @brief 色を取得
@@ -484,6 +654,8 @@ class TextRenderer : public Component {
    */
   void setTextProvider(std::function<std::string()> provider) {
     text_provider_ = provider;
+    notifyActivityChanged();
+    markChanged();
   }
 
  private:
@@ -517,11 +689,20 @@ class DirectionComponent : public Component {
   explicit DirectionComponent(Direction direction = Direction::Down)
       : direction_(direction) {}
 
+  bool isTimeDependent() const override { return false; }
+
   /**
    * @brief 向きを設定
    * @param direction 新しい向き
    */
-  void setDirection(Direction direction) { direction_ = direction; }
+  void setDirection(Direction direction) {
+    if (direction_ != direction) {
+      direction_ = direction;
+      // DirectionalSpriteAnimatorがフレームを切り替えられるよう起こす
+      notifyActivityChanged();
+      markChanged();
+    }
+  }
 
   /**
    * @brief 向きを取得
@@ -554,6 +735,8 @@ class SpriteRenderer : public Component {
       : texture_(texture), tile_size_(tile_size), tile_x_(tile_x),
         tile_y_(tile_y), flip_horizontal_(flip_horizontal) {}
 
+  bool isTimeDependent() const override { return false; }
+
   void render(Entity* entity, SDL_Renderer* renderer) override;
 
   /**
@@ -564,6 +747,7 @@ class SpriteRenderer : public Component {
   void setTile(int tile_x, int tile_y) {
     tile_x_ = tile_x;
     tile_y_ = tile_y;
+    markChanged();
   }
 
   /**
@@ -576,7 +760,10 @@ class SpriteRenderer : public Component {
    * @brief テクスチャを設定
    * @param texture 新しいテクスチャ
    */
-  void setTexture(SDL_Texture* texture) { texture_ = texture; }
+  void setTexture(SDL_Texture* texture) {
+    texture_ = texture;
+    markChanged();
+  }
 
   /**
    * @brief テクスチャを取得
@@ -588,7 +775,10 @@ class SpriteRenderer : public Component {
    * @brief 左右反転を設定
    * @param flip 反転するかどうか
    */
-  void setFlipHorizontal(bool flip) { flip_horizontal_ = flip; }
+  void setFlipHorizontal(bool flip) {
+    flip_horizontal_ = flip;
+    markChanged();
+  }
 
   /**
    * @brief 左右反転を取得
@@ -596,6 +786,12 @@ class SpriteRenderer : public Component {
    */
   bool isFlipHorizontal() const { return flip_horizontal_; }
 
+  /**
+   * @brief タイルのサイズを取得
+   * @return タイル1つのサイズ（ピクセル）
+   */
+  int getTileSize() const { return tile_size_; }
+
  private:
   SDL_Texture* texture_;     // スプライトシートのテクスチャ
   int tile_size_;            // タイル1つのサイズ
@@ -627,24 +823,69 @@ class DirectionalSpriteAnimator : public Component {
         right_frames_(right_frames), left_frames_(left_frames),
         current_direction_(Direction::Down) {}
 
+  bool isTimeDependent() const override { return false; }
+
   void update(Entity* entity, Uint64 delta_time) override;
 
+  /**
+   * @brief 向きの変化をSpriteAnimator・SpriteRendererに反映（アニメーションシステム用）
+   * @param direction 現在の向き
+   * @param animator フレームを切り替えるSpriteAnimator
+   * @param sprite_renderer 表示タイルを即時更新するSpriteRenderer（nullptr可）
+   */
+  void step(Direction direction, SpriteAnimator& animator,
+            SpriteRenderer* sprite_renderer);
+
   /**
    * @brief 各向きのフレームリストを設定
    */
   void setDownFrames(const std::vector<std::pair<int, int>>& frames) {
     down_frames_ = frames;
+    markChanged();
   }
   void setUpFrames(const std::vector<std::pair<int, int>>& frames) {
     up_frames_ = frames;
+    markChanged();
   }
   void setRightFrames(const std::vector<std::pair<int, int>>& frames) {
     right_frames_ = frames;
+    markChanged();
   }
   void setLeftFrames(const std::vector<std::pair<int, int>>& frames) {
     left_frames_ = frames;
+    markChanged();
   }
 
+  /**
+   * @brief 向きのフレームリストを取得
+   * @param direction 向き
+   * @return 設定されたフレームリスト（左向きが空の場合も空のまま返す）
+   */
+  const std::vector<std::pair<int, int>>& getFrames(Direction direction) const {
+    switch (direction) {
+      case Direction::Up:
+        return up_frames_;
+      case Direction::Right:
+        return right_frames_;
+      case Direction::Left:
+        return left_frames_;
+      case Direction::Down:
+      default:
+        return down_frames_;
+    }
+  }
+
+  /**
+   * @brief 最後にSpriteAnimatorへ反映した向きを取得
+   */
+  Direction getAppliedDirection() const { return current_direction_; }
+
+  /**
+   * @brief 最後にSpriteAnimatorへ反映した向きを設定（状態の復元用）
+   * @param direction 反映済みとして扱う向き
+   */
+  void setAppliedDirection(Direction direction) { current_direction_ = direction; }
+
  private:
   std::vector<std::pair<int, int>> down_frames_;   // 下向きフレーム
   std::vector<std::pair<int, int>> up_frames_;     // 上向きフレーム
@@ -671,8 +912,35 @@ class SpriteAnimator : public Component {
       : frames_(frames), frame_duration_(frame_duration), current_frame_(0),
         timer_(0) {}
 
+  // 2フレーム以上ある場合のみ毎フレーム更新が必要
+  bool isTimeDependent() const override { return frames_.size() > 1; }
+
   void update(Entity* entity, Uint64 delta_time) override;
 
+  /**
+   * @brief タイマーを進め、必要ならSpriteRendererのタイルを切り替える（アニメーションシステム用）
+   * @param sprite_renderer 表示タイルを更新するSpriteRenderer
+   * @param delta_time 経過時間（ミリ秒）
+   */
+  void step(SpriteRenderer& sprite_renderer, Uint64 delta_time) {
+    if (frames_.empty()) return;
+
+    // タイマーを進める
+    timer_ += delta_time;
+
+    // フレーム切り替えが必要かチェック
+    if (timer_ >= frame_duration_) {
+      timer_ -= frame_duration_;
+
+      // 次のフレームへ
+      current_frame_ = (current_frame_ + 1) % frames_.size();
+
+      // SpriteRendererのタイルを更新
+      auto [tile_x, tile_y] = frames_[current_frame_];
+      sprite_renderer.setTile(tile_x, tile_y);
+    }
+  }
+
   /**
    * @brief フレームリストを設定
    * @param frames 新しいフレームリスト
@@ -681,13 +949,18 @@ class SpriteAnimator : public Component {
     frames_ = frames;
     current_frame_ = 0;
     timer_ = 0;
+    notifyActivityChanged();
+    markChanged();
   }
 
   /**
    * @brief フレーム表示時間を設定
    * @param duration 1フレームの表示時間（ミリ秒）
    */
-  void setFrameDuration(Uint64 duration) { frame_duration_ = duration; }
+  void setFrameDuration(Uint64 duration) {
+    frame_duration_ = duration;
+    markChanged();
+  }
 
   /**
    * @brief 現在のフレーム番号を取得
@@ -695,6 +968,34 @@ class SpriteAnimator : public Component {
    */
   size_t getCurrentFrame() const { return current_frame_; }
 
+  /**
+   * @brief フレームリストを取得
+   * @return フレームリスト（タイル座標）
+   */
+  const std::vector<std::pair<int, int>>& getFrames() const { return frames_; }
+
+  /**
+   * @brief フレーム表示時間を取得
+   * @return 1フレームの表示時間（ミリ秒）
+   */
+  Uint64 getFrameDuration() const { return frame_duration_; }
+
+  /**
+   * @brief 現在のフレームの経過時間を取得
+   * @return 経過時間（ミリ秒）
+   */
+  Uint64 getTimer() const { return timer_; }
+
+  /**
+   * @brief 再生位置を設定（状態の復元用）
+   * @param frame フレーム番号（フレーム数以上の場合は0）
+   * @param timer 現在のフレームの経過時間（ミリ秒）
+   */
+  void setPlaybackPosition(size_t frame, Uint64 timer) {
+    current_frame_ = frame < frames_.size() ? frame : 0;
+    timer_ = timer;
+  }
+
  private:
   std::vector<std::pair<int, int>> frames_;  // フレームリスト（タイル座標）
   Uint64 frame_duration_;                    // 1フレームの表示時間
@@ -702,4 +1003,61 @@ class SpriteAnimator : public Component {
   Uint64 timer_;                             // タイマー
 };
 
+/**
+ * @brief 衝突判定の対象にするコンポーネント
+ *
+ * SpatialHashに登録され、他のColliderとの重なりやクエリの対象になります。
+ * 範囲は描画コンポーネント（RectRenderer・RotatedRectRenderer・SpriteRenderer）の
+ * サイズにワールド変換を適用した矩形（軸に平行な外接矩形）です。
+ *
+ * レイヤーは自分が属するグループ、マスクは衝突する相手のグループのビットです。
+ * 2つのColliderは、互いのレイヤーが相手のマスクに含まれる場合だけ衝突します。
+ */
+class Collider : public Component {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param layer 属するレイヤー（ビット）
+   * @param mask 衝突するレイヤー（ビットの組み合わせ）
+   */
+  explicit Collider(Uint32 layer = 1, Uint32 mask = 0xFFFFFFFF)
+      : layer_(layer), mask_(mask) {}
+
+  bool isTimeDependent() const override { return false; }
+
+  /**
+   * @brief 属するレイヤーを設定
+   * @param layer レイヤー（ビット）
+   */
+  void setLayer(Uint32 layer) {
+    layer_ = layer;
+    markChanged();
+  }
+
+  /**
+   * @brief 属するレイヤーを取得
+   * @return レイヤー（ビット）
+   */
+  Uint32 getLayer() const { return layer_; }
+
+  /**
+   * @brief 衝突するレイヤーを設定
+   * @param mask レイヤー（ビットの組み合わせ）
+   */
+  void setMask(Uint32 mask) {
+    mask_ = mask;
+    markChanged();
+  }
+
+  /**
+   * @brief 衝突するレイヤーを取得
+   * @return レイヤー（ビットの組み合わせ）
+   */
+  Uint32 getMask() const { return mask_; }
+
+ private:
+  Uint32 layer_;  // 属するレイヤー
+  Uint32 mask_;   // 衝突するレイヤー
+};
+
 }  // namespace MyGame
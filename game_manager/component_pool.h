@@ -0,0 +1,205 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "component.h"
+
+namespace MyGame {
+
+/**
+ * @brief コンポーネントの解放方法を保持するデリータ
+ *
+ * ComponentPoolから確保したコンポーネントはプールへ返却し、
+ * それ以外（std::make_unique等で確保したもの）は通常のdeleteで解放します。
+ */
+struct ComponentDeleter {
+  using ReleaseFunc = void (*)(Component*, Uint32);
+
+  ReleaseFunc release = nullptr;  // プール返却関数（nullptrならdelete）
+  Uint32 slot = 0;                // プール内のスロット番号
+
+  ComponentDeleter() = default;
+  ComponentDeleter(ReleaseFunc func, Uint32 slot_index)
+      : release(func), slot(slot_index) {}
+
+  // std::unique_ptr<T>（default_delete）からの変換を許可
+  template <typename T>
+  ComponentDeleter(const std::default_delete<T>&) {}
+
+  void operator()(Component* component) const {
+    if (release) {
+      release(component, slot);
+    } else {
+      delete component;
+    }
+  }
+};
+
+/**
+ * @brief Entityが所有するコンポーネントのポインタ型
+ */
+using ComponentPtr = std::unique_ptr<Component, ComponentDeleter>;
+
+/**
+ * @brief 型ごとのコンポーネントをチャンク単位で連続配置するプール
+ *
+ * @tparam T コンポーネントの型
+ *
+ * 同じ型のコンポーネント（Locator、VelocityMoveなど）を固定長チャンクの
+ * 配列にまとめて確保します。エンティティごとに個別のヒープ確保を行う場合と比べて
+ * メモリ上の局所性が高く、forEach()による走査がキャッシュに乗りやすくなります。
+ * チャンクは再配置されないため、確保したコンポーネントのアドレスは解放まで不変です。
+ *
+ * note: スレッドセーフではありません（メインスレッドからのみ使用してください）
+ */
+template <typename T>
+class ComponentPool {
+ public:
+  static constexpr size_t CHUNK_CAPACITY = 256;  // 1チャンクあたりの要素数
+
+  ComponentPool() = default;
+  ComponentPool(const ComponentPool&) = delete;
+  ComponentPool& operator=(const ComponentPool&) = delete;
+
+  ~ComponentPool() {
+    forEach([](T& component) { component.~T(); });
+  }
+
+  /**
+   * @brief 型ごとの共有プールを取得
+   *
+   * note: 静的オブジェクトの破棄順序問題を避けるため、意図的に解放しません
+   */
+  static ComponentPool& shared() {
+    static ComponentPool* pool = new ComponentPool();
+    return *pool;
+  }
+
+  /**
+   * @brief コンポーネントをプール上に構築し、所有ポインタとして返す
+   * @param args コンストラクタ引数
+   * @return プールへ返却するデリータ付きのComponentPtr
+   */
+  template <typename... Args>
+  ComponentPtr make(Args&&... args) {
+    if (free_slots_.empty()) {
+      addChunk();
+    }
+    Uint32 slot = free_slots_.back();
+    free_slots_.pop_back();
+
+    Chunk& chunk = *chunks_[slot / CHUNK_CAPACITY];
+    size_t index = slot % CHUNK_CAPACITY;
+    T* object = ::new (chunk.at(index)) T(std::forward<Args>(args)...);
+    chunk.alive[index / 64] |= (Uint64{1} << (index % 64));
+    ++size_;
+
+    return ComponentPtr(object, ComponentDeleter(&ComponentPool::releaseShared, slot));
+  }
+
+  /**
+   * @brief 同じ値のコピーをまとめてプール上に構築
+   * @param source コピー元
+   * @param count 構築する数
+   * @param out 結果の書き込み先（out[0], out[stride], ...の順に書き込む）
+   * @param stride 書き込み先の間隔
+   *
+   * 必要なチャンクを先に確保し、型が確定したループで連続してコピー構築します。
+   */
+  void makeCopies(const T& source, size_t count, ComponentPtr* out, size_t stride) {
+    reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      Uint32 slot = free_slots_.back();
+      Chunk& chunk = *chunks_[slot / CHUNK_CAPACITY];
+      size_t index = slot % CHUNK_CAPACITY;
+      T* object = ::new (chunk.at(index)) T(source);
+      free_slots_.pop_back();
+      chunk.alive[index / 64] |= (Uint64{1} << (index % 64));
+      ++size_;
+      out[i * stride] =
+          ComponentPtr(object, ComponentDeleter(&ComponentPool::releaseShared, slot));
+    }
+  }
+
+  /**
+   * @brief 指定数を追加しても再確保が起きないようにチャンクを事前確保
+   * @param additional 追加予定の要素数
+   */
+  void reserve(size_t additional) {
+    while (free_slots_.size() < additional) {
+      addChunk();
+    }
+  }
+
+  /**
+   * @brief 生存している全コンポーネントをメモリ順に走査
+   * @param func T&を受け取る関数
+   */
+  template <typename Func>
+  void forEach(Func&& func) {
+    for (auto& chunk : chunks_) {
+      for (size_t word = 0; word < chunk->alive.size(); ++word) {
+        Uint64 bits = chunk->alive[word];
+        while (bits) {
+          size_t index = word * 64 + std::countr_zero(bits);
+          bits &= bits - 1;
+          func(*std::launder(reinterpret_cast<T*>(chunk->at(index))));
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 生存しているコンポーネント数を取得
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * @brief 確保済みの容量（チャンク数×チャンク容量）を取得
+   */
+  size_t capacity() const { return chunks_.size() * CHUNK_CAPACITY; }
+
+ private:
+  struct Chunk {
+    alignas(T) std::byte storage[sizeof(T) * CHUNK_CAPACITY];
+    std::array<Uint64, CHUNK_CAPACITY / 64> alive{};  // 生存ビット
+
+    void* at(size_t index) { return storage + sizeof(T) * index; }
+  };
+
+  void addChunk() {
+    Uint32 base = static_cast<Uint32>(chunks_.size() * CHUNK_CAPACITY);
+    chunks_.push_back(std::make_unique<Chunk>());
+    // 小さいスロット番号から使われるよう逆順に積む
+    for (size_t i = CHUNK_CAPACITY; i > 0; --i) {
+      free_slots_.push_back(base + static_cast<Uint32>(i - 1));
+    }
+  }
+
+  void destroy(T* object, Uint32 slot) {
+    object->~T();
+    Chunk& chunk = *chunks_[slot / CHUNK_CAPACITY];
+    size_t index = slot % CHUNK_CAPACITY;
+    chunk.alive[index / 64] &= ~(Uint64{1} << (index % 64));
+    free_slots_.push_back(slot);
+    --size_;
+  }
+
+  static void releaseShared(Component* component, Uint32 slot) {
+    shared().destroy(static_cast<T*>(component), slot);
+  }
+
+  std::vector<std::unique_ptr<Chunk>> chunks_;  // チャンク（再配置されない）
+  std::vector<Uint32> free_slots_;              // 空きスロット番号
+  size_t size_ = 0;                             // 生存数
+};
+
+}  // namespace MyGame
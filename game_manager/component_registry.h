@@ -0,0 +1,129 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <bit>
+#include <cstdlib>
+#include <type_traits>
+
+#include "component.h"
+
+namespace MyGame {
+
+/**
+ * @brief コンポーネント型ごとに割り当てられる連番ID
+ */
+using ComponentTypeId = Uint32;
+
+/**
+ * @brief Entityが持つコンポーネント構成を表すビットマスク（IDごとに1ビット）
+ */
+using ComponentSignature = Uint64;
+
+// 登録できるコンポーネント型の上限（ComponentSignatureのビット数）
+constexpr ComponentTypeId MAX_COMPONENT_TYPES = 64;
+
+/**
+ * @brief コンポーネント型のリスト
+ */
+template <typename... Ts>
+struct ComponentTypeList {};
+
+/**
+ * @brief 組み込みコンポーネントの一覧
+ *
+ * ここに列挙した型はコンパイル時にIDが確定します（並び順がそのままID）。
+ * ゲーム実装側で定義したコンポーネントは、初回使用時にこれ以降のIDが実行時に割り当てられます。
+ */
+using BuiltinComponentTypes =
+    ComponentTypeList<Locator, Rotater, Scaler, VelocityMove, AngularVelocity,
+                      RectRenderer, RotatedRectRenderer, UIAnchorComponent,
+                      TextRenderer, DirectionComponent, SpriteRenderer,
+                      DirectionalSpriteAnimator, SpriteAnimator, Collider>;
+
+namespace detail {
+
+template <typename T, typename... Ts>
+constexpr ComponentTypeId indexOfComponentType(ComponentTypeList<Ts...>) {
+  constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+  for (ComponentTypeId i = 0; i < sizeof...(Ts); ++i) {
+    if (matches[i]) return i;
+  }
+  return sizeof...(Ts);
+}
+
+template <typename... Ts>
+constexpr ComponentTypeId countComponentTypes(ComponentTypeList<Ts...>) {
+  return sizeof...(Ts);
+}
+
+}  // namespace detail
+
+// 組み込みコンポーネントの数（実行時IDはこの値から始まる）
+constexpr ComponentTypeId BUILTIN_COMPONENT_COUNT =
+    detail::countComponentTypes(BuiltinComponentTypes{});
+
+static_assert(BUILTIN_COMPONENT_COUNT <= MAX_COMPONENT_TYPES,
+              "Too many builtin component types");
+
+/**
+ * @brief 組み込みコンポーネントかどうか
+ */
+template <typename T>
+constexpr bool isBuiltinComponent =
+    detail::indexOfComponentType<T>(BuiltinComponentTypes{}) <
+    BUILTIN_COMPONENT_COUNT;
+
+namespace detail {
+
+/**
+ * @brief 組み込み以外のコンポーネントに次のIDを払い出す
+ */
+inline ComponentTypeId nextRuntimeComponentTypeId() {
+  static ComponentTypeId next_id = BUILTIN_COMPONENT_COUNT;
+  if (next_id >= MAX_COMPONENT_TYPES) {
+    SDL_Log("Too many component types (max %u)",
+            static_cast<unsigned int>(MAX_COMPONENT_TYPES));
+    std::abort();
+  }
+  return next_id++;
+}
+
+}  // namespace detail
+
+/**
+ * @brief コンポーネント型のIDを取得
+ * @tparam T コンポーネントの型
+ * @return 0～MAX_COMPONENT_TYPES-1の連番ID
+ *
+ * 組み込みコンポーネントはコンパイル時定数、それ以外は初回呼び出し時に確定します。
+ */
+template <typename T>
+inline ComponentTypeId componentTypeId() {
+  static_assert(std::is_base_of_v<Component, T>,
+                "T must derive from Component");
+  if constexpr (isBuiltinComponent<T>) {
+    return detail::indexOfComponentType<T>(BuiltinComponentTypes{});
+  } else {
+    static const ComponentTypeId id = detail::nextRuntimeComponentTypeId();
+    return id;
+  }
+}
+
+/**
+ * @brief 指定したコンポーネント型すべてのビットを立てたシグネチャを取得
+ * @tparam Ts コンポーネントの型
+ *
+ * 使用例:
+ * @code
+ * if ((entity->getSignature() & componentSignature<Locator, VelocityMove>()) ==
+ *     componentSignature<Locator, VelocityMove>()) { ... }
+ * @endcode
+ */
+template <typename... Ts>
+inline ComponentSignature componentSignature() {
+  return ((ComponentSignature{1} << componentTypeId<Ts>()) | ... |
+          ComponentSignature{0});
+}
+
+}  // namespace MyGame
@@ -0,0 +1,514 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "entity_handle.h"
+#include "entity_manager.h"
+#include "spatial_hash.h"
+#include "utilities/frame_profiler.h"
+
+namespace MyGame {
+
+/**
+ * @brief 向きを持つ矩形（ワールド座標）
+ */
+struct OrientedBox {
+  float center_x = 0.0f, center_y = 0.0f;  // 中心
+  float axis_x = 1.0f, axis_y = 0.0f;      // 幅方向の単位ベクトル（高さ方向は(-axis_y, axis_x)）
+  float half_width = 0.0f, half_height = 0.0f;  // 中心から辺までの長さ
+};
+
+/**
+ * @brief エンティティの衝突形状（描画コンポーネントの矩形）を向きを持つ矩形として計算
+ * @param entity 対象のエンティティ
+ * @param out_box 矩形の出力先
+ * @return 形状を持つか（RectRenderer・RotatedRectRenderer・SpriteRendererのいずれもなければfalse）
+ *
+ * 複数の描画コンポーネントを持つ場合は、RotatedRectRenderer、RectRenderer、
+ * SpriteRendererの順に最初に見つかったものを使います。
+ */
+inline bool computeOrientedBox(Entity& entity, OrientedBox& out_box) {
+  const Transform2D& world = entity.getWorldTransform();
+
+  // 中心を基準に、ピボットを原点として回転して描画されるもの
+  if (const auto* rotated = entity.getComponent<RotatedRectRenderer>()) {
+    auto [width, height] = rotated->getSize();
+    auto [pivot_x, pivot_y] = rotated->getPivot();
+    float scaled_width = width * world.scale_x;
+    float scaled_height = height * world.scale_y;
+    float pivot_offset_x = (pivot_x - 0.5f) * scaled_width;
+    float pivot_offset_y = (pivot_y - 0.5f) * scaled_height;
+    // 中心はピボットの周りに回転した位置
+    out_box.center_x = world.x + pivot_offset_x -
+                       (pivot_offset_x * world.cos_a - pivot_offset_y * world.sin_a);
+    out_box.center_y = world.y + pivot_offset_y -
+                       (pivot_offset_x * world.sin_a + pivot_offset_y * world.cos_a);
+    out_box.axis_x = world.cos_a;
+    out_box.axis_y = world.sin_a;
+    out_box.half_width = std::abs(scaled_width) * 0.5f;
+    out_box.half_height = std::abs(scaled_height) * 0.5f;
+    return true;
+  }
+
+  // 左上を基準に、回転せずに描画されるもの
+  float width = 0.0f;
+  float height = 0.0f;
+  if (const auto* rect = entity.getComponent<RectRenderer>()) {
+    std::tie(width, height) = rect->getSize();
+  } else if (const auto* sprite = entity.getComponent<SpriteRenderer>()) {
+    width = height = static_cast<float>(sprite->getTileSize());
+  } else {
+    return false;
+  }
+  float scaled_width = width * world.scale_x;
+  float scaled_height = height * world.scale_y;
+  out_box.center_x = world.x + scaled_width * 0.5f;
+  out_box.center_y = world.y + scaled_height * 0.5f;
+  out_box.axis_x = 1.0f;
+  out_box.axis_y = 0.0f;
+  out_box.half_width = std::abs(scaled_width) * 0.5f;
+  out_box.half_height = std::abs(scaled_height) * 0.5f;
+  return true;
+}
+
+/**
+ * @brief 接触（めり込んでいる2つのエンティティ）
+ */
+struct Contact {
+  EntityHandle a;
+  EntityHandle b;
+  float normal_x = 0.0f, normal_y = 0.0f;  // aからbへ押し出す向きの単位ベクトル
+  float depth = 0.0f;                      // めり込みの深さ（ピクセル）
+};
+
+/**
+ * @brief 向きを持つ矩形同士の衝突判定（ナローフェーズ）と接触の解消
+ *
+ * ブロードフェーズ（SpatialHash）が見つけた候補のペアについて、
+ * 分離軸定理（両方の矩形の辺に垂直な4軸への投影）でめり込みの向きと深さを求めます。
+ * 判定は候補のペア全体を配列ごとに分けて（SoA）並べ、分岐のない1つのループで行います。
+ *
+ * 解消は速度の反復法（逐次インパルス）です。
+ * - VelocityMoveを持つエンティティは動く（どれも同じ質量）、持たないものは動かない
+ * - 近づく向きの相対速度を打ち消し、反発係数の分だけ跳ね返す
+ * - めり込みはLocatorの座標を動かして押し戻す（slopを超えた分のpercentの割合）
+ * 回転（角速度）と摩擦は扱いません。
+ *
+ * 使用例:
+ * @code
+ * SpatialHash collision(64.0f);
+ * ContactSolver contacts;
+ *
+ * // 毎ステップ（updateAll()の後）
+ * collision.update(entity_manager);
+ * contacts.solve(entity_manager, collision.getCollisions());
+ * for (const Contact& contact : contacts.getContacts()) { ... }
+ * @endcode
+ *
+ * note: 親を持つエンティティの速度と座標は、親の回転・スケールを戻してローカル座標で書き込みます
+ */
+class ContactSolver {
+ public:
+  ContactSolver() = default;
+  ContactSolver(const ContactSolver&) = delete;
+  ContactSolver& operator=(const ContactSolver&) = delete;
+
+  /**
+   * @brief 候補のペアを判定し、めり込んでいるものを解消
+   * @param manager エンティティマネージャー
+   * @param pairs 候補のペア（SpatialHash::getCollisions()など）
+   */
+  void solve(EntityManager& manager, const std::vector<CollisionPair>& pairs) {
+    detect(manager, pairs);
+    resolve();
+  }
+
+  /**
+   * @brief 候補のペアを判定し、接触を集める（解消はしない）
+   * @param manager エンティティマネージャー
+   * @param pairs 候補のペア
+   */
+  void detect(EntityManager& manager, const std::vector<CollisionPair>& pairs) {
+    Utilities::FrameProfiler::Scope scope("contacts.detect");
+    clearBodies();
+    contacts_.clear();
+    contact_bodies_.clear();
+
+    // ペアに現れるエンティティを1つの物体にまとめ、スロット番号順に読む
+    // （ペアの順に読むとエンティティのメモリを飛び飛びにたどることになる）
+    for (const CollisionPair& pair : pairs) {
+      markBody(pair.a);
+      markBody(pair.b);
+    }
+    std::sort(marked_.begin(), marked_.end(),
+              [](const EntityHandle& x, const EntityHandle& y) { return x.index < y.index; });
+    for (EntityHandle handle : marked_) {
+      loadBody(manager, handle);
+    }
+
+    pair_a_.clear();
+    pair_b_.clear();
+    for (const CollisionPair& pair : pairs) {
+      Uint32 a = body_of_slot_[pair.a.index];
+      Uint32 b = body_of_slot_[pair.b.index];
+      if (a >= NO_SHAPE || b >= NO_SHAPE) continue;
+      pair_a_.push_back(a);
+      pair_b_.push_back(b);
+    }
+
+    // 判定用の配列に並べ直す
+    const size_t count = pair_a_.size();
+    for (std::vector<float>* values : pairArrays()) {
+      values->resize(count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const OrientedBox& a = boxes_[pair_a_[i]];
+      const OrientedBox& b = boxes_[pair_b_[i]];
+      a_x_[i] = a.center_x;
+      a_y_[i] = a.center_y;
+      a_ux_[i] = a.axis_x;
+      a_uy_[i] = a.axis_y;
+      a_hw_[i] = a.half_width;
+      a_hh_[i] = a.half_height;
+      b_x_[i] = b.center_x;
+      b_y_[i] = b.center_y;
+      b_ux_[i] = b.axis_x;
+      b_uy_[i] = b.axis_y;
+      b_hw_[i] = b.half_width;
+      b_hh_[i] = b.half_height;
+    }
+
+    testPairs(count);
+
+    // めり込んでいるものを接触として残す
+    for (size_t i = 0; i < count; ++i) {
+      if (depth_[i] <= 0.0f) continue;
+      Uint32 a = pair_a_[i];
+      Uint32 b = pair_b_[i];
+      contacts_.push_back(Contact{bodies_[a].handle, bodies_[b].handle, normal_x_[i],
+                                  normal_y_[i], depth_[i]});
+      contact_bodies_.push_back(ContactBodies{a, b});
+    }
+  }
+
+  /**
+   * @brief detect()で集めた接触を解消し、速度と座標を書き戻す
+   *
+   * note: detect()の後、エンティティを追加・削除する前に呼んでください
+   */
+  void resolve() {
+    Utilities::FrameProfiler::Scope scope("contacts.resolve");
+    const size_t count = contacts_.size();
+
+    // 近づく向きの相対速度から、跳ね返った後の目標速度を決める
+    impulses_.assign(count, 0.0f);
+    targets_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      const Body& a = bodies_[contact_bodies_[i].a];
+      const Body& b = bodies_[contact_bodies_[i].b];
+      float normal_velocity = (b.velocity_x - a.velocity_x) * contacts_[i].normal_x +
+                              (b.velocity_y - a.velocity_y) * contacts_[i].normal_y;
+      targets_[i] = normal_velocity < 0.0f ? -restitution_ * normal_velocity : 0.0f;
+    }
+
+    // 接触ごとに順にインパルスを加えることを繰り返す（累積のインパルスは押す向きのみ）
+    for (int iteration = 0; iteration < iterations_; ++iteration) {
+      for (size_t i = 0; i < count; ++i) {
+        Body& a = bodies_[contact_bodies_[i].a];
+        Body& b = bodies_[contact_bodies_[i].b];
+        float inverse_mass = a.inverse_mass + b.inverse_mass;
+        if (inverse_mass <= 0.0f) continue;
+        const Contact& contact = contacts_[i];
+        float normal_velocity = (b.velocity_x - a.velocity_x) * contact.normal_x +
+                                (b.velocity_y - a.velocity_y) * contact.normal_y;
+        float impulse = std::max(impulses_[i] + (targets_[i] - normal_velocity) / inverse_mass,
+                                 0.0f);
+        float delta = impulse - impulses_[i];
+        impulses_[i] = impulse;
+        a.velocity_x -= delta * a.inverse_mass * contact.normal_x;
+        a.velocity_y -= delta * a.inverse_mass * contact.normal_y;
+        b.velocity_x += delta * b.inverse_mass * contact.normal_x;
+        b.velocity_y += delta * b.inverse_mass * contact.normal_y;
+      }
+    }
+
+    // めり込みを押し戻す（小さなめり込みは残して、接触が途切れて震えないようにする）
+    for (size_t i = 0; i < count; ++i) {
+      Body& a = bodies_[contact_bodies_[i].a];
+      Body& b = bodies_[contact_bodies_[i].b];
+      float inverse_mass = a.inverse_mass + b.inverse_mass;
+      if (inverse_mass <= 0.0f) continue;
+      const Contact& contact = contacts_[i];
+      float correction = std::max(contact.depth - slop_, 0.0f) * percent_ / inverse_mass;
+      a.correction_x -= correction * a.inverse_mass * contact.normal_x;
+      a.correction_y -= correction * a.inverse_mass * contact.normal_y;
+      b.correction_x += correction * b.inverse_mass * contact.normal_x;
+      b.correction_y += correction * b.inverse_mass * contact.normal_y;
+    }
+
+    // 動いた物体だけ書き戻す
+    for (const Body& body : bodies_) {
+      if (body.inverse_mass <= 0.0f) continue;
+      const Transform2D& parent = body.entity->getParent()
+                                      ? body.entity->getParent()->getWorldTransform()
+                                      : Transform2D{};
+      if (body.velocity_x != body.initial_velocity_x ||
+          body.velocity_y != body.initial_velocity_y) {
+        auto [vx, vy] = toLocal(parent, body.velocity_x, body.velocity_y);
+        body.velocity->setVelocity(vx, vy);
+      }
+      if (body.correction_x != 0.0f || body.correction_y != 0.0f) {
+        if (auto* locator = body.entity->getComponent<Locator>()) {
+          auto [dx, dy] = toLocal(parent, body.correction_x, body.correction_y);
+          auto [x, y] = locator->getPosition();
+          locator->setPosition(x + dx, y + dy);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 直前のdetect()で見つかった接触を取得
+   * @return 接触のリスト（候補のペアの順、次のdetect()まで有効）
+   */
+  const std::vector<Contact>& getContacts() const { return contacts_; }
+
+  /**
+   * @brief 反発係数を設定（デフォルト: 1.0）
+   * @param restitution 0で跳ね返らない、1で速さを保って跳ね返る
+   */
+  void setRestitution(float restitution) { restitution_ = std::clamp(restitution, 0.0f, 1.0f); }
+
+  /**
+   * @brief 速度の反復回数を設定（デフォルト: 4）
+   * @param iterations 多いほど、複数の接触が重なったときの結果が正確になる
+   */
+  void setIterations(int iterations) { iterations_ = std::max(iterations, 1); }
+
+  /**
+   * @brief めり込みの押し戻し方を設定（デフォルト: 0.8, 0.5）
+   * @param percent 1回で押し戻す割合（0～1）
+   * @param slop 押し戻さずに残すめり込み（ピクセル）
+   */
+  void setPositionCorrection(float percent, float slop) {
+    percent_ = std::clamp(percent, 0.0f, 1.0f);
+    slop_ = std::max(slop, 0.0f);
+  }
+
+ private:
+  static constexpr size_t BLOCK = 64;  // testPairs()で一度に判定するペアの数
+
+  // 番号の表の特別な値（物体の番号はこれより小さい）
+  static constexpr Uint32 UNMARKED = 0xFFFFFFFF;  // 今回のペアに現れていない
+  static constexpr Uint32 NO_SHAPE = 0xFFFFFFFE;  // 現れたが、存在しないか形状を持たない
+
+  /**
+   * @brief 接触に関わるエンティティ
+   */
+  struct Body {
+    EntityHandle handle;
+    Entity* entity = nullptr;
+    VelocityMove* velocity = nullptr;  // 動かない物体はnullptr
+    float inverse_mass = 0.0f;         // 動く物体は1、動かない物体は0
+    float velocity_x = 0.0f, velocity_y = 0.0f;  // ワールド座標での速度（解消中に更新）
+    float initial_velocity_x = 0.0f, initial_velocity_y = 0.0f;
+    float correction_x = 0.0f, correction_y = 0.0f;  // 押し戻す量（ワールド座標）
+  };
+
+  /**
+   * @brief 接触の両方の物体の番号
+   */
+  struct ContactBodies {
+    Uint32 a;
+    Uint32 b;
+  };
+
+  /**
+   * @brief 物体として読み込むエンティティに印を付ける（同じエンティティは1回だけ）
+   */
+  void markBody(EntityHandle handle) {
+    if (handle.index >= body_of_slot_.size()) {
+      body_of_slot_.resize(handle.index + 1, UNMARKED);
+    }
+    Uint32& slot = body_of_slot_[handle.index];
+    if (slot != UNMARKED) return;
+    slot = NO_SHAPE;
+    marked_.push_back(handle);
+  }
+
+  /**
+   * @brief 印を付けたエンティティの形状と速度を読み込む
+   *
+   * エンティティが存在しないか形状を持たなければ、番号の表はNO_SHAPEのままにします。
+   */
+  void loadBody(EntityManager& manager, EntityHandle handle) {
+    Entity* entity = manager.resolve(handle);
+    OrientedBox box;
+    if (!entity || !computeOrientedBox(*entity, box)) return;
+
+    Body body;
+    body.handle = handle;
+    body.entity = entity;
+    body.velocity = entity->getComponent<VelocityMove>();
+    if (body.velocity) {
+      body.inverse_mass = 1.0f;
+      // VelocityMoveはローカル座標を動かすので、親の回転・スケールを掛けてワールドに直す
+      const Transform2D& parent = entity->getParent() ? entity->getParent()->getWorldTransform()
+                                                      : Transform2D{};
+      auto [vx, vy] = body.velocity->getVelocity();
+      auto [world_x, world_y] = parent.apply(vx, vy);
+      body.velocity_x = body.initial_velocity_x = world_x - parent.x;
+      body.velocity_y = body.initial_velocity_y = world_y - parent.y;
+    }
+
+    body_of_slot_[handle.index] = static_cast<Uint32>(bodies_.size());
+    bodies_.push_back(body);
+    boxes_.push_back(box);
+  }
+
+  /**
+   * @brief 前回の物体を片付ける（番号の表は使った所だけ戻す）
+   */
+  void clearBodies() {
+    for (EntityHandle handle : marked_) {
+      body_of_slot_[handle.index] = UNMARKED;
+    }
+    marked_.clear();
+    bodies_.clear();
+    boxes_.clear();
+  }
+
+  /**
+   * @brief ワールド座標でのベクトルを親のローカル座標に直す
+   */
+  static std::pair<float, float> toLocal(const Transform2D& parent, float x, float y) {
+    float local_x = x * parent.cos_a + y * parent.sin_a;
+    float local_y = -x * parent.sin_a + y * parent.cos_a;
+    return {parent.scale_x != 0.0f ? local_x / parent.scale_x : 0.0f,
+            parent.scale_y != 0.0f ? local_y / parent.scale_y : 0.0f};
+  }
+
+  /**
+   * @brief 並べたペアをまとめて分離軸定理で判定
+   * @param count ペアの数
+   *
+   * 4軸（aの幅・高さ方向、bの幅・高さ方向）への投影の重なりのうち最小のものを、
+   * めり込みの深さと向きにします（深さが0以下なら離れている）。
+   * 2つの矩形の軸の内積は|ua・ub|と|ua・vb|の2つだけで、4軸すべての投影の半径を表せます。
+   *
+   * 結果は一旦BLOCK個ずつローカルの配列に書きます。出力が入力の配列と重ならないことが
+   * コンパイラに分かるため、ループがベクトル化されます。
+   */
+  void testPairs(size_t count) {
+    const float* ax = a_x_.data();
+    const float* ay = a_y_.data();
+    const float* aux = a_ux_.data();
+    const float* auy = a_uy_.data();
+    const float* ahw = a_hw_.data();
+    const float* ahh = a_hh_.data();
+    const float* bx = b_x_.data();
+    const float* by = b_y_.data();
+    const float* bux = b_ux_.data();
+    const float* buy = b_uy_.data();
+    const float* bhw = b_hw_.data();
+    const float* bhh = b_hh_.data();
+    float* normal_x = normal_x_.data();
+    float* normal_y = normal_y_.data();
+    float* depth = depth_.data();
+
+    for (size_t begin = 0; begin < count; begin += BLOCK) {
+      const size_t size = std::min(count - begin, BLOCK);
+      float block_normal_x[BLOCK];
+      float block_normal_y[BLOCK];
+      float block_depth[BLOCK];
+      for (size_t j = 0; j < size; ++j) {
+        const size_t i = begin + j;
+        float dx = bx[i] - ax[i];
+        float dy = by[i] - ay[i];
+        float same = std::abs(aux[i] * bux[i] + auy[i] * buy[i]);   // |ua・ub| = |va・vb|
+        float cross = std::abs(aux[i] * buy[i] - auy[i] * bux[i]);  // |ua・vb| = |va・ub|
+
+        // 各軸への中心間の距離（符号付き）
+        float d0 = dx * aux[i] + dy * auy[i];
+        float d1 = -dx * auy[i] + dy * aux[i];
+        float d2 = dx * bux[i] + dy * buy[i];
+        float d3 = -dx * buy[i] + dy * bux[i];
+
+        // 各軸での重なり = 両方の投影の半径 - 中心間の距離
+        float o0 = ahw[i] + bhw[i] * same + bhh[i] * cross - std::abs(d0);
+        float o1 = ahh[i] + bhw[i] * cross + bhh[i] * same - std::abs(d1);
+        float o2 = bhw[i] + ahw[i] * same + ahh[i] * cross - std::abs(d2);
+        float o3 = bhh[i] + ahw[i] * cross + ahh[i] * same - std::abs(d3);
+
+        // 最小の重なりの軸を選ぶ（aからbへ向ける）
+        float best = o0;
+        float nx = aux[i];
+        float ny = auy[i];
+        float d = d0;
+        bool pick = o1 < best;
+        best = pick ? o1 : best;
+        nx = pick ? -auy[i] : nx;
+        ny = pick ? aux[i] : ny;
+        d = pick ? d1 : d;
+        pick = o2 < best;
+        best = pick ? o2 : best;
+        nx = pick ? bux[i] : nx;
+        ny = pick ? buy[i] : ny;
+        d = pick ? d2 : d;
+        pick = o3 < best;
+        best = pick ? o3 : best;
+        nx = pick ? -buy[i] : nx;
+        ny = pick ? bux[i] : ny;
+        d = pick ? d3 : d;
+
+        float sign = d < 0.0f ? -1.0f : 1.0f;
+        block_normal_x[j] = nx * sign;
+        block_normal_y[j] = ny * sign;
+        block_depth[j] = best;
+      }
+      std::copy_n(block_normal_x, size, normal_x + begin);
+      std::copy_n(block_normal_y, size, normal_y + begin);
+      std::copy_n(block_depth, size, depth + begin);
+    }
+  }
+
+  /**
+   * @brief ペアごとの値の配列（まとめて確保する）
+   */
+  std::array<std::vector<float>*, 15> pairArrays() {
+    return {&a_x_, &a_y_, &a_ux_, &a_uy_, &a_hw_, &a_hh_, &b_x_, &b_y_,
+            &b_ux_, &b_uy_, &b_hw_, &b_hh_, &normal_x_, &normal_y_, &depth_};
+  }
+
+  float restitution_ = 1.0f;  // 反発係数
+  int iterations_ = 4;        // 速度の反復回数
+  float percent_ = 0.8f;      // 1回で押し戻す割合
+  float slop_ = 0.5f;         // 押し戻さずに残すめり込み（ピクセル）
+
+  // 物体（接触に関わるエンティティ）
+  std::vector<Body> bodies_;
+  std::vector<OrientedBox> boxes_;      // 物体の形状（bodies_と同じ添字）
+  std::vector<Uint32> body_of_slot_;    // ハンドルのスロット番号 → 物体の番号
+  std::vector<EntityHandle> marked_;    // 今回のペアに現れたエンティティ
+
+  // 判定するペア（添字が同じものが1つのペア）
+  std::vector<Uint32> pair_a_, pair_b_;  // 物体の番号
+  std::vector<float> a_x_, a_y_, a_ux_, a_uy_, a_hw_, a_hh_;  // aの中心・軸・半分の大きさ
+  std::vector<float> b_x_, b_y_, b_ux_, b_uy_, b_hw_, b_hh_;  // bの中心・軸・半分の大きさ
+  std::vector<float> normal_x_, normal_y_, depth_;            // 判定結果
+
+  // 接触（添字が同じものが1つの接触）
+  std::vector<Contact> contacts_;
+  std::vector<ContactBodies> contact_bodies_;
+  std::vector<float> impulses_;  // 累積のインパルス
+  std::vector<float> targets_;   // 跳ね返った後の目標の相対速度
+};
+
+}  // namespace MyGame
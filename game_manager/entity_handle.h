@@ -0,0 +1,39 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+namespace MyGame {
+
+/**
+ * @brief エンティティへの世代付きハンドル
+ *
+ * EntityManagerが発行する、スロット番号と世代番号の組です。
+ * エンティティが削除されるとスロットの世代が進むため、古いハンドルは
+ * EntityManager::resolve()でnullptrになります（解放済みメモリを指すことがありません）。
+ * 値型なので、ゲーム側で大量に保持・コピーしても安価です。
+ *
+ * 使用例:
+ * @code
+ * EntityHandle handle = entity_manager.addEntity(std::move(entity));
+ * ...
+ * if (Entity* entity = entity_manager.resolve(handle)) { ... }
+ * @endcode
+ */
+struct EntityHandle {
+  Uint32 index = 0;       // スロット番号
+  Uint32 generation = 0;  // 世代番号（0は無効なハンドル）
+
+  /**
+   * @brief 発行済みのハンドルかどうか（生存しているかはresolve()で確認）
+   */
+  bool isValid() const { return generation != 0; }
+
+  explicit operator bool() const { return isValid(); }
+
+  bool operator==(const EntityHandle& other) const {
+    return index == other.index && generation == other.generation;
+  }
+  bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+}  // namespace MyGame
@@ -4,19 +4,34 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
+#include <functional>
 #include <map>
 #include <memory>
-#include <typeindex>
+#include <mutex>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
+#include "behavior.h"
 #include "component.h"
+#include "component_pool.h"
+#include "component_registry.h"
+#include "entity_handle.h"
+#include "pool_allocator.h"
+#include "transform2d.h"
+#include "tween.h"
+#include "utilities/frame_profiler.h"
+#include "utilities/thread_pool.h"
 
 namespace MyGame {
 
 // 前方宣言
 class Camera2D;
+class EntityManager;
 
 /**
  * @brief ゲームエンティティの基底クラス
@@ -30,23 +45,58 @@ class Entity {
  public:
   static constexpr size_t MAX_STATE_FLAGS = 8;
 
+  // 状態フラグのビット集合（フラグごとに1ビット）
+  using StateFlagBits = Uint32;
+  static_assert(MAX_STATE_FLAGS <= sizeof(StateFlagBits) * 8,
+                "StateFlagBits is too small for MAX_STATE_FLAGS");
+
+  // 子エンティティ・コンポーネントの配列（バッファはサイズクラス別プールから確保）
+  using ChildList =
+      std::vector<std::unique_ptr<Entity>, PoolAllocator<std::unique_ptr<Entity>>>;
+  using ComponentList = std::vector<ComponentPtr, PoolAllocator<ComponentPtr>>;
+
+  // エンティティ本体もサイズクラス別プールから確保する（派生クラスのサイズにも対応）
+  static void* operator new(size_t size) {
+    return SizeClassAllocator::shared().allocate(size);
+  }
+  static void operator delete(void* block, size_t size) {
+    SizeClassAllocator::shared().deallocate(block, size);
+  }
+
   /**
    * @brief コンストラクタ
    * @param layer レイヤー番号（小さいほど背景側）
    */
-  explicit Entity(int layer = 0) : layer_(layer), active_(true), parent_(nullptr) {
-    state_flags_.fill(0);
-  }
+  explicit Entity(int layer = 0)
+      : layer_(layer), active_(true), parent_(nullptr), world_dirty_(true) {}
 
-  virtual ~Entity() = default;
+  /**
+   * @brief デストラクタ
+   *
+   * EntityManagerに登録されている場合は登録を解除し、ハンドルを無効化します。
+   */
+  virtual ~Entity();
 
   /**
    * @brief エンティティの更新処理
    * @param delta_time 前フレームからの経過時間（ミリ秒）
    *
    * コンポーネントのみで動作する場合は、この関数を実装する必要はありません。
+   * note: この基底の実装は、update()がオーバーライドされていない目印を付けます
+   *       （オーバーライドしたupdate()から呼ぶと、スリープの対象になります）
+   */
+  virtual void update(Uint64 delta_time) { default_update_called_ = true; }
+
+  /**
+   * @brief エンティティ自身のupdate()が毎フレーム必要かどうか
+   * @return 必要ならtrue
+   *
+   * デフォルトでは、update()をオーバーライドした派生クラスはtrue（常に起きている）です。
+   * オーバーライドしていない場合は、最初の更新で基底のupdate()が呼ばれた時点でfalseになり、
+   * 時間依存のコンポーネントがない間はスリープします。
+   * update()を持つが毎フレームは不要な派生クラスは、オーバーライドしてfalseを返してください。
    */
-  virtual void update(Uint64 delta_time) {}
+  virtual bool isTimeDependent() const { return !default_update_called_; }
 
   /**
    * @brief エンティティの描画処理
@@ -75,31 +125,43 @@ class Entity {
   bool isActive() const { return active_; }
 
   /**
-   * @brief エンティティを削除マーク（次のクリーンアップで削除）
+   * @brief エンティティを削除マーク
+   *
+   * EntityManagerに登録されている場合は削除リストに追加され、
+   * 次のコマンド適用時（updateAll()の最後、またはcleanup()）にメモリから解放されます。
    */
-  void destroy() { active_ = false; }
+  void destroy();
 
   /**
    * @brief 状態フラグを取得
    * @param index フラグのインデックス（0～MAX_STATE_FLAGS-1）
-   * @return フラグの値
+   * @return フラグが立っているか
+   *
+   * note: フラグは1ビットで保持するため、値は立っている/いないの2値のみです
    */
-  int getStateFlag(size_t index) const { return state_flags_[index]; }
+  bool getStateFlag(size_t index) const {
+    return (state_flags_ >> index) & 1;
+  }
 
   /**
    * @brief 状態フラグを設定
    * @param index フラグのインデックス（0～MAX_STATE_FLAGS-1）
-   * @param value 設定する値
+   * @param set trueで立てる、falseで下ろす
+   *
+   * EntityManagerがこのフラグのメンバーリストを管理している場合は、リストも更新されます。
    */
-  void setStateFlag(size_t index, int value) { state_flags_[index] = value; }
+  void setStateFlag(size_t index, bool set) {
+    StateFlagBits bit = StateFlagBits{1} << index;
+    if (((state_flags_ & bit) != 0) == set) return;
+    state_flags_ ^= bit;
+    notifyStateFlagChanged(index, set);
+  }
 
   /**
    * @brief すべての状態フラグを取得
-   * @return 状態フラグの配列
+   * @return 状態フラグのビット集合（フラグiはビットi）
    */
-  const std::array<int, MAX_STATE_FLAGS>& getStateFlags() const {
-    return state_flags_;
-  }
+  StateFlagBits getStateFlags() const { return state_flags_; }
 
   /**
    * @brief コンポーネントを追加
@@ -108,7 +170,47 @@ class Entity {
    */
   template <typename T>
   void addComponent(std::unique_ptr<T> component) {
-    components_[std::type_index(typeid(T))] = std::move(component);
+    addComponentById(componentTypeId<T>(), ComponentPtr(component.release()));
+  }
+
+  /**
+   * @brief コンポーネントを型ごとの共有プール上に構築して追加
+   * @tparam T コンポーネントの型
+   * @param args コンストラクタ引数
+   * @return 追加されたコンポーネントへのポインタ
+   *
+   * ComponentPool<T>の連続領域に配置されるため、
+   * std::make_uniqueで個別に確保するよりも走査時のキャッシュ効率が良くなります。
+   */
+  template <typename T, typename... Args>
+  T* emplaceComponent(Args&&... args) {
+    ComponentPtr component =
+        ComponentPool<T>::shared().make(std::forward<Args>(args)...);
+    T* raw = static_cast<T*>(component.get());
+    addComponentById(componentTypeId<T>(), std::move(component));
+    return raw;
+  }
+
+  /**
+   * @brief コンポーネントをID指定で追加（内部用）
+   * @param id コンポーネント型ID
+   * @param component 追加するコンポーネント（所有権を移譲）
+   *
+   * 同じIDのコンポーネントが既にある場合は置き換えます。
+   */
+  void addComponentById(ComponentTypeId id, ComponentPtr component) {
+    component->setOwner(this);
+    component->setTypeId(id);
+    size_t index = componentIndex(id);
+    if (signature_ & componentBit(id)) {
+      retireComponent(std::move(components_[index]));
+      components_[index] = std::move(component);
+    } else {
+      components_.insert(components_.begin() + index, std::move(component));
+      signature_ |= componentBit(id);
+    }
+    markWorldTransformDirty();
+    notifyComponentAdded(components_[index].get());
   }
 
   /**
@@ -118,11 +220,7 @@ class Entity {
    */
   template <typename T>
   T* getComponent() {
-    auto it = components_.find(std::type_index(typeid(T)));
-    if (it != components_.end()) {
-      return static_cast<T*>(it->second.get());
-    }
-    return nullptr;
+    return static_cast<T*>(getComponentById(componentTypeId<T>()));
   }
 
   /**
@@ -132,11 +230,21 @@ class Entity {
    */
   template <typename T>
   const T* getComponent() const {
-    auto it = components_.find(std::type_index(typeid(T)));
-    if (it != components_.end()) {
-      return static_cast<const T*>(it->second.get());
+    return static_cast<const T*>(getComponentById(componentTypeId<T>()));
+  }
+
+  /**
+   * @brief コンポーネントをID指定で取得
+   * @param id コンポーネント型ID
+   * @return コンポーネントへのポインタ（存在しない場合はnullptr）
+   *
+   * シグネチャのビット判定と、下位ビットのpopcountによる配列添字計算のみで取得できます。
+   */
+  Component* getComponentById(ComponentTypeId id) const {
+    if (!(signature_ & componentBit(id))) {
+      return nullptr;
     }
-    return nullptr;
+    return components_[componentIndex(id)].get();
   }
 
   /**
@@ -145,7 +253,23 @@ class Entity {
    */
   template <typename T>
   void removeComponent() {
-    components_.erase(std::type_index(typeid(T)));
+    removeComponentById(componentTypeId<T>());
+  }
+
+  /**
+   * @brief コンポーネントをID指定で削除（内部用）
+   * @param id コンポーネント型ID
+   */
+  void removeComponentById(ComponentTypeId id) {
+    if (!(signature_ & componentBit(id))) {
+      return;
+    }
+    size_t index = componentIndex(id);
+    retireComponent(std::move(components_[index]));
+    components_.erase(components_.begin() + index);
+    signature_ &= ~componentBit(id);
+    markWorldTransformDirty();
+    notifyComponentRemoved(id);
   }
 
   /**
@@ -155,44 +279,70 @@ class Entity {
    */
   template <typename T>
   bool hasComponent() const {
-    return components_.find(std::type_index(typeid(T))) != components_.end();
+    return (signature_ & componentBit(componentTypeId<T>())) != 0;
   }
 
   /**
-   * @brief すべてのコンポーネントを取得（内部用）
-   * @return コンポーネントマップへの参照
+   * @brief 指定したコンポーネントをすべて持っているか確認
+   * @param signature 必要なコンポーネントのシグネチャ
+   * @return すべて持っている場合true
    */
-  const std::unordered_map<std::type_index, std::unique_ptr<Component>>&
-  getComponents() const {
-    return components_;
+  bool hasComponents(ComponentSignature signature) const {
+    return (signature_ & signature) == signature;
   }
 
+  /**
+   * @brief コンポーネント構成のシグネチャを取得
+   * @return 所持しているコンポーネントのIDごとにビットが立ったマスク
+   */
+  ComponentSignature getSignature() const { return signature_; }
+
+  /**
+   * @brief すべてのコンポーネントを取得（内部用）
+   * @return コンポーネント型ID順に並んだコンポーネントの配列
+   */
+  const ComponentList& getComponents() const { return components_; }
+
+  /**
+   * @brief コンポーネント配列の容量を事前確保
+   * @param count 予定しているコンポーネント数
+   */
+  void reserveComponents(size_t count) { components_.reserve(count); }
+
+  /**
+   * @brief 子エンティティ配列の容量を事前確保
+   * @param count 予定している子エンティティ数
+   */
+  void reserveChildren(size_t count) { children_.reserve(count); }
+
   /**
    * @brief 子エンティティを追加
    * @param child 追加する子エンティティ（所有権を移譲）
    */
-  void addChild(std::unique_ptr<Entity> child) {
-    child->parent_ = this;
-    children_.push_back(std::move(child));
-  }
+  void addChild(std::unique_ptr<Entity> child);
 
   /**
    * @brief 子エンティティを削除して返す
    * @param child 削除する子エンティティへのポインタ
-   * @return 削除されたエンティティ（所有権を返す）
+   * @return 削除されたエンティティ（所有権を返す、子でない場合はnullptr）
    */
   std::unique_ptr<Entity> removeChild(Entity* child) {
-    auto it = std::find_if(
-        children_.begin(), children_.end(),
-        [child](const std::unique_ptr<Entity>& e) { return e.get() == child; });
+    if (!child || child->parent_ != this) {
+      return nullptr;
+    }
 
-    if (it != children_.end()) {
-      std::unique_ptr<Entity> removed = std::move(*it);
-      removed->parent_ = nullptr;
-      children_.erase(it);
-      return removed;
+    // 記録した添字で取り除き、後ろの兄弟の添字を詰める（兄弟の並び順は保持される）
+    size_t index = child->sibling_index_;
+    std::unique_ptr<Entity> removed = std::move(children_[index]);
+    children_.erase(children_.begin() + index);
+    for (size_t i = index; i < children_.size(); ++i) {
+      children_[i]->sibling_index_ = i;
     }
-    return nullptr;
+
+    removed->parent_ = nullptr;
+    removed->markWorldTransformDirty();
+    notifyChildRemoved(removed.get());
+    return removed;
   }
 
   /**
@@ -215,11 +365,23 @@ class Entity {
    */
   Entity* getParent() const { return parent_; }
 
+  /**
+   * @brief このエンティティのハンドルを取得
+   * @return ハンドル（EntityManagerに未登録の場合は無効なハンドル）
+   */
+  EntityHandle getHandle() const { return handle_; }
+
+  /**
+   * @brief 登録先のEntityManagerを取得
+   * @return EntityManagerへのポインタ（未登録の場合はnullptr）
+   */
+  EntityManager* getManager() const { return manager_; }
+
   /**
    * @brief 子エンティティのリストを取得
    * @return 子エンティティのリスト
    */
-  const std::vector<std::unique_ptr<Entity>>& getChildren() const {
+  const ChildList& getChildren() const {
     return children_;
   }
 
@@ -289,80 +451,152 @@ class Entity {
   }
 
   /**
-   * @brief ワールド座標を取得（親の座標・回転・スケールを考慮）
-   * @return {x, y}
+   * @brief ワールド変換を取得（親の座標・回転・スケールを考慮）
+   * @return キャッシュされたワールド変換
+   *
+   * ローカルのLocator/Rotater/Scalerまたは祖先が変更された場合のみ再計算します。
+   * 変更がなければ親をたどらずにキャッシュを返します。
    */
-  std::pair<float, float> getWorldPosition() const {
-    auto [local_x, local_y] = getLocalPosition();
-
-    if (!parent_) {
-      return {local_x, local_y};
+  const Transform2D& getWorldTransform() const {
+    if (world_dirty_.load(std::memory_order_relaxed)) {
+      static const Transform2D identity;
+      const Transform2D& parent_transform =
+          parent_ ? parent_->getWorldTransform() : identity;
+      auto [local_x, local_y] = getLocalPosition();
+      auto [local_scale_x, local_scale_y] = getLocalScale();
+      world_transform_ =
+          Transform2D::compose(parent_transform, local_x, local_y,
+                               getLocalAngle(), local_scale_x, local_scale_y);
+      world_dirty_.store(false, std::memory_order_relaxed);
     }
+    return world_transform_;
+  }
 
-    auto [parent_x, parent_y] = parent_->getWorldPosition();
-    float parent_angle = parent_->getWorldAngle();
-    auto [parent_scale_x, parent_scale_y] = parent_->getWorldScale();
-
-    // 親のスケールを適用
-    float scaled_x = local_x * parent_scale_x;
-    float scaled_y = local_y * parent_scale_y;
-
-    // 親の回転を考慮した座標変換
-    float rad = parent_angle * (3.14159265358979323846f / 180.0f);
-    float cos_a = std::cos(rad);
-    float sin_a = std::sin(rad);
-
-    float rotated_x = scaled_x * cos_a - scaled_y * sin_a;
-    float rotated_y = scaled_x * sin_a + scaled_y * cos_a;
+  /**
+   * @brief ワールド変換キャッシュを無効化（子孫も含む）
+   *
+   * 「dirtyなEntityの子孫は必ずdirty」という不変条件を保つため、
+   * 既にdirtyな場合は子孫をたどらずに終了します。
+   */
+  void markWorldTransformDirty() {
+    if (world_dirty_.load(std::memory_order_relaxed)) return;
+    world_dirty_.store(true, std::memory_order_relaxed);
+    for (auto& child : children_) {
+      child->markWorldTransformDirty();
+    }
+  }
 
-    return {parent_x + rotated_x, parent_y + rotated_y};
+  /**
+   * @brief ワールド座標を取得（親の座標・回転・スケールを考慮）
+   * @return {x, y}
+   */
+  std::pair<float, float> getWorldPosition() const {
+    const Transform2D& world = getWorldTransform();
+    return {world.x, world.y};
   }
 
   /**
    * @brief ワールド回転角度を取得（親の回転を考慮）
    * @return 回転角度（度数法）
    */
-  float getWorldAngle() const {
-    float local_angle = getLocalAngle();
-
-    if (!parent_) {
-      return local_angle;
-    }
-    return parent_->getWorldAngle() + local_angle;
-  }
+  float getWorldAngle() const { return getWorldTransform().angle; }
 
   /**
    * @brief ワールドスケールを取得（親のスケールを考慮）
    * @return {scale_x, scale_y}
    */
   std::pair<float, float> getWorldScale() const {
-    auto [local_scale_x, local_scale_y] = getLocalScale();
+    const Transform2D& world = getWorldTransform();
+    return {world.scale_x, world.scale_y};
+  }
+
+  /**
+   * @brief 描画に使う変換を取得（固定ステップの描画補間を考慮）
+   * @return 描画補間が有効なEntityManagerに登録されている場合は、直前のステップと
+   *         現在のワールド変換の間を補間した値。それ以外はgetWorldTransform()と同じ
+   */
+  Transform2D getRenderTransform() const;
+
+  /**
+   * @brief 描画補間をリセット
+   *
+   * ワープなど、直前の位置から補間して見せたくない移動の後に呼びます
+   * （次のステップまでは補間せずに現在の位置で描画される）。
+   */
+  void resetInterpolation() { interpolation_step_ = 0; }
 
-    if (!parent_) {
-      return {local_scale_x, local_scale_y};
+  /**
+   * @brief 毎フレームの更新が必要かどうか（自身またはいずれかのコンポーネントが時間依存）
+   * @return 必要ならtrue
+   */
+  bool needsUpdate() const {
+    if (isTimeDependent()) return true;
+    for (const auto& component : components_) {
+      if (component->isTimeDependent()) return true;
     }
+    return false;
+  }
+
+  /**
+   * @brief 起きている（更新対象になっている）かどうか
+   * @return 起きていればtrue
+   */
+  bool isAwake() const { return awake_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief スリープしていれば起こして更新対象に戻す
+   *
+   * EntityManagerに登録されていない場合は何もしません。
+   * 更新が不要なままであれば、次のフレームの終わりに再びスリープします。
+   */
+  void wake();
 
-    auto [parent_scale_x, parent_scale_y] = parent_->getWorldScale();
-    return {local_scale_x * parent_scale_x, local_scale_y * parent_scale_y};
+  /**
+   * @brief このエンティティのみ更新（子は含まない）
+   * @param delta_time 前フレームからの経過時間（ミリ秒）
+   * @param skip_components update()を呼ばないコンポーネントのシグネチャ
+   */
+  void updateSelf(Uint64 delta_time, ComponentSignature skip_components = 0) {
+    // 従来のupdate()を呼ぶ（後方互換性）
+    update(delta_time);
+
+    // 全コンポーネントのupdate()を呼ぶ（型ID順）
+    // note: 開始時のシグネチャの型を、その時点で持っているものだけ更新する
+    //       （update中に追加された型は次のフレームから、削除された型はそれ以降呼ばない）。
+    //       update中に削除・置き換えられたコンポーネントは、ループが終わるまで解放しない
+    const size_t retired_mark = retired_components_.size();
+    const bool was_updating = updating_components_;
+    updating_components_ = true;
+    for (ComponentSignature pending = signature_ & ~skip_components; pending;
+         pending &= pending - 1) {
+      ComponentTypeId id = static_cast<ComponentTypeId>(std::countr_zero(pending));
+      if (Component* component = getComponentById(id)) {
+        component->update(this, delta_time);
+      }
+    }
+    updating_components_ = was_updating;
+    retired_components_.erase(retired_components_.begin() + retired_mark,
+                              retired_components_.end());
   }
 
   /**
    * @brief 子エンティティを含めて更新
    * @param delta_time 前フレームからの経過時間（ミリ秒）
+   * @param skip_components update()を呼ばないコンポーネントのシグネチャ
+   *
+   * skip_componentsに含まれる型は、EntityManagerのシステム（ビューによる一括処理）で
+   * 更新されるため、ここでは仮想関数を呼びません。
+   * note: EntityManager::updateAll()は起きているエンティティのみをupdateSelf()で更新します
    */
-  void updateWithChildren(Uint64 delta_time) {
+  void updateWithChildren(Uint64 delta_time,
+                          ComponentSignature skip_components = 0) {
     if (active_) {
-      // 従来のupdate()を呼ぶ（後方互換性）
-      update(delta_time);
-
-      // 全コンポーネントのupdate()を呼ぶ
-      for (auto& [type, component] : components_) {
-        component->update(this, delta_time);
-      }
+      updateSelf(delta_time, skip_components);
 
       // 子エンティティも更新
-      for (auto& child : children_) {
-        child->updateWithChildren(delta_time);
+      // note: 更新中に子が追加されても安全なように添字でアクセス
+      for (size_t i = 0; i < children_.size(); ++i) {
+        children_[i]->updateWithChildren(delta_time, skip_components);
       }
     }
   }
@@ -379,7 +613,7 @@ class Entity {
       render(renderer);
 
       // 全コンポーネントのrender()を呼ぶ
-      for (auto& [type, component] : components_) {
+      for (auto& component : components_) {
         component->render(this, renderer);
       }
     }
@@ -403,19 +637,92 @@ class Entity {
   const Camera2D* getRenderCamera() const { return render_camera_; }
 
  private:
-  int layer_;                                    // レイヤー番号
-  bool active_;                                  // アクティブフラグ
-  std::array<int, MAX_STATE_FLAGS> state_flags_; // 状態フラグ配列
+  static ComponentSignature componentBit(ComponentTypeId id) {
+    return ComponentSignature{1} << id;
+  }
+
+  // IDより小さいビットの数 = components_内での添字
+  size_t componentIndex(ComponentTypeId id) const {
+    return std::popcount(signature_ & (componentBit(id) - 1));
+  }
+
+  /**
+   * @brief 子の追加を登録先のEntityManagerへ通知（階層配列への反映）
+   */
+  void notifyChildAdded(Entity* child);
+
+  /**
+   * @brief 子の削除を登録先のEntityManagerへ通知（階層配列への反映）
+   */
+  void notifyChildRemoved(Entity* child);
+
+  /**
+   * @brief コンポーネントの追加を登録先のEntityManagerへ通知（起床と変更の記録）
+   */
+  void notifyComponentAdded(Component* component);
+
+  /**
+   * @brief コンポーネントの削除を登録先のEntityManagerへ通知（削除の記録）
+   */
+  void notifyComponentRemoved(ComponentTypeId id);
+
+  /**
+   * @brief 取り外したコンポーネントを解放（updateSelf()の途中なら、ループの後まで遅らせる）
+   * @param component 取り外したコンポーネント
+   */
+  void retireComponent(ComponentPtr component) {
+    if (updating_components_) {
+      retired_components_.push_back(std::move(component));
+    }
+  }
+
+  /**
+   * @brief 状態フラグの変化を登録先のEntityManagerへ通知（メンバーリストの更新）
+   */
+  void notifyStateFlagChanged(size_t index, bool set);
+
+  int layer_;                       // レイヤー番号
+  bool active_;                     // アクティブフラグ
+  StateFlagBits state_flags_ = 0;   // 状態フラグ（フラグごとに1ビット）
+  bool in_tree_ = false;            // rootにつながっているか（EntityManagerが管理）
+  bool default_update_called_ = false;  // 基底のupdate()が呼ばれたか（update()をオーバーライドしていない）
+  // 各フラグのメンバーリスト内での添字（EntityManagerが管理、リストに載っている間のみ有効）
+  std::array<Uint32, MAX_STATE_FLAGS> state_flag_member_index_{};
 
   // 親子関係
   Entity* parent_;                                 // 親エンティティ（非所有）
-  std::vector<std::unique_ptr<Entity>> children_;  // 子エンティティ（所有）
+  ChildList children_;                             // 子エンティティ（所有）
+  size_t sibling_index_ = 0;                       // 親のchildren_内での添字
+  Uint32 hierarchy_index_ = 0xFFFFFFFF;            // FlatHierarchy内での添字（FlatHierarchyが管理）
 
   // コンポーネント管理
-  std::unordered_map<std::type_index, std::unique_ptr<Component>> components_;
+  // components_は型ID順に並び、signature_の立っているビットと1対1で対応する
+  ComponentSignature signature_ = 0;        // 所持コンポーネントのビットマスク
+  ComponentList components_;                // コンポーネント（型ID順）
+  bool updating_components_ = false;        // updateSelf()でコンポーネントを更新中か
+  // updateSelf()の途中で取り外されたコンポーネント（ループの後で解放、スレッドごと）
+  static inline thread_local std::vector<ComponentPtr> retired_components_;
+
+  // ワールド変換キャッシュ
+  mutable Transform2D world_transform_;    // 最後に計算したワールド変換
+  // note: 並列実行されるシステムから子孫のフラグが同時に立てられることがあるためatomic
+  mutable std::atomic<bool> world_dirty_;  // 再計算が必要か
+
+  // 描画補間（EntityManagerがステップの開始時に記録する）
+  Transform2D previous_world_transform_;  // 直前のステップ開始時のワールド変換
+  Uint64 interpolation_step_ = 0;         // 記録したステップの番号（0なら未記録）
 
   // 描画時のカメラ（一時的に設定される、非所有）
   const Camera2D* render_camera_ = nullptr;
+
+  friend class FlatHierarchy;
+
+  // EntityManagerへの登録情報（EntityManagerが設定する）
+  friend class EntityManager;
+  EntityManager* manager_ = nullptr;  // 登録先（非所有）
+  EntityHandle handle_;               // 発行されたハンドル
+  std::atomic<bool> awake_{false};    // 更新対象リストに入っているか
+  size_t awake_index_ = 0;            // 更新対象リスト内での添字
 };
 
 /**
@@ -430,13 +737,15 @@ class RootEntity : public Entity {
   RootEntity() : Entity(0) {
     // rootはコンポーネントを持たない
     // 座標は常に(0, 0)
-    setStateFlag(0, 1);  // デフォルトで表示
+    setStateFlag(0, true);  // デフォルトで表示
   }
 
   void update(Uint64 delta_time) override {
     // rootは何もしない（子の更新はupdateWithChildren()で行われる）
   }
 
+  bool isTimeDependent() const override { return false; }
+
   void render(SDL_Renderer* renderer) override {
     // rootは何も描画しない（子の描画はrenderWithChildren()で行われる）
   }
@@ -547,129 +856,1723 @@ class Camera2D {
 };
 
 /**
- * @brief エンティティを管理するコンテナクラス
+ * @brief 指定したコンポーネントをすべて持つエンティティの一覧（ビュー）
  *
- * ツリー構造（シーングラフ）でエンティティを管理します。
- * 常にrootエンティティを持ち、全てのエンティティはrootの子孫として配置されます。
- * Camera2Dを持ち、描画時の視点変換を行います。
+ * @tparam Ts 必要なコンポーネントの型
+ *
+ * EntityManager::view<Ts...>()で取得します。
+ * 作成時点で条件に一致したアクティブなエンティティを保持し、
+ * 走査時は各コンポーネントへの参照を直接渡します。
+ *
+ * 使用例:
+ * @code
+ * for (auto [entity, locator, velocity] :
+ *      entity_manager.view<Locator, VelocityMove>()) {
+ *   velocity.step(locator, dt_sec);
+ * }
+ *
+ * entity_manager.view<Locator, VelocityMove>().each(
+ *     [&](Entity& entity, Locator& locator, VelocityMove& velocity) { ... });
+ * @endcode
+ *
+ * note: 走査中にコンポーネントを削除した場合、そのエンティティの参照は無効になります
  */
-class EntityManager {
+template <typename... Ts>
+class EntityView {
  public:
-  using EntityPtr = std::unique_ptr<Entity>;
-  using EntityList = std::vector<EntityPtr>;
+  using value_type = std::tuple<Entity&, Ts&...>;
 
-  EntityManager()
-      : root_(std::make_unique<RootEntity>()), camera_(std::make_unique<Camera2D>()) {}
-  ~EntityManager() = default;
+  /**
+   * @brief ビューのイテレータ（参照のタプルを返す）
+   */
+  class Iterator {
+   public:
+    explicit Iterator(std::vector<Entity*>::const_iterator it) : it_(it) {}
+
+    value_type operator*() const {
+      Entity& entity = **it_;
+      return value_type(entity, *entity.template getComponent<Ts>()...);
+    }
+
+    Iterator& operator++() {
+      ++it_;
+      return *this;
+    }
+
+    bool operator==(const Iterator& other) const { return it_ == other.it_; }
+    bool operator!=(const Iterator& other) const { return it_ != other.it_; }
+
+   private:
+    std::vector<Entity*>::const_iterator it_;
+  };
 
   /**
-   * @brief rootエンティティを取得
-   * @return rootエンティティへのポインタ
+   * @brief コンストラクタ（EntityManager::view()から呼ばれる）
+   * @param entities 一致したエンティティ
+   * @param recycle 破棄時にバッファを返却する先（nullptrなら返却しない）
    */
-  Entity* getRoot() { return root_.get(); }
+  EntityView(std::vector<Entity*> entities,
+             std::vector<std::vector<Entity*>>* recycle = nullptr)
+      : entities_(std::move(entities)), recycle_(recycle) {}
+
+  ~EntityView() {
+    if (recycle_) {
+      entities_.clear();
+      recycle_->push_back(std::move(entities_));
+    }
+  }
+
+  EntityView(EntityView&& other) noexcept
+      : entities_(std::move(other.entities_)), recycle_(other.recycle_) {
+    other.recycle_ = nullptr;
+  }
+  EntityView(const EntityView&) = delete;
+  EntityView& operator=(const EntityView&) = delete;
+  EntityView& operator=(EntityView&&) = delete;
+
+  Iterator begin() const { return Iterator(entities_.begin()); }
+  Iterator end() const { return Iterator(entities_.end()); }
 
   /**
-   * @brief カメラを取得
-   * @return カメラへのポインタ
+   * @brief 一致したエンティティ数を取得
    */
-  Camera2D* getCamera() { return camera_.get(); }
+  size_t size() const { return entities_.size(); }
 
   /**
-   * @brief カメラを取得（const版）
-   * @return カメラへのポインタ
+   * @brief 一致したエンティティがないか
    */
-  const Camera2D* getCamera() const { return camera_.get(); }
+  bool empty() const { return entities_.empty(); }
 
   /**
-   * @brief キャンバスサイズを設定
-   * @param width キャンバス幅
-   * @param height キャンバス高さ
-   *
-   * カメラのビューポートサイズを設定し、カメラ中心をキャンバス中央に配置します。
-   * これにより、ワールド座標(0, 0)が画面左上に、
-   * ワールド座標(width/2, height/2)が画面中央にマッピングされます。
+   * @brief 一致した全エンティティに関数を適用
+   * @param func (Entity&, Ts&...)を受け取る関数
    */
-  void setCanvasSize(float width, float height) {
-    camera_->setViewportSize(width, height);
-    camera_->setCenter(width / 2.0f, height / 2.0f);
+  template <typename Func>
+  void each(Func&& func) const {
+    for (Entity* entity : entities_) {
+      func(*entity, *entity->template getComponent<Ts>()...);
+    }
   }
 
+ private:
+  std::vector<Entity*> entities_;  // 一致したエンティティ（非所有）
+  std::vector<std::vector<Entity*>>* recycle_;  // バッファの返却先（非所有）
+};
+
+/**
+ * @brief シーングラフを深さ順に平坦化した配列
+ *
+ * rootから幅優先で並べたエンティティと、その親の添字を保持します。
+ * 親は常に子より前にあり、配列は親の確定した範囲（レベル）の並びに分かれます。
+ * ワールド変換はレベルごとの線形走査で親→子の順に確定できます。
+ * 同じレベル内のエンティティは互いに独立しているので、レベルを分割して並列に処理できます。
+ *
+ * EntityManager::setFlatHierarchyEnabled(true)で有効にします。
+ * ツリー構造の変更は作り直さずに配列へ反映します。
+ * - 子の追加（生成・付け替え）: 部分木を幅優先で末尾に追加（既存のレベルの後ろに続く新しいレベル）
+ * - 子の削除: 部分木の要素を空き（nullptr）にする
+ * 空きや追加したレベルが増えすぎたら、次に参照されたときに再構築して詰めます。
+ */
+class FlatHierarchy {
+ public:
+  static constexpr Uint32 NO_PARENT = 0xFFFFFFFF;  // rootの親の添字
+
   /**
-   * @brief エンティティをrootの子として追加
-   * @param entity 追加するエンティティ（所有権を移譲）
+   * @brief 並列実行関数の型
+   *
+   * [0, count)を任意に分割し、各範囲についてbody(begin, end)を呼び出してから戻る関数です。
    */
-  void addEntity(EntityPtr entity) { root_->addChild(std::move(entity)); }
+  using ParallelFor = std::function<void(
+      size_t count, const std::function<void(size_t begin, size_t end)>& body)>;
 
   /**
-   * @brief エンティティを指定した親の子として追加
-   * @param parent 親エンティティ
-   * @param entity 追加するエンティティ（所有権を移譲）
+   * @brief 再構築を要求（次回参照時に再構築）
    */
-  void addEntityTo(Entity* parent, EntityPtr entity) {
-    parent->addChild(std::move(entity));
-  }
+  void markDirty() { dirty_ = true; }
 
   /**
-   * @brief アクティブでないエンティティを削除
-   *
-   * ツリーを再帰的に走査し、削除マークされたエンティティをメモリから解放します。
+   * @brief 再構築が必要か
    */
-  void cleanup() { cleanupEntity(root_.get()); }
+  bool isDirty() const { return dirty_; }
 
- private:
   /**
-   * @brief エンティティとその子を再帰的にクリーンアップ
-   * @param entity クリーンアップ対象のエンティティ
+   * @brief ツリーから配列を再構築
+   * @param root 根のエンティティ
    */
-  void cleanupEntity(Entity* entity) {
-    auto& children = const_cast<std::vector<std::unique_ptr<Entity>>&>(
-        entity->getChildren());
+  void rebuild(Entity* root) {
+    entities_.clear();
+    parents_.clear();
+    level_begin_.clear();
+
+    push(root, NO_PARENT);
+
+    // 幅優先で1レベルずつ追加する
+    size_t begin = 0;
+    size_t end = 1;
+    while (begin < end) {
+      level_begin_.push_back(begin);
+      for (size_t i = begin; i < end; ++i) {
+        for (const auto& child : entities_[i]->getChildren()) {
+          push(child.get(), static_cast<Uint32>(i));
+        }
+      }
+      begin = end;
+      end = entities_.size();
+    }
+    level_begin_.push_back(entities_.size());  // 番兵
+    live_count_ = entities_.size();
+    built_level_count_ = getLevelCount();
+    dirty_ = false;
+  }
 
-    // 子エンティティを再帰的にクリーンアップ
-    for (auto& child : children) {
-      cleanupEntity(child.get());
+  /**
+   * @brief 子の追加を反映（Entity::addChild()から呼ばれる）
+   * @param parent 親（配列になければツリーの外なので何もしない）
+   * @param child 追加された子（子孫も含めて末尾に追加する）
+   */
+  void onChildAdded(const Entity* parent, Entity* child) {
+    if (dirty_) return;
+    Uint32 parent_index = find(parent);
+    if (parent_index == NO_PARENT) return;
+
+    // 幅優先で1レベルずつ末尾に追加する
+    size_t begin = entities_.size();
+    push(child, parent_index);
+    Uint32 max_parent = parent_index;
+    while (begin < entities_.size()) {
+      size_t end = entities_.size();
+      // 親がすべて最後のレベルより前にあれば、最後のレベルに含められる
+      if (max_parent >= level_begin_[level_begin_.size() - 2]) {
+        level_begin_.push_back(end);
+      } else {
+        level_begin_.back() = end;
+      }
+      for (size_t i = begin; i < end; ++i) {
+        for (const auto& grandchild : entities_[i]->getChildren()) {
+          push(grandchild.get(), static_cast<Uint32>(i));
+        }
+      }
+      live_count_ += end - begin;
+      max_parent = static_cast<Uint32>(end - 1);
+      begin = end;
     }
 
-    // アクティブでない子を削除
-    children.erase(
-        std::remove_if(
-            children.begin(), children.end(),
-            [](const std::unique_ptr<Entity>& e) { return !e->isActive(); }),
-        children.end());
+    // 追加したレベルが増えすぎたら再構築する
+    if (getLevelCount() > built_level_count_ * 2 + live_count_ / 16 + 16) {
+      dirty_ = true;
+    }
   }
 
- public:
+  /**
+   * @brief 子の削除を反映（Entity::removeChild()から呼ばれる）
+   * @param child 削除された子（子孫も含めて空きにする）
+   */
+  void onChildRemoved(Entity* child) {
+    if (dirty_ || find(child) == NO_PARENT) return;
+    removal_stack_.clear();
+    removal_stack_.push_back(child);
+    while (!removal_stack_.empty()) {
+      Entity* entity = removal_stack_.back();
+      removal_stack_.pop_back();
+      Uint32 index = find(entity);
+      if (index != NO_PARENT) {
+        entities_[index] = nullptr;
+        --live_count_;
+      }
+      for (const auto& grandchild : entity->getChildren()) {
+        removal_stack_.push_back(grandchild.get());
+      }
+    }
+
+    // 空きが半分を超えたら再構築して詰める
+    if (entities_.size() - live_count_ > live_count_) {
+      dirty_ = true;
+    }
+  }
 
   /**
-   * @brief すべてのエンティティを更新
-   * @param delta_time 前フレームからの経過時間（ミリ秒）
+   * @brief エンティティ数（root含む、空きは含まない）を取得
    */
-  void updateAll(Uint64 delta_time) {
-    root_->updateWithChildren(delta_time);
+  size_t size() const { return live_count_; }
+
+  /**
+   * @brief 深さ順（親が子より前）に全エンティティを走査
+   * @param func Entity*を受け取る関数
+   */
+  template <typename Func>
+  void forEach(Func&& func) const {
+    for (Entity* entity : entities_) {
+      if (entity) {
+        func(entity);
+      }
+    }
   }
 
   /**
-   * @brief レイヤー順にすべてのエンティティを描画
-   *
-   * ツリーから全エンティティを集め、レイヤー番号順（背景→前景）に描画します。
-   * カメラを使用してワールド座標から画面座標への変換を行います。
-   *
-   * @param renderer SDLレンダラー
-   * @param visible_flag_index 表示フラグのインデックス（デフォルト: 0）
+   * @brief 親の添字を取得
+   * @param index エンティティの添字
+   * @return 親の添字（rootはNO_PARENT）
    */
-  void renderAll(SDL_Renderer* renderer, size_t visible_flag_index = 0) {
-    // ツリーから全エンティティを集める
-    std::vector<Entity*> all_entities;
-    collectEntities(root_.get(), all_entities);
+  Uint32 getParentIndex(size_t index) const { return parents_[index]; }
 
-    // レイヤー順にソート
-    std::sort(
-        all_entities.begin(), all_entities.end(),
-        [](const Entity* a, const Entity* b) {
-          return a->getLayer() < b->getLayer();
-        });
+  /**
+   * @brief レベルの数を取得
+   */
+  size_t getLevelCount() const { return level_begin_.empty() ? 0 : level_begin_.size() - 1; }
 
-    // レイヤー順に描画
+  /**
+   * @brief レベルに属するエンティティの添字範囲を取得
+   * @param level レベル（rootは0）
+   * @return [begin, end)（空きを含む）
+   */
+  std::pair<size_t, size_t> getLevelRange(size_t level) const {
+    return {level_begin_[level], level_begin_[level + 1]};
+  }
+
+  /**
+   * @brief 並列実行関数を設定
+   * @param parallel_for 並列実行関数（nullptrで逐次実行）
+   * @param min_level_size この数以上のエンティティを持つレベルだけ並列化する
+   */
+  void setParallelFor(ParallelFor parallel_for, size_t min_level_size) {
+    parallel_for_ = std::move(parallel_for);
+    min_parallel_level_size_ = min_level_size;
+  }
+
+  /**
+   * @brief ワールド変換をレベル順に確定
+   *
+   * 各エンティティのキャッシュは親のキャッシュだけを読むため、
+   * 親のレベルが確定していれば同じレベル内は並列に計算できます。
+   */
+  void propagateTransforms() const {
+    for (size_t level = 0; level < getLevelCount(); ++level) {
+      auto [begin, end] = getLevelRange(level);
+      auto body = [this, begin](size_t first, size_t last) {
+        for (size_t i = begin + first; i < begin + last; ++i) {
+          if (entities_[i]) {
+            entities_[i]->getWorldTransform();
+          }
+        }
+      };
+      size_t count = end - begin;
+      if (parallel_for_ && count >= min_parallel_level_size_) {
+        parallel_for_(count, body);
+      } else {
+        body(0, count);
+      }
+    }
+  }
+
+  /**
+   * @brief 祖先も含めてアクティブなエンティティを深さ順に走査
+   * @param func Entity*を受け取る関数
+   */
+  template <typename Func>
+  void forEachActive(Func&& func) const {
+    active_.resize(entities_.size());
+    for (size_t i = 0; i < entities_.size(); ++i) {
+      Entity* entity = entities_[i];
+      Uint32 parent = parents_[i];
+      bool active = entity && entity->isActive() && (parent == NO_PARENT || active_[parent]);
+      active_[i] = active;
+      if (active) {
+        func(entity);
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief 末尾に追加して、エンティティに添字を記録
+   */
+  void push(Entity* entity, Uint32 parent) {
+    entity->hierarchy_index_ = static_cast<Uint32>(entities_.size());
+    entities_.push_back(entity);
+    parents_.push_back(parent);
+  }
+
+  /**
+   * @brief エンティティの添字を取得（配列になければNO_PARENT）
+   */
+  Uint32 find(const Entity* entity) const {
+    Uint32 index = entity->hierarchy_index_;
+    return index < entities_.size() && entities_[index] == entity ? index : NO_PARENT;
+  }
+
+  std::vector<Entity*> entities_;      // 深さ順のエンティティ（非所有、削除された所はnullptr）
+  std::vector<Uint32> parents_;        // 親の添字（entities_と同じ並び）
+  std::vector<size_t> level_begin_;    // 各レベルの開始添字（末尾は番兵）
+  mutable std::vector<Uint8> active_;  // forEachActive()の作業用（祖先を含めたアクティブ状態）
+  std::vector<Entity*> removal_stack_;  // onChildRemoved()の作業用
+  size_t live_count_ = 0;              // 空きでない要素の数
+  size_t built_level_count_ = 0;       // 再構築した時点のレベル数
+  bool dirty_ = true;                  // 再構築が必要か
+
+  ParallelFor parallel_for_;               // 並列実行関数（未設定なら逐次）
+  size_t min_parallel_level_size_ = 1024;  // 並列化するレベルの最小エンティティ数
+};
+
+/**
+ * @brief 読み書きするコンポーネントを宣言した更新システムを実行するスケジューラ
+ *
+ * システムは「対象とするコンポーネントの組」と「書き込むコンポーネント」を宣言して登録します。
+ * 登録順に依存関係を調べ、先に登録されたシステムと読み書きが衝突するシステムは後のステージに回します。
+ * 同じステージのシステムは衝突しないため、スレッドプールが設定されていれば並列に実行されます。
+ * 各システムの対象エンティティも分割して並列に処理されます。
+ *
+ * 衝突するシステム同士は常に登録順に実行されるため、スレッド数によらず結果は同じになります。
+ *
+ * 使用例:
+ * @code
+ * scheduler.addSystem<Locator, VelocityMove>(
+ *     "movement", componentSignature<Locator>(),
+ *     [](Uint64 delta_time, Entity&, Locator& locator, VelocityMove& velocity) {
+ *       velocity.step(locator, delta_time / 1000.0f);
+ *     });
+ * @endcode
+ *
+ * note: システムの関数はワーカースレッドから呼ばれることがあります。
+ *       宣言していないコンポーネントへの書き込みや、エンティティの生成・削除などの構造変更は行わないでください。
+ */
+class SystemScheduler {
+ public:
+  /**
+   * @brief システムを登録
+   * @tparam Ts 対象とするコンポーネントの型（すべて持つエンティティが処理される）
+   * @param name システム名（デバッグ用）
+   * @param writes 書き込むコンポーネントのシグネチャ（Ts以外も指定可）
+   * @param func (Uint64 delta_time, Entity&, Ts&...)を受け取る関数
+   * @param extra_reads Ts以外に読み取るコンポーネントのシグネチャ
+   */
+  template <typename... Ts, typename Func>
+  void addSystem(const char* name, ComponentSignature writes, Func func,
+                 ComponentSignature extra_reads = 0) {
+    System system;
+    system.name = name;
+    system.query = componentSignature<Ts...>();
+    system.reads = system.query | extra_reads;
+    system.writes = writes;
+    system.run = [func](Entity* const* entities, size_t count,
+                        Uint64 delta_time) {
+      for (size_t i = 0; i < count; ++i) {
+        Entity& entity = *entities[i];
+        func(delta_time, entity, *entity.getComponent<Ts>()...);
+      }
+    };
+    systems_.push_back(std::move(system));
+    stages_dirty_ = true;
+  }
+
+  /**
+   * @brief 並列実行に使うスレッドプールを設定
+   * @param pool スレッドプール（nullptrなら登録順に逐次実行）
+   * @param grain_size 1タスクあたりの最小エンティティ数
+   */
+  void setThreadPool(Utilities::ThreadPool* pool, size_t grain_size = 1024) {
+    pool_ = pool;
+    grain_size_ = grain_size;
+  }
+
+  /**
+   * @brief 登録されているシステム数を取得
+   */
+  size_t getSystemCount() const { return systems_.size(); }
+
+  /**
+   * @brief ステージ数（順に実行しなければならない段数）を取得
+   */
+  size_t getStageCount() {
+    buildStagesIfNeeded();
+    return stages_.size();
+  }
+
+  /**
+   * @brief すべてのシステムを実行
+   * @param query (ComponentSignature, std::vector<Entity*>&)で対象エンティティを集める関数
+   * @param delta_time 前フレームからの経過時間（ミリ秒）
+   */
+  template <typename Query>
+  void run(Query&& query, Uint64 delta_time) {
+    buildStagesIfNeeded();
+
+    for (const auto& stage : stages_) {
+      // 対象エンティティの収集はメインスレッドで行う
+      for (size_t index : stage) {
+        System& system = systems_[index];
+        system.entities.clear();
+        query(system.query, system.entities);
+      }
+
+      if (!pool_) {
+        for (size_t index : stage) {
+          System& system = systems_[index];
+          system.run(system.entities.data(), system.entities.size(), delta_time);
+        }
+        continue;
+      }
+
+      // ステージ内の全システムを範囲に分割してまとめて投入し、完了を待つ
+      Utilities::ThreadPool::TaskGroup group;
+      for (size_t index : stage) {
+        System& system = systems_[index];
+        size_t count = system.entities.size();
+        for (size_t begin = 0; begin < count; begin += grain_size_) {
+          size_t end = std::min(begin + grain_size_, count);
+          pool_->run(group, [&system, begin, end, delta_time]() {
+            system.run(system.entities.data() + begin, end - begin, delta_time);
+          });
+        }
+      }
+      pool_->wait(group);
+    }
+  }
+
+ private:
+  struct System {
+    std::string name;               // システム名
+    ComponentSignature query = 0;   // 対象とするコンポーネント
+    ComponentSignature reads = 0;   // 読み取るコンポーネント
+    ComponentSignature writes = 0;  // 書き込むコンポーネント
+    std::function<void(Entity* const*, size_t, Uint64)> run;  // 範囲を処理する関数
+    std::vector<Entity*> entities;  // 今回の対象エンティティ（フレーム間で再利用）
+  };
+
+  static bool conflicts(const System& a, const System& b) {
+    return (a.writes & (b.reads | b.writes)) != 0 || (a.reads & b.writes) != 0;
+  }
+
+  /**
+   * @brief 登録順と読み書きの衝突からステージを決める
+   *
+   * 各システムは、衝突する先行システムのうち最も後のステージの次に置かれます。
+   */
+  void buildStagesIfNeeded() {
+    if (!stages_dirty_) return;
+
+    std::vector<size_t> stage_of(systems_.size(), 0);
+    stages_.clear();
+    for (size_t i = 0; i < systems_.size(); ++i) {
+      size_t stage = 0;
+      for (size_t j = 0; j < i; ++j) {
+        if (conflicts(systems_[i], systems_[j])) {
+          stage = std::max(stage, stage_of[j] + 1);
+        }
+      }
+      stage_of[i] = stage;
+      if (stages_.size() <= stage) {
+        stages_.resize(stage + 1);
+      }
+      stages_[stage].push_back(i);
+    }
+    stages_dirty_ = false;
+  }
+
+  std::vector<System> systems_;              // 登録順のシステム
+  std::vector<std::vector<size_t>> stages_;  // ステージごとのシステム添字
+  bool stages_dirty_ = false;                // ステージの再計算が必要か
+
+  Utilities::ThreadPool* pool_ = nullptr;  // スレッドプール（非所有）
+  size_t grain_size_ = 1024;               // 1タスクあたりの最小エンティティ数
+};
+
+/**
+ * @brief 構造変更（生成・削除・親の変更・コンポーネントの追加/削除）を記録するコマンドバッファ
+ *
+ * 更新処理の途中でツリーやコンポーネント配列を直接変更すると、走査中の配列が変化してしまいます。
+ * このバッファに記録した操作は、EntityManager::updateAll()の最後（またはcleanup()）に
+ * 記録順にまとめて適用されます。EntityManager::commands()で取得します。
+ *
+ * 使用例:
+ * @code
+ * auto& commands = entity_manager.commands();
+ * EntityHandle bullet = commands.spawn(createRectEntity(...));
+ * commands.addComponent<VelocityMove>(bullet, 200.0f, 0.0f);
+ * commands.destroy(enemy);
+ * @endcode
+ */
+class EntityCommandBuffer {
+ public:
+  explicit EntityCommandBuffer(EntityManager& manager) : manager_(manager) {}
+
+  EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+  EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+  /**
+   * @brief エンティティの生成を記録
+   * @param entity 追加するエンティティ（所有権を移譲）
+   * @param parent 親のハンドル（無効なハンドルならrootの子）
+   * @return 生成されるエンティティのハンドル（記録した時点で有効）
+   *
+   * ツリーへの追加は適用時に行われます。適用時に親が削除済みの場合は破棄されます。
+   */
+  EntityHandle spawn(std::unique_ptr<Entity> entity, EntityHandle parent = {});
+
+  /**
+   * @brief エンティティの削除
+   * @param target 削除するエンティティのハンドル
+   *
+   * 即座に削除マーク（非アクティブ化）され、メモリの解放は適用時に行われます。
+   */
+  void destroy(EntityHandle target);
+
+  /**
+   * @brief 親の変更を記録
+   * @param target 対象エンティティのハンドル
+   * @param new_parent 新しい親のハンドル（無効なハンドルならrootの子）
+   */
+  void reparent(EntityHandle target, EntityHandle new_parent) {
+    Command command;
+    command.type = CommandType::Reparent;
+    command.target = target;
+    command.parent = new_parent;
+    commands_.push_back(std::move(command));
+  }
+
+  /**
+   * @brief コンポーネントの追加を記録
+   * @tparam T コンポーネントの型
+   * @param target 対象エンティティのハンドル
+   * @param args コンストラクタ引数
+   *
+   * コンポーネントは記録時にComponentPool<T>上に構築されます。
+   */
+  template <typename T, typename... Args>
+  void addComponent(EntityHandle target, Args&&... args) {
+    Command command;
+    command.type = CommandType::AddComponent;
+    command.target = target;
+    command.component_id = componentTypeId<T>();
+    command.component = ComponentPool<T>::shared().make(std::forward<Args>(args)...);
+    commands_.push_back(std::move(command));
+  }
+
+  /**
+   * @brief コンポーネントの削除を記録
+   * @tparam T コンポーネントの型
+   * @param target 対象エンティティのハンドル
+   */
+  template <typename T>
+  void removeComponent(EntityHandle target) {
+    Command command;
+    command.type = CommandType::RemoveComponent;
+    command.target = target;
+    command.component_id = componentTypeId<T>();
+    commands_.push_back(std::move(command));
+  }
+
+  /**
+   * @brief 未適用のコマンド数を取得
+   */
+  size_t size() const { return commands_.size(); }
+
+  /**
+   * @brief 未適用のコマンドがないか
+   */
+  bool empty() const { return commands_.empty(); }
+
+  /**
+   * @brief 未適用のコマンドを破棄
+   */
+  void clear() { commands_.clear(); }
+
+ private:
+  friend class EntityManager;
+
+  enum class CommandType : Uint8 {
+    Spawn,
+    Reparent,
+    AddComponent,
+    RemoveComponent,
+  };
+
+  struct Command {
+    CommandType type = CommandType::Spawn;
+    EntityHandle target;               // 対象エンティティ
+    EntityHandle parent;               // 親（Spawn/Reparent）
+    ComponentTypeId component_id = 0;  // コンポーネント型ID（AddComponent/RemoveComponent）
+    std::unique_ptr<Entity> entity;    // 生成するエンティティ（Spawn）
+    ComponentPtr component;            // 追加するコンポーネント（AddComponent）
+  };
+
+  EntityManager& manager_;
+  std::vector<Command> commands_;  // 記録順のコマンド
+};
+
+/**
+ * @brief エンティティを管理するコンテナクラス
+ *
+ * ツリー構造（シーングラフ）でエンティティを管理します。
+ * 常にrootエンティティを持ち、全てのエンティティはrootの子孫として配置されます。
+ * Camera2Dを持ち、描画時の視点変換を行います。
+ */
+class EntityManager {
+ public:
+  using EntityPtr = std::unique_ptr<Entity>;
+  using EntityList = std::vector<EntityPtr>;
+
+  EntityManager()
+      : commands_(*this),
+        root_(std::make_unique<RootEntity>()),
+        camera_(std::make_unique<Camera2D>()) {
+    attachEntity(root_.get());
+    registerBuiltinSystems();
+  }
+  ~EntityManager() = default;
+
+  // エンティティが登録先としてポインタを保持するため、コピー・ムーブ不可
+  EntityManager(const EntityManager&) = delete;
+  EntityManager& operator=(const EntityManager&) = delete;
+
+  /**
+   * @brief rootエンティティを取得
+   * @return rootエンティティへのポインタ
+   */
+  Entity* getRoot() { return root_.get(); }
+
+  /**
+   * @brief カメラを取得
+   * @return カメラへのポインタ
+   */
+  Camera2D* getCamera() { return camera_.get(); }
+
+  /**
+   * @brief カメラを取得（const版）
+   * @return カメラへのポインタ
+   */
+  const Camera2D* getCamera() const { return camera_.get(); }
+
+  /**
+   * @brief キャンバスサイズを設定
+   * @param width キャンバス幅
+   * @param height キャンバス高さ
+   *
+   * カメラのビューポートサイズを設定し、カメラ中心をキャンバス中央に配置します。
+   * これにより、ワールド座標(0, 0)が画面左上に、
+   * ワールド座標(width/2, height/2)が画面中央にマッピングされます。
+   */
+  void setCanvasSize(float width, float height) {
+    camera_->setViewportSize(width, height);
+    camera_->setCenter(width / 2.0f, height / 2.0f);
+  }
+
+  /**
+   * @brief エンティティをrootの子として追加
+   * @param entity 追加するエンティティ（所有権を移譲）
+   * @return 追加したエンティティのハンドル
+   */
+  EntityHandle addEntity(EntityPtr entity) {
+    Entity* raw = entity.get();
+    root_->addChild(std::move(entity));
+    return raw->getHandle();
+  }
+
+  /**
+   * @brief エンティティを指定した親の子として追加
+   * @param parent 親エンティティ
+   * @param entity 追加するエンティティ（所有権を移譲）
+   * @return 追加したエンティティのハンドル（親が未登録の場合は無効なハンドル）
+   */
+  EntityHandle addEntityTo(Entity* parent, EntityPtr entity) {
+    Entity* raw = entity.get();
+    parent->addChild(std::move(entity));
+    return raw->getHandle();
+  }
+
+  /**
+   * @brief エンティティの登録情報の容量を事前確保
+   * @param additional 追加予定のエンティティ数
+   *
+   * 大量に追加する前に呼ぶと、スロットや更新対象リストの再確保を避けられます。
+   */
+  void reserveEntities(size_t additional) {
+    size_t reusable = std::min(additional, free_slot_indices_.size());
+    entity_slots_.reserve(entity_slots_.size() + additional - reusable);
+    awake_entities_.reserve(awake_entities_.size() + additional);
+  }
+
+  /**
+   * @brief ハンドルからエンティティを取得（O(1)）
+   * @param handle エンティティのハンドル
+   * @return エンティティへのポインタ（削除済み・無効なハンドルの場合はnullptr）
+   *
+   * 削除マークされただけのエンティティ（cleanup()前）は取得できます。
+   * 必要に応じてisActive()で確認してください。
+   */
+  Entity* resolve(EntityHandle handle) const {
+    if (handle.index >= entity_slots_.size()) {
+      return nullptr;
+    }
+    const EntitySlot& slot = entity_slots_[handle.index];
+    return slot.generation == handle.generation ? slot.entity : nullptr;
+  }
+
+  /**
+   * @brief ハンドルの指すエンティティが存在するか
+   * @param handle エンティティのハンドル
+   * @return 存在する場合true
+   */
+  bool isAlive(EntityHandle handle) const { return resolve(handle) != nullptr; }
+
+  /**
+   * @brief エンティティに名前を付ける
+   * @param entity 対象エンティティ（このEntityManagerに登録済みであること）
+   * @param name 名前（空文字列で名前を解除）
+   *
+   * 名前は一意です。既に同じ名前のエンティティがある場合、そちらの名前は解除されます。
+   * エンティティが削除されると名前も自動的に解除されます。
+   */
+  void setName(Entity* entity, const std::string& name) {
+    if (!entity || entity->manager_ != this) {
+      SDL_Log("setName: entity is not registered to this EntityManager");
+      return;
+    }
+    EntitySlot& slot = entity_slots_[entity->handle_.index];
+    if (!slot.name.empty()) {
+      names_.erase(slot.name);
+      slot.name.clear();
+    }
+    if (name.empty()) {
+      return;
+    }
+
+    auto it = names_.find(name);
+    if (it != names_.end()) {
+      entity_slots_[it->second.index].name.clear();
+      it->second = entity->handle_;
+    } else {
+      names_.emplace(name, entity->handle_);
+    }
+    slot.name = name;
+  }
+
+  /**
+   * @brief 名前からエンティティを取得
+   * @param name 名前
+   * @return エンティティへのポインタ（見つからない場合はnullptr）
+   */
+  Entity* findByName(const std::string& name) const {
+    auto it = names_.find(name);
+    return it != names_.end() ? resolve(it->second) : nullptr;
+  }
+
+  /**
+   * @brief 平坦化した階層配列を使うかどうかを設定
+   * @param enabled trueで有効
+   *
+   * 有効にすると、updateAll()の最後にワールド変換をレベル順にまとめて確定し、
+   * ビューの収集・描画リストの作成・エンティティ数の取得で再帰的なツリー走査を行わなくなります。
+   * 大量のエンティティや深い階層を扱う場合に有効です。
+   */
+  void setFlatHierarchyEnabled(bool enabled) {
+    flat_hierarchy_enabled_ = enabled;
+    hierarchy_.markDirty();
+  }
+
+  /**
+   * @brief 平坦化した階層配列を使うかどうか
+   */
+  bool isFlatHierarchyEnabled() const { return flat_hierarchy_enabled_; }
+
+  /**
+   * @brief 平坦化した階層配列を取得（必要なら再構築）
+   * @return 深さ順の階層配列
+   */
+  const FlatHierarchy& getFlatHierarchy() {
+    if (hierarchy_.isDirty()) {
+      hierarchy_.rebuild(root_.get());
+    }
+    return hierarchy_;
+  }
+
+  /**
+   * @brief ワールド変換の伝播に使う並列実行関数を設定
+   * @param parallel_for 並列実行関数（nullptrで逐次実行）
+   * @param min_level_size この数以上のエンティティを持つレベルだけ並列化する
+   */
+  void setParallelFor(FlatHierarchy::ParallelFor parallel_for,
+                      size_t min_level_size = 1024) {
+    hierarchy_.setParallelFor(std::move(parallel_for), min_level_size);
+  }
+
+  /**
+   * @brief すべてのワールド変換をレベル順に確定
+   *
+   * 平坦化した階層配列が有効な場合、updateAll()の最後に自動的に呼ばれます。
+   */
+  void propagateTransforms() { getFlatHierarchy().propagateTransforms(); }
+
+  /**
+   * @brief 描画補間を使うかどうかを設定
+   * @param enabled trueで有効
+   *
+   * 固定ステップで更新し、それより高い頻度で描画する場合に使います。
+   * 有効にすると、updateAll()の開始時に各エンティティのワールド変換を記録し、
+   * 描画時（Entity::getRenderTransform()）に直前のステップとの間をsetInterpolationAlpha()の割合で補間します。
+   */
+  void setInterpolationEnabled(bool enabled) { interpolation_enabled_ = enabled; }
+
+  /**
+   * @brief 描画補間を使うかどうか
+   */
+  bool isInterpolationEnabled() const { return interpolation_enabled_; }
+
+  /**
+   * @brief 描画補間の割合を設定（描画の前に呼ぶ）
+   * @param alpha 直前のステップから最新のステップまでの割合（0.0～1.0）
+   */
+  void setInterpolationAlpha(float alpha) {
+    interpolation_alpha_ = std::clamp(alpha, 0.0f, 1.0f);
+  }
+
+  /**
+   * @brief 描画補間の割合を取得
+   */
+  float getInterpolationAlpha() const { return interpolation_alpha_; }
+
+  /**
+   * @brief すべてのエンティティの描画補間をリセット（補間の始点を現在のワールド変換にする）
+   *
+   * RollbackBuffer::restore()など、updateAll()を通さずに状態を書き換えた後に呼びます
+   * （次のステップまでは書き換えた位置で描画され、古い位置から滑って見えない）。
+   */
+  void resetInterpolation() {
+    if (interpolation_enabled_) {
+      recordPreviousTransforms();
+    }
+  }
+
+  /**
+   * @brief コマンドバッファを取得
+   * @return 構造変更を記録するコマンドバッファ
+   */
+  EntityCommandBuffer& commands() { return commands_; }
+
+  /**
+   * @brief 記録されたコマンドを適用し、削除されたエンティティを解放
+   *
+   * updateAll()の最後に自動的に呼ばれます。
+   * 解放処理は削除リストに載ったエンティティのみを対象とするため、削除数に比例した時間で済みます。
+   */
+  void flushCommands() {
+    // 記録順に適用（適用中に記録されたコマンドも同じフラッシュで処理する）
+    for (size_t i = 0; i < commands_.commands_.size(); ++i) {
+      EntityCommandBuffer::Command command = std::move(commands_.commands_[i]);
+      applyCommand(command);
+    }
+    commands_.commands_.clear();
+
+    reclaimDestroyedEntities();
+  }
+
+  /**
+   * @brief アクティブでないエンティティを削除
+   *
+   * flushCommands()と同じです（後方互換性）。
+   */
+  void cleanup() { flushCommands(); }
+
+ private:
+  /**
+   * @brief コマンドを1つ適用
+   * @param command 適用するコマンド
+   */
+  void applyCommand(EntityCommandBuffer::Command& command) {
+    using CommandType = EntityCommandBuffer::CommandType;
+
+    switch (command.type) {
+      case CommandType::Spawn: {
+        Entity* parent = resolveParent(command.parent);
+        if (!parent) {
+          SDL_Log("EntityCommandBuffer: parent of spawned entity no longer exists");
+          return;
+        }
+        parent->addChild(std::move(command.entity));
+        break;
+      }
+      case CommandType::Reparent: {
+        Entity* target = resolve(command.target);
+        Entity* new_parent = resolveParent(command.parent);
+        if (!target || !new_parent || target == root_.get()) {
+          return;
+        }
+        // 自分の子孫を親にすると循環するため無視する
+        for (Entity* e = new_parent; e; e = e->getParent()) {
+          if (e == target) {
+            SDL_Log("EntityCommandBuffer: reparent would create a cycle");
+            return;
+          }
+        }
+        // 親のないエンティティ（ツリーに追加されていない、または切り離された）は所有者がいない
+        Entity* old_parent = target->getParent();
+        if (!old_parent) {
+          SDL_Log("EntityCommandBuffer: reparent target is not in the tree (not spawned yet or detached)");
+          return;
+        }
+        new_parent->addChild(old_parent->removeChild(target));
+        break;
+      }
+      case CommandType::AddComponent:
+        if (Entity* target = resolve(command.target)) {
+          target->addComponentById(command.component_id,
+                                   std::move(command.component));
+        }
+        break;
+      case CommandType::RemoveComponent:
+        if (Entity* target = resolve(command.target)) {
+          target->removeComponentById(command.component_id);
+        }
+        break;
+    }
+  }
+
+  /**
+   * @brief 親に指定されたハンドルを解決（無効なハンドルならroot）
+   */
+  Entity* resolveParent(EntityHandle parent) const {
+    return parent.isValid() ? resolve(parent) : root_.get();
+  }
+
+  /**
+   * @brief 削除リストのエンティティを親から切り離して解放
+   */
+  void reclaimDestroyedEntities() {
+    // note: 解放中のデストラクタから削除が追加されても安全なように添字でアクセス
+    for (size_t i = 0; i < destroyed_entities_.size(); ++i) {
+      Entity* entity = resolve(destroyed_entities_[i]);
+      if (!entity || entity == root_.get()) {
+        continue;
+      }
+      // 親から外したunique_ptrが破棄され、子孫もまとめて解放される
+      if (Entity* parent = entity->getParent()) {
+        parent->removeChild(entity);
+      }
+    }
+    destroyed_entities_.clear();
+  }
+
+ public:
+
+  /**
+   * @brief すべてのエンティティを更新
+   * @param delta_time 前フレームからの経過時間（ミリ秒）
+   */
+  void updateAll(Uint64 delta_time) {
+    using Utilities::FrameProfiler;
+
+    // 新しいフレームのティックに進め、古い変更記録を捨てる
+    beginChangeFrame();
+
+    // 描画補間のため、このステップで変わる前のワールド変換を記録
+    if (interpolation_enabled_) {
+      FrameProfiler::Scope scope("entities.interpolation");
+      recordPreviousTransforms();
+    }
+
+    // 起きているエンティティのみ、仮想update()を呼ぶ
+    // （システムで処理する組み込みコンポーネントは除く）
+    {
+      FrameProfiler::Scope scope("entities.update");
+      collectUpdateSet();
+      ComponentSignature skip_components = systemComponents();
+      for (size_t i = 0; i < update_set_.size(); ++i) {
+        update_set_[i]->updateSelf(delta_time, skip_components);
+      }
+    }
+
+    // 起床時刻になったコルーチンの振る舞いを再開（待っているものは呼ばれない）
+    {
+      FrameProfiler::Scope scope("entities.behaviors");
+      behaviors_.advance(delta_time, [this](EntityHandle owner) {
+        Entity* entity = resolve(owner);
+        return entity && entity->isActive();
+      });
+    }
+
+    // トゥイーンの値をまとめて計算してコンポーネントへ反映
+    {
+      FrameProfiler::Scope scope("entities.tweens");
+      tweens_.advance(delta_time, [this](EntityHandle owner, TweenProperty property,
+                                         const TweenValue& value) {
+        return applyTween(owner, property, value);
+      });
+    }
+
+    // 組み込みコンポーネントと登録されたシステムをまとめて処理
+    // note: update()の中で起こされたエンティティも対象にするため集め直す
+    {
+      FrameProfiler::Scope scope("entities.systems");
+      collectUpdateSet();
+      scheduler_.run(
+          [this](ComponentSignature signature, std::vector<Entity*>& out) {
+            for (Entity* entity : update_set_) {
+              if (entity->hasComponents(signature)) {
+                out.push_back(entity);
+              }
+            }
+          },
+          delta_time);
+      // ワーカースレッドで記録された変更を型ごとのリストへ移す
+      mergeWorkerChanges();
+    }
+
+    // 更新中に記録された構造変更をまとめて適用
+    {
+      FrameProfiler::Scope scope("entities.commands");
+      flushCommands();
+    }
+
+    // 更新が不要になったエンティティをスリープさせる
+    {
+      FrameProfiler::Scope scope("entities.sleep");
+      updateSleepStates();
+    }
+
+    // 描画前にワールド変換を確定
+    if (flat_hierarchy_enabled_) {
+      FrameProfiler::Scope scope("entities.propagate");
+      propagateTransforms();
+    }
+
+    if (FrameProfiler* profiler = FrameProfiler::getActive()) {
+      // rootを含む登録数（ツリーを辿らずにスロットの使用数から求める）
+      profiler->setCounter("entities.registered",
+                           static_cast<double>(entity_slots_.size() - free_slot_indices_.size()));
+      profiler->setCounter("entities.awake", static_cast<double>(awake_entities_.size()));
+      profiler->setCounter("entities.updated", static_cast<double>(update_set_.size()));
+    }
+  }
+
+  /**
+   * @brief 指定したコンポーネントをすべて持つエンティティのビューを取得
+   * @tparam Ts 必要なコンポーネントの型
+   * @return 一致したエンティティのビュー
+   *
+   * 非アクティブなエンティティとその子孫は含まれません（updateAll()と同じ範囲）。
+   * ビューはEntityManagerより長く保持しないでください（バッファを返却するため）。
+   */
+  template <typename... Ts>
+  EntityView<Ts...> view() {
+    // 以前のビューが使ったバッファを再利用する（毎フレームのヒープ確保を避ける）
+    std::vector<Entity*> matched;
+    if (!view_buffers_.empty()) {
+      matched = std::move(view_buffers_.back());
+      view_buffers_.pop_back();
+    }
+    queryEntities(componentSignature<Ts...>(), matched);
+    return EntityView<Ts...>(std::move(matched), &view_buffers_);
+  }
+
+  /**
+   * @brief 起きている（更新対象の）エンティティ数を取得
+   * @return 起きているエンティティ数（削除マーク済みで未解放のものを含む）
+   */
+  size_t getAwakeEntityCount() const { return awake_entities_.size(); }
+
+  /**
+   * @brief 状態フラグのメンバーリストの管理を開始
+   * @param index フラグのインデックス（0～Entity::MAX_STATE_FLAGS-1）
+   *
+   * 以降、そのフラグが立っているエンティティの一覧がsetStateFlag()のたびに更新され、
+   * getEntitiesWithStateFlag()で取得できるようになります。
+   * renderAll()は表示フラグが管理されていれば、そのリストだけを描画対象にします。
+   */
+  void trackStateFlag(size_t index) {
+    Entity::StateFlagBits bit = Entity::StateFlagBits{1} << index;
+    if (tracked_state_flags_ & bit) return;
+    tracked_state_flags_ |= bit;
+
+    // 登録済みのエンティティのうち、フラグが立っているものを載せる
+    for (const EntitySlot& slot : entity_slots_) {
+      if (slot.entity && slot.entity->in_tree_ && slot.entity->getStateFlag(index)) {
+        addStateFlagMember(slot.entity, index);
+      }
+    }
+  }
+
+  /**
+   * @brief 状態フラグのメンバーリストを管理しているかどうか
+   * @param index フラグのインデックス
+   */
+  bool isStateFlagTracked(size_t index) const {
+    return (tracked_state_flags_ >> index) & 1;
+  }
+
+  /**
+   * @brief 状態フラグが立っているエンティティの一覧を取得
+   * @param index trackStateFlag()で管理を開始したフラグのインデックス
+   * @return エンティティのリスト（非所有、順不同。rootにつながっているもののみ）
+   *
+   * 管理していないフラグの場合は空のリストを返します。
+   */
+  const std::vector<Entity*>& getEntitiesWithStateFlag(size_t index) const {
+    return state_flag_members_[index];
+  }
+
+  /**
+   * @brief 現在の変更ティックを取得
+   * @return 変更ティック（フレームごと、およびforEachChanged()の呼び出しごとに進む）
+   *
+   * note: 同じティック内の変更を取りこぼすため、forEachChanged()のsince_tickには
+   * この値ではなく、前回のforEachChanged()の戻り値を渡してください
+   */
+  Uint64 getChangeTick() const {
+    return change_tick_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 型ごとの変更リストを保持するフレーム数を設定
+   * @param frames 保持するフレーム数（最低1）
+   *
+   * これより古いティックからのforEachChanged()は、変更リストを使わずに
+   * その型を持つ全エンティティを走査して答えます（結果は同じで、遅いだけです）。
+   */
+  void setChangeHistoryFrames(size_t frames) {
+    frame_start_ticks_.assign(std::max<size_t>(frames, 1), change_log_floor_);
+    frame_cursor_ = 0;
+  }
+
+  /**
+   * @brief 指定ティックより後に変更されたコンポーネントを列挙
+   * @tparam T コンポーネントの型
+   * @param since_tick 前回の呼び出しで返されたティック（初回は0で全件）
+   * @param func (Entity&, T&)を受け取る関数
+   * @return 次回の呼び出しに渡すティック
+   *
+   * 変更リストから、since_tickより後にセッターで変更された（または追加された）
+   * コンポーネントだけを列挙します（同じコンポーネントは1回だけ）。
+   * 呼び出すとティックが進むため、返されたティック以降の変更は次回の呼び出しで必ず検出されます。
+   * 削除されたエンティティ・コンポーネントは列挙されません。
+   * 型ごとの変更リストは、その型で初めて呼ばれたときに記録を始めます
+   * （それまでは記録の手間をかけず、初回は全件を調べて答えます）。
+   *
+   * note: 同じ型を書き込むシステムと並行して呼ばないでください
+   *
+   * 使用例:
+   * @code
+   * // 前回から位置が変わったエンティティだけ空間インデックスを更新
+   * last_tick_ = entity_manager.forEachChanged<Locator>(
+   *     last_tick_, [&](Entity& entity, Locator& locator) { index.move(entity, locator); });
+   * @endcode
+   */
+  template <typename T, typename Func>
+  Uint64 forEachChanged(Uint64 since_tick, Func&& func) {
+    mergeWorkerChanges();
+    ComponentTypeId id = componentTypeId<T>();
+    bool tracked = (tracked_change_types_ >> id) & 1;
+    if (!tracked) {
+      // 初めて調べられた型は、ここから変更リストに記録する
+      tracked_change_types_ |= ComponentSignature{1} << id;
+      change_tracking_start_[id] = getChangeTick();
+    }
+    if (!tracked || since_tick < change_tracking_start_[id] ||
+        since_tick + 1 < change_log_floor_) {
+      // 必要な記録が（切り詰められて、または記録を始める前で）ないので全件を調べる
+      view<T>().each([&](Entity& entity, T& component) {
+        if (component.getChangedTick() > since_tick) {
+          func(entity, component);
+        }
+      });
+    } else {
+      const std::vector<ChangeRecord>& log = change_logs_[id];
+      auto first = std::upper_bound(
+          log.begin(), log.end(), since_tick,
+          [](Uint64 tick, const ChangeRecord& record) { return tick < record.tick; });
+      // note: funcの中での変更で記録が追加されても安全なように添字でアクセス
+      size_t end = log.size();
+      for (size_t i = first - log.begin(); i < end; ++i) {
+        ChangeRecord record = log[i];
+        Entity* entity = resolve(record.entity);
+        if (!entity || !entity->isActive()) continue;
+        T* component = entity->getComponent<T>();
+        // 後のティックでも変更されていれば、そちらの記録で列挙する
+        if (component && component->getChangedTick() == record.tick) {
+          func(*entity, *component);
+        }
+      }
+    }
+    return change_tick_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 指定ティックより後にコンポーネントを失ったエンティティを列挙
+   * @tparam T コンポーネントの型
+   * @param tick 前回の呼び出しで更新されたティック（初回は0）。次回に渡すティックに更新される
+   * @param func (EntityHandle)を受け取る関数
+   * @return 列挙が完全ならtrue。記録が切り詰められていた場合はfalse（呼び出し側で全件を確認する）
+   *
+   * コンポーネントの削除、エンティティの削除マーク（destroy()）と解放を記録から列挙します。
+   * ハンドルは解放済みのことがあり、同じエンティティが複数回列挙されることもあります。
+   * 削除の記録は、その型で初めて呼ばれたときに始めます（初回は何も列挙しません）。
+   *
+   * note: 記録はメインスレッドでの削除だけが対象です（削除はコマンドバッファ経由で行うこと）
+   */
+  template <typename T, typename Func>
+  bool forEachRemoved(Uint64& tick, Func&& func) {
+    ComponentTypeId id = componentTypeId<T>();
+    Uint64 since_tick = tick;
+    tick = change_tick_.fetch_add(1, std::memory_order_relaxed);
+    if (!((tracked_removal_types_ >> id) & 1)) {
+      tracked_removal_types_ |= ComponentSignature{1} << id;
+      removal_tracking_start_[id] = tick;
+      return since_tick == 0;
+    }
+    if (since_tick == 0) return true;
+    if (since_tick < removal_tracking_start_[id] || since_tick + 1 < change_log_floor_) {
+      return false;
+    }
+    const std::vector<ChangeRecord>& log = removal_logs_[id];
+    auto first = std::upper_bound(
+        log.begin(), log.end(), since_tick,
+        [](Uint64 since, const ChangeRecord& record) { return since < record.tick; });
+    size_t end = log.size();
+    for (size_t i = first - log.begin(); i < end; ++i) {
+      func(log[i].entity);
+    }
+    return true;
+  }
+
+  /**
+   * @brief コンポーネントの変更を記録（Component::markChanged()から呼ばれる、内部用）
+   * @param component 変更されたコンポーネント（所属Entityが登録済みであること）
+   *
+   * 同じティック内の2回目以降の変更は記録しません。
+   * forEachChanged()で一度も調べられていない型は、変更ティックだけを更新して記録しません。
+   * システムの関数（ワーカースレッド）からの記録はワーカーごとのバッファに貯め、
+   * メインスレッドでmergeWorkerChanges()が型ごとのリストへ移すため、ロックは取りません。
+   *
+   * note: メインスレッドとsetThreadPool()のプールのワーカー以外から呼ばないでください
+   */
+  void recordChange(Component& component) {
+    Uint64 tick = change_tick_.load(std::memory_order_relaxed);
+    if (component.getChangedTick() == tick) return;
+    component.setChangedTick(tick);
+    ComponentTypeId id = component.getTypeId();
+    if (!((tracked_change_types_ >> id) & 1)) return;
+    ChangeRecord record{tick, component.getOwner()->getHandle()};
+    size_t worker = thread_pool_ ? thread_pool_->getCurrentWorkerIndex() : 0;
+    if (worker == 0) {
+      change_logs_[id].push_back(record);
+    } else {
+      worker_changes_[worker].push_back(PendingChange{id, record});
+    }
+  }
+
+  /**
+   * @brief コンポーネントの削除を記録（Entity::removeComponentById()から呼ばれる、内部用）
+   * @param entity コンポーネントを失ったエンティティ
+   * @param id 削除されたコンポーネントの型ID
+   *
+   * forEachRemoved()で一度も調べられていない型は記録しません。
+   */
+  void recordRemoval(EntityHandle entity, ComponentTypeId id) {
+    if (!((tracked_removal_types_ >> id) & 1)) return;
+    removal_logs_[id].push_back(ChangeRecord{change_tick_.load(std::memory_order_relaxed), entity});
+  }
+
+  /**
+   * @brief エンティティのすべてのコンポーネントの削除を記録（削除マークと解放時、内部用）
+   */
+  void recordRemovals(const Entity& entity) {
+    ComponentSignature types = entity.getSignature() & tracked_removal_types_;
+    while (types) {
+      ComponentTypeId id = static_cast<ComponentTypeId>(std::countr_zero(types));
+      types &= types - 1;
+      recordRemoval(entity.getHandle(), id);
+    }
+  }
+
+  /**
+   * @brief シグネチャに一致するアクティブなエンティティを収集
+   * @param signature 必要なコンポーネントのシグネチャ
+   * @param out_entities 収集先のベクタ（末尾に追加される）
+   *
+   * 非アクティブなエンティティとその子孫は含まれません。
+   */
+  void queryEntities(ComponentSignature signature,
+                     std::vector<Entity*>& out_entities) {
+    if (flat_hierarchy_enabled_) {
+      getFlatHierarchy().forEachActive([signature, &out_entities](Entity* entity) {
+        if (entity->hasComponents(signature)) {
+          out_entities.push_back(entity);
+        }
+      });
+    } else {
+      collectMatching(root_.get(), signature, out_entities);
+    }
+  }
+
+  /**
+   * @brief システムスケジューラを取得
+   * @return 更新システムのスケジューラ（ゲーム側のシステムもここに登録する）
+   *
+   * 組み込みシステム（移動・回転・アニメーション）は生成時に登録済みです。
+   * 後から登録したシステムは、読み書きが衝突する組み込みシステムの後に実行されます。
+   */
+  SystemScheduler& getScheduler() { return scheduler_; }
+
+  /**
+   * @brief エンティティのコルーチンの振る舞いを開始
+   * @param owner 対象のエンティティ（登録済みであること）
+   * @param behavior 開始するコルーチン（最初の実行は次のupdateAll()）
+   * @return 開始できたか（未登録のエンティティならfalse）
+   *
+   * 対象のエンティティが削除されると、振る舞いは再開されずに破棄されます。
+   */
+  bool startBehavior(Entity& owner, Behavior behavior) {
+    EntityHandle handle = owner.getHandle();
+    if (!handle.isValid()) {
+      SDL_Log("EntityManager: startBehavior() requires a registered entity");
+      return false;
+    }
+    behaviors_.start(handle, std::move(behavior));
+    return true;
+  }
+
+  /**
+   * @brief 実行中（待機中を含む）の振る舞いの数を取得
+   */
+  size_t getBehaviorCount() const { return behaviors_.getCount(); }
+
+  /**
+   * @brief トゥイーンを取得
+   * @return コンポーネントのプロパティを補間するトゥイーン（updateAll()で進む）
+   */
+  TweenSystem& getTweens() { return tweens_; }
+
+  /**
+   * @brief 並列実行に使うスレッドプールを設定
+   * @param pool スレッドプール（nullptrなら逐次実行、EntityManagerより長く生存すること）
+   *
+   * システムスケジューラと、平坦化した階層配列のワールド変換の伝播で使用されます。
+   */
+  void setThreadPool(Utilities::ThreadPool* pool) {
+    mergeWorkerChanges();
+    thread_pool_ = pool;
+    worker_changes_.resize(pool ? pool->getThreadCount() + 1 : 0);
+    scheduler_.setThreadPool(pool);
+    if (pool) {
+      setParallelFor(
+          [pool](size_t count,
+                 const std::function<void(size_t, size_t)>& body) {
+            pool->parallelFor(count, 256, body);
+          });
+    } else {
+      setParallelFor(nullptr);
+    }
+  }
+
+  /**
+   * @brief システムで一括処理される組み込みコンポーネントのシグネチャ
+   *
+   * これらの型のupdate()はEntity::updateWithChildren()からは呼ばれません。
+   */
+  static ComponentSignature systemComponents() {
+    return componentSignature<VelocityMove, AngularVelocity,
+                              DirectionalSpriteAnimator, SpriteAnimator>();
+  }
+
+ private:
+  /**
+   * @brief 変更の記録（ティックと、変更されたコンポーネントの所属Entity）
+   */
+  struct ChangeRecord {
+    Uint64 tick;
+    EntityHandle entity;
+  };
+
+  /**
+   * @brief ワーカースレッドで記録され、型ごとのリストへの移動を待っている変更
+   */
+  struct PendingChange {
+    ComponentTypeId type;
+    ChangeRecord record;
+  };
+
+  /**
+   * @brief ワーカーごとのバッファの変更を型ごとのリストへ移す（メインスレッドから呼ぶ）
+   *
+   * ティックはシステムの実行中に進まないため、追加するだけでリストはティック順のままです。
+   */
+  void mergeWorkerChanges() {
+    for (auto& buffer : worker_changes_) {
+      for (const PendingChange& change : buffer) {
+        change_logs_[change.type].push_back(change.record);
+      }
+      buffer.clear();
+    }
+  }
+
+  /**
+   * @brief 新しいフレームのティックに進め、保持期間を過ぎた変更記録を捨てる
+   */
+  void beginChangeFrame() {
+    mergeWorkerChanges();
+    Uint64 tick = change_tick_.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    // frame_start_ticks_はリングバッファ（最も古いフレームの開始ティックを新しいもので置き換える）
+    change_log_floor_ = frame_start_ticks_[frame_cursor_];
+    frame_start_ticks_[frame_cursor_] = tick;
+    frame_cursor_ = (frame_cursor_ + 1) % frame_start_ticks_.size();
+
+    // 記録はティック順に並んでいるので、先頭から切り詰める
+    auto trim = [this](std::vector<ChangeRecord>& log) {
+      auto last = std::lower_bound(
+          log.begin(), log.end(), change_log_floor_,
+          [](const ChangeRecord& record, Uint64 tick) { return record.tick < tick; });
+      log.erase(log.begin(), last);
+    };
+    for (auto& log : change_logs_) {
+      trim(log);
+    }
+    for (auto& log : removal_logs_) {
+      trim(log);
+    }
+  }
+
+  /**
+   * @brief rootにつながっているかの状態を更新し、状態フラグのメンバーリストに反映
+   * @param entity 対象のエンティティ（子孫は含まない）
+   * @param in_tree rootにつながっているか
+   */
+  void setInTree(Entity* entity, bool in_tree) {
+    if (entity->in_tree_ == in_tree) return;
+    entity->in_tree_ = in_tree;
+    updateStateFlagMembership(entity, in_tree);
+  }
+
+  /**
+   * @brief ツリーから切り離されたサブツリーを、メンバーリストから外す（Entity::removeChild()から呼ばれる）
+   * @param entity 切り離されたサブツリーの根
+   */
+  void onSubtreeLeftTree(Entity* entity) {
+    // rootにつながっていないエンティティの子孫も、rootにつながっていない
+    if (!entity->in_tree_) return;
+    setInTree(entity, false);
+    for (const auto& child : entity->getChildren()) {
+      onSubtreeLeftTree(child.get());
+    }
+  }
+
+  /**
+   * @brief 状態フラグのメンバーリストにエンティティを追加
+   */
+  void addStateFlagMember(Entity* entity, size_t index) {
+    std::lock_guard<std::mutex> lock(state_flag_mutex_);
+    std::vector<Entity*>& members = state_flag_members_[index];
+    entity->state_flag_member_index_[index] = static_cast<Uint32>(members.size());
+    members.push_back(entity);
+  }
+
+  /**
+   * @brief 状態フラグのメンバーリストからエンティティを外す（末尾と入れ替えてO(1)）
+   */
+  void removeStateFlagMember(Entity* entity, size_t index) {
+    std::lock_guard<std::mutex> lock(state_flag_mutex_);
+    std::vector<Entity*>& members = state_flag_members_[index];
+    Uint32 position = entity->state_flag_member_index_[index];
+    if (position + 1 != members.size()) {
+      members[position] = members.back();
+      members[position]->state_flag_member_index_[index] = position;
+    }
+    members.pop_back();
+  }
+
+  /**
+   * @brief 状態フラグの変化をメンバーリストに反映（Entity::setStateFlag()から呼ばれる）
+   */
+  void onStateFlagChanged(Entity* entity, size_t index, bool set) {
+    if (!isStateFlagTracked(index) || !entity->in_tree_) return;
+    if (set) {
+      addStateFlagMember(entity, index);
+    } else {
+      removeStateFlagMember(entity, index);
+    }
+  }
+
+  /**
+   * @brief エンティティの立っている管理対象フラグをすべてメンバーリストに反映
+   * @param add trueなら追加、falseなら削除
+   */
+  void updateStateFlagMembership(Entity* entity, bool add) {
+    Entity::StateFlagBits flags = entity->getStateFlags() & tracked_state_flags_;
+    while (flags) {
+      size_t index = std::countr_zero(flags);
+      flags &= flags - 1;
+      if (add) {
+        addStateFlagMember(entity, index);
+      } else {
+        removeStateFlagMember(entity, index);
+      }
+    }
+  }
+
+  /**
+   * @brief 起きていて、祖先を含めてアクティブなエンティティを集める
+   */
+  void collectUpdateSet() {
+    update_set_.clear();
+    for (Entity* entity : awake_entities_) {
+      if (isInUpdateScope(entity)) {
+        update_set_.push_back(entity);
+      }
+    }
+  }
+
+  /**
+   * @brief エンティティがrootにつながっていて、自身と祖先がすべてアクティブか
+   */
+  bool isInUpdateScope(const Entity* entity) const {
+    for (const Entity* e = entity; e; e = e->getParent()) {
+      if (!e->isActive()) return false;
+      if (e == root_.get()) return true;
+    }
+    return false;  // ツリーに追加される前（生成コマンドの適用待ちなど）
+  }
+
+  /**
+   * @brief エンティティを更新対象リストに追加
+   *
+   * システムの関数（ワーカースレッド）から起こされる場合があるためロックを取る
+   */
+  void wakeEntity(Entity* entity) {
+    std::lock_guard<std::mutex> lock(awake_mutex_);
+    if (entity->awake_.load(std::memory_order_relaxed)) return;
+    entity->awake_index_ = awake_entities_.size();
+    awake_entities_.push_back(entity);
+    entity->awake_.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief エンティティを更新対象リストから外す（末尾と入れ替えてO(1)）
+   */
+  void sleepEntity(Entity* entity) {
+    std::lock_guard<std::mutex> lock(awake_mutex_);
+    if (!entity->awake_.load(std::memory_order_relaxed)) return;
+    size_t index = entity->awake_index_;
+    if (index + 1 != awake_entities_.size()) {
+      awake_entities_[index] = awake_entities_.back();
+      awake_entities_[index]->awake_index_ = index;
+    }
+    awake_entities_.pop_back();
+    entity->awake_.store(false, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 更新が不要になったエンティティをスリープさせる（起きているエンティティ数に比例）
+   */
+  void updateSleepStates() {
+    for (size_t i = 0; i < awake_entities_.size();) {
+      Entity* entity = awake_entities_[i];
+      if (entity->needsUpdate()) {
+        ++i;
+      } else {
+        // 末尾の要素が添字iに来るので、iは進めない
+        sleepEntity(entity);
+      }
+    }
+  }
+
+  /**
+   * @brief 組み込みコンポーネントのシステムを登録
+   *
+   * 登録順はコンポーネント型ID順（従来のupdate()呼び出し順）と同じです。
+   * 移動・回転・向き別アニメーションは互いに衝突しないため同じステージで実行されます。
+   */
+  void registerBuiltinSystems() {
+    // 移動システム
+    scheduler_.addSystem<Locator, VelocityMove>(
+        "movement", componentSignature<Locator>(),
+        [](Uint64 delta_time, Entity&, Locator& locator, VelocityMove& velocity) {
+          velocity.step(locator, delta_time / 1000.0f);
+        });
+
+    // 回転システム
+    scheduler_.addSystem<Rotater, AngularVelocity>(
+        "rotation", componentSignature<Rotater>(),
+        [](Uint64 delta_time, Entity&, Rotater& rotater, AngularVelocity& angular) {
+          angular.step(rotater, delta_time / 1000.0f);
+        });
+
+    // 向き別アニメーション切り替えシステム
+    scheduler_.addSystem<DirectionComponent, DirectionalSpriteAnimator, SpriteAnimator>(
+        "directional_sprite_animation",
+        componentSignature<DirectionalSpriteAnimator, SpriteAnimator, SpriteRenderer>(),
+        [](Uint64, Entity& entity, DirectionComponent& direction,
+           DirectionalSpriteAnimator& directional, SpriteAnimator& animator) {
+          directional.step(direction.getDirection(), animator,
+                           entity.getComponent<SpriteRenderer>());
+        });
+
+    // スプライトアニメーションシステム
+    scheduler_.addSystem<SpriteRenderer, SpriteAnimator>(
+        "sprite_animation", componentSignature<SpriteRenderer, SpriteAnimator>(),
+        [](Uint64 delta_time, Entity&, SpriteRenderer& sprite, SpriteAnimator& animator) {
+          animator.step(sprite, delta_time);
+        });
+  }
+
+  /**
+   * @brief シグネチャに一致するアクティブなエンティティを再帰的に収集
+   * @param entity 収集開始エンティティ
+   * @param signature 必要なコンポーネントのシグネチャ
+   * @param out_entities 収集先のベクタ
+   */
+  void collectMatching(Entity* entity, ComponentSignature signature,
+                       std::vector<Entity*>& out_entities) {
+    if (!entity->isActive()) {
+      return;
+    }
+    if (entity->hasComponents(signature)) {
+      out_entities.push_back(entity);
+    }
+    for (const auto& child : entity->getChildren()) {
+      collectMatching(child.get(), signature, out_entities);
+    }
+  }
+
+ public:
+
+  /**
+   * @brief レイヤー順にすべてのエンティティを描画
+   *
+   * ツリーから全エンティティを集め、レイヤー番号順（背景→前景）に描画します。
+   * 表示フラグをtrackStateFlag()で管理している場合は、フラグが立っているエンティティだけを集めます。
+   * カメラを使用してワールド座標から画面座標への変換を行います。
+   *
+   * @param renderer SDLレンダラー
+   * @param visible_flag_index 表示フラグのインデックス（デフォルト: 0）
+   */
+  void renderAll(SDL_Renderer* renderer, size_t visible_flag_index = 0) {
+    Utilities::FrameProfiler::Scope scope("entities.render");
+
+    // 描画対象を集める（バッファはフレーム間で再利用）
+    std::vector<Entity*>& all_entities = render_list_;
+    if (isStateFlagTracked(visible_flag_index)) {
+      // 表示フラグのメンバー（ツリーへの出入りはメンバーリスト側で反映済み）
+      const std::vector<Entity*>& members = state_flag_members_[visible_flag_index];
+      all_entities.assign(members.begin(), members.end());
+    } else if (flat_hierarchy_enabled_) {
+      all_entities.clear();
+      getFlatHierarchy().forEach([&all_entities](Entity* entity) { all_entities.push_back(entity); });
+    } else {
+      all_entities.clear();
+      collectEntities(root_.get(), all_entities);
+    }
+
+    // レイヤー順にソート
+    // 同じレイヤー内はハンドルのスロット番号順（収集順によらず、フレーム間で描画順が入れ替わらない）
+    // note: stable_sortは作業バッファを毎回確保するため使わない
+    std::sort(
+        all_entities.begin(), all_entities.end(),
+        [](const Entity* a, const Entity* b) {
+          if (a->getLayer() != b->getLayer()) {
+            return a->getLayer() < b->getLayer();
+          }
+          return a->getHandle().index < b->getHandle().index;
+        });
+
+    // レイヤー順に描画
     for (Entity* entity : all_entities) {
       if (entity->isActive() && entity->getStateFlag(visible_flag_index)) {
         // カメラを設定（コンポーネントが座標変換に使用）
@@ -679,7 +2582,7 @@ class EntityManager {
         entity->render(renderer);
 
         // コンポーネントの描画
-        for (const auto& [type, component] : entity->getComponents()) {
+        for (const auto& component : entity->getComponents()) {
           component->render(entity, renderer);
         }
       }
@@ -687,6 +2590,84 @@ class EntityManager {
   }
 
  private:
+  /**
+   * @brief 全エンティティの現在のワールド変換を補間の始点として記録
+   *
+   * ステップ番号を進め、記録したエンティティにその番号を付けます
+   * （ステップの途中で追加されたエンティティは、次のステップまで補間しない）。
+   */
+  void recordPreviousTransforms() {
+    ++interpolation_step_;
+    auto record = [this](Entity* entity) {
+      entity->previous_world_transform_ = entity->getWorldTransform();
+      entity->interpolation_step_ = interpolation_step_;
+    };
+    if (flat_hierarchy_enabled_) {
+      getFlatHierarchy().forEach(record);
+    } else {
+      std::vector<Entity*>& entities = render_list_;  // renderAll()の作業用バッファを借りる
+      entities.clear();
+      collectEntities(root_.get(), entities);
+      for (Entity* entity : entities) {
+        record(entity);
+      }
+    }
+  }
+
+  /**
+   * @brief トゥイーンの値をコンポーネントへ書き込む
+   * @return 書き込めたか（エンティティが削除されたか、コンポーネントがなければfalse）
+   */
+  bool applyTween(EntityHandle owner, TweenProperty property, const TweenValue& value) {
+    Entity* entity = resolve(owner);
+    if (!entity || !entity->isActive()) return false;
+
+    switch (property) {
+      case TweenProperty::Position:
+        if (auto* locator = entity->getComponent<Locator>()) {
+          locator->setPosition(value[0], value[1]);
+          return true;
+        }
+        return false;
+      case TweenProperty::Angle:
+        if (auto* rotater = entity->getComponent<Rotater>()) {
+          rotater->setAngle(value[0]);
+          return true;
+        }
+        return false;
+      case TweenProperty::Scale:
+        if (auto* scaler = entity->getComponent<Scaler>()) {
+          scaler->setScale(value[0], value[1]);
+          return true;
+        }
+        return false;
+      case TweenProperty::Color: {
+        // Back系のイージングで範囲外になる分は切り詰める
+        auto channel = [](float v) {
+          return static_cast<Uint8>(std::clamp(v, 0.0f, 255.0f) + 0.5f);
+        };
+        SDL_Color color{channel(value[0]), channel(value[1]), channel(value[2]),
+                        channel(value[3])};
+        if (auto* rect = entity->getComponent<RectRenderer>()) {
+          rect->setColor(color);
+          return true;
+        }
+        if (auto* rotated = entity->getComponent<RotatedRectRenderer>()) {
+          rotated->setColor(color);
+          return true;
+        }
+        return false;
+      }
+      case TweenProperty::Pivot:
+        if (auto* rotated = entity->getComponent<RotatedRectRenderer>()) {
+          rotated->setPivot(value[0], value[1]);
+          return true;
+        }
+        return false;
+    }
+    return false;
+  }
+
   /**
    * @brief エンティティツリーから全エンティティを収集
    * @param entity 収集開始エンティティ
@@ -704,18 +2685,30 @@ class EntityManager {
 
   /**
    * @brief すべてのエンティティを削除（rootの子を全てクリア）
+   *
+   * エンティティ・コンポーネントのメモリはプールへまとめて返却され、
+   * 次に生成されるエンティティで再利用されます。
    */
   void clear() {
-    auto& children = const_cast<std::vector<std::unique_ptr<Entity>>&>(
-        root_->getChildren());
+    behaviors_.clear();
+    tweens_.clear();
+    commands_.clear();
+    destroyed_entities_.clear();
+    auto& children = const_cast<Entity::ChildList&>(root_->getChildren());
     children.clear();
+    hierarchy_.markDirty();
   }
 
   /**
    * @brief エンティティの総数を取得（root含む）
    * @return エンティティ数
    */
-  size_t getEntityCount() const { return countEntities(root_.get()); }
+  size_t getEntityCount() const {
+    if (flat_hierarchy_enabled_ && !hierarchy_.isDirty()) {
+      return hierarchy_.size();
+    }
+    return countEntities(root_.get());
+  }
 
  private:
   /**
@@ -733,21 +2726,287 @@ class EntityManager {
     return count;
   }
 
+  friend class Entity;
+  friend class EntityCommandBuffer;
+
+  /**
+   * @brief ハンドルのスロット
+   */
+  struct EntitySlot {
+    Entity* entity = nullptr;  // 登録中のエンティティ（空きスロットはnullptr）
+    Uint32 generation = 1;     // 世代番号（解放のたびに進む、0は使わない）
+    std::string name;          // 名前（名前インデックス用）
+  };
+
+  /**
+   * @brief エンティティとその子孫にハンドルを割り当てる
+   * @param entity 登録するエンティティ
+   *
+   * 別のEntityManagerに登録されている場合は、そちらの登録を解除してから登録します。
+   */
+  void attachEntity(Entity* entity) {
+    if (entity->manager_ != this) {
+      if (entity->manager_) {
+        entity->manager_->detachEntity(entity);
+      }
+
+      Uint32 index;
+      if (!free_slot_indices_.empty()) {
+        index = free_slot_indices_.back();
+        free_slot_indices_.pop_back();
+      } else {
+        index = static_cast<Uint32>(entity_slots_.size());
+        entity_slots_.emplace_back();
+      }
+      EntitySlot& slot = entity_slots_[index];
+      slot.entity = entity;
+      entity->manager_ = this;
+      entity->handle_ = EntityHandle{index, slot.generation};
+
+      // 追加前に削除マークされていた場合は削除リストに載せる
+      if (!entity->isActive()) {
+        destroyed_entities_.push_back(entity->handle_);
+      }
+
+      if (entity->needsUpdate()) {
+        wakeEntity(entity);
+      }
+
+      // 登録前に設定された値も変更として扱う
+      for (const auto& component : entity->getComponents()) {
+        recordChange(*component);
+      }
+    }
+
+    // 親がrootにつながっていればツリーに入る（付け替えで戻ってきた場合も含む）
+    Entity* parent = entity->getParent();
+    setInTree(entity, parent ? parent->in_tree_ : entity == root_.get());
+
+    for (const auto& child : entity->getChildren()) {
+      attachEntity(child.get());
+    }
+  }
+
+  /**
+   * @brief エンティティのハンドルを無効化してスロットを解放
+   * @param entity 登録を解除するエンティティ（子孫は含まない）
+   */
+  void detachEntity(Entity* entity) {
+    // 削除マークされたエンティティはdestroy()の時点で記録済み
+    if (entity->isActive()) {
+      recordRemovals(*entity);
+    }
+    if (entity->isAwake()) {
+      sleepEntity(entity);
+    }
+    setInTree(entity, false);
+
+    EntitySlot& slot = entity_slots_[entity->handle_.index];
+    if (!slot.name.empty()) {
+      names_.erase(slot.name);
+      slot.name.clear();
+    }
+    slot.entity = nullptr;
+    if (++slot.generation == 0) {
+      slot.generation = 1;
+    }
+    free_slot_indices_.push_back(entity->handle_.index);
+
+    entity->manager_ = nullptr;
+    entity->handle_ = EntityHandle{};
+  }
+
+  // ハンドル管理（エンティティの破棄時に参照されるため、root_より先に宣言する）
+  std::vector<EntitySlot> entity_slots_;                 // スロット（添字=ハンドルのindex）
+  std::vector<Uint32> free_slot_indices_;                // 空きスロット番号
+  std::unordered_map<std::string, EntityHandle> names_;  // 名前インデックス
+
+  // スリープ管理（エンティティの破棄時に参照されるため、commands_・root_より先に宣言する）
+  std::vector<Entity*> awake_entities_;  // 起きているエンティティ（非所有、順不同）
+  std::vector<Entity*> update_set_;      // 今回のフレームの更新対象（作業用）
+  std::mutex awake_mutex_;               // awake_entities_の保護（ワーカースレッドからの起床用）
+
+  // 状態フラグのメンバーリスト（エンティティの破棄時に参照されるため、commands_・root_より先に宣言する）
+  Entity::StateFlagBits tracked_state_flags_ = 0;  // メンバーリストを管理しているフラグ
+  std::array<std::vector<Entity*>, Entity::MAX_STATE_FLAGS> state_flag_members_;  // フラグごとのメンバー（順不同）
+  std::mutex state_flag_mutex_;  // state_flag_members_の保護（ワーカースレッドからの変更用）
+
+  // 変更の記録（型ごとに、ティック順）
+  std::atomic<Uint64> change_tick_{1};  // 現在の変更ティック
+  std::array<std::vector<ChangeRecord>, MAX_COMPONENT_TYPES> change_logs_;  // 型ごとの変更リスト
+  ComponentSignature tracked_change_types_ = 0;  // 変更リストに記録する型（forEachChanged()で調べられた型）
+  std::array<Uint64, MAX_COMPONENT_TYPES> change_tracking_start_{};  // 型ごとの記録を始めたティック
+  std::array<std::vector<ChangeRecord>, MAX_COMPONENT_TYPES> removal_logs_;  // 型ごとの削除リスト
+  ComponentSignature tracked_removal_types_ = 0;  // 削除リストに記録する型（forEachRemoved()で調べられた型）
+  std::array<Uint64, MAX_COMPONENT_TYPES> removal_tracking_start_{};  // 型ごとの削除の記録を始めたティック
+  Utilities::ThreadPool* thread_pool_ = nullptr;  // setThreadPool()のプール（非所有）
+  std::vector<std::vector<PendingChange>> worker_changes_;  // ワーカーごとの記録待ちの変更
+  std::vector<Uint64> frame_start_ticks_ = std::vector<Uint64>(2, 0);  // 直近フレームの開始ティック
+  size_t frame_cursor_ = 0;             // frame_start_ticks_の次に書き込む位置
+  Uint64 change_log_floor_ = 0;         // 変更リストに残っている最も古いティック
+
+  // 構造変更（生成待ちのエンティティを保持するため、スロットより後・root_より先に宣言する）
+  EntityCommandBuffer commands_;                 // 記録されたコマンド
+  std::vector<EntityHandle> destroyed_entities_;  // 削除マークされたエンティティ
+
   std::unique_ptr<RootEntity> root_;  // ルートエンティティ
   std::unique_ptr<Camera2D> camera_;  // カメラ
+
+  SystemScheduler scheduler_;  // 更新システム
+  BehaviorScheduler behaviors_;  // コルーチンの振る舞い
+  TweenSystem tweens_;           // プロパティのトゥイーン
+
+  // 平坦化した階層配列
+  FlatHierarchy hierarchy_;              // 深さ順の階層配列（ツリー構造の変更は差分で反映）
+  bool flat_hierarchy_enabled_ = false;  // 階層配列を使うか
+
+  // 描画補間
+  bool interpolation_enabled_ = false;  // 描画補間を使うか
+  float interpolation_alpha_ = 1.0f;    // 直前のステップから最新のステップまでの割合
+  Uint64 interpolation_step_ = 0;       // updateAll()のたびに進むステップ番号
+
+  // フレーム間で再利用する作業用バッファ
+  std::vector<std::vector<Entity*>> view_buffers_;  // view()の結果バッファ
+  std::vector<Entity*> render_list_;                // renderAll()の描画順リスト
 };
 
+// Entityの実装（EntityManagerの完全な定義の後に配置）
+
+inline Entity::~Entity() {
+  if (manager_) {
+    manager_->detachEntity(this);
+  }
+}
+
+inline void Entity::destroy() {
+  if (!active_) return;
+  active_ = false;
+  if (manager_) {
+    manager_->destroyed_entities_.push_back(handle_);
+    manager_->recordRemovals(*this);
+  }
+}
+
+inline void Entity::addChild(std::unique_ptr<Entity> child) {
+  child->parent_ = this;
+  child->sibling_index_ = children_.size();
+  child->markWorldTransformDirty();
+  if (manager_) {
+    // 付け替え（登録済みのまま親が変わる）はワールド座標が変わるので、
+    // 登録時と同じく全コンポーネントを変更として記録する（子孫は変更を調べる側がたどる）
+    if (child->manager_ == manager_) {
+      for (const auto& component : child->getComponents()) {
+        manager_->recordChange(*component);
+      }
+    }
+    // 登録済みの親に追加された場合は、子孫もまとめて登録する
+    manager_->attachEntity(child.get());
+  }
+  Entity* added = child.get();
+  children_.push_back(std::move(child));
+  notifyChildAdded(added);
+}
+
+inline Transform2D Entity::getRenderTransform() const {
+  const Transform2D& current = getWorldTransform();
+  if (!manager_ || !manager_->interpolation_enabled_ ||
+      interpolation_step_ != manager_->interpolation_step_) {
+    return current;
+  }
+  return Transform2D::lerp(previous_world_transform_, current, manager_->interpolation_alpha_);
+}
+
+inline void Entity::wake() {
+  if (manager_ && !awake_.load(std::memory_order_relaxed)) {
+    manager_->wakeEntity(this);
+  }
+}
+
+inline void Entity::notifyComponentAdded(Component* component) {
+  wake();
+  if (manager_) {
+    manager_->recordChange(*component);
+  }
+}
+
+inline void Entity::notifyComponentRemoved(ComponentTypeId id) {
+  if (manager_) {
+    manager_->recordRemoval(handle_, id);
+  }
+}
+
+inline void Entity::notifyStateFlagChanged(size_t index, bool set) {
+  if (manager_) {
+    manager_->onStateFlagChanged(this, index, set);
+  }
+}
+
+inline void Entity::notifyChildAdded(Entity* child) {
+  if (manager_) {
+    manager_->hierarchy_.onChildAdded(this, child);
+  }
+}
+
+inline void Entity::notifyChildRemoved(Entity* child) {
+  if (manager_) {
+    manager_->hierarchy_.onChildRemoved(child);
+    if (child->manager_ == manager_) {
+      manager_->onSubtreeLeftTree(child);
+    }
+  }
+}
+
+// EntityCommandBufferの実装（EntityManagerの完全な定義の後に配置）
+
+inline EntityHandle EntityCommandBuffer::spawn(std::unique_ptr<Entity> entity,
+                                               EntityHandle parent) {
+  // ハンドルは記録時に発行し、ツリーへの追加は適用時に行う
+  manager_.attachEntity(entity.get());
+  EntityHandle handle = entity->getHandle();
+
+  Command command;
+  command.type = CommandType::Spawn;
+  command.target = handle;
+  command.parent = parent;
+  command.entity = std::move(entity);
+  commands_.push_back(std::move(command));
+  return handle;
+}
+
+inline void EntityCommandBuffer::destroy(EntityHandle target) {
+  if (Entity* entity = manager_.resolve(target)) {
+    entity->destroy();
+  }
+}
+
 // コンポーネントの実装（Entityクラスの完全な定義の後に配置）
 
+// Componentの実装
+inline void Component::notifyTransformChanged() {
+  if (owner_) {
+    owner_->markWorldTransformDirty();
+  }
+}
+
+inline void Component::markChanged() {
+  if (owner_ && owner_->getManager()) {
+    owner_->getManager()->recordChange(*this);
+  }
+}
+
+inline void Component::notifyActivityChanged() {
+  if (owner_) {
+    owner_->wake();
+  }
+}
+
 // VelocityMoveの実装
 inline void VelocityMove::update(Entity* entity, Uint64 delta_time) {
   // Locatorコンポーネントを取得して座標を更新
   if (auto* locator = entity->getComponent<Locator>()) {
-    auto [x, y] = locator->getPosition();
     // delta_timeをミリ秒→秒に変換して速度を適用
     // 速度の単位は「ピクセル/秒」
-    float dt_sec = delta_time / 1000.0f;
-    locator->setPosition(x + velocity_x_ * dt_sec, y + velocity_y_ * dt_sec);
+    step(*locator, delta_time / 1000.0f);
   }
 }
 
@@ -755,23 +3014,19 @@ inline void VelocityMove::update(Entity* entity, Uint64 delta_time) {
 inline void AngularVelocity::update(Entity* entity, Uint64 delta_time) {
   // Rotaterコンポーネントを取得して角度を更新
   if (auto* rotater = entity->getComponent<Rotater>()) {
-    float angle = rotater->getAngle();
     // delta_timeをミリ秒→秒に変換して角速度を適用
-    angle += angular_velocity_ * (delta_time / 1000.0f);
-
-    // 角度を0-360度に正規化
-    while (angle >= 360.0f) angle -= 360.0f;
-    while (angle < 0.0f) angle += 360.0f;
-
-    rotater->setAngle(angle);
+    step(*rotater, delta_time / 1000.0f);
   }
 }
 
 // RectRendererの実装
 inline void RectRenderer::render(Entity* entity, SDL_Renderer* renderer) {
-  // Entityのワールド座標とスケールを取得
-  auto [world_x, world_y] = entity->getWorldPosition();
-  auto [scale_x, scale_y] = entity->getWorldScale();
+  // 描画用の変換（ワールド変換、補間が有効なら直前のステップとの間）から座標とスケールを取得
+  const Transform2D world = entity->getRenderTransform();
+  float world_x = world.x;
+  float world_y = world.y;
+  float scale_x = world.scale_x;
+  float scale_y = world.scale_y;
 
   // カメラを使用してワールド座標から画面座標に変換
   float screen_x = world_x;
@@ -795,10 +3050,12 @@ inline void RectRenderer::render(Entity* entity, SDL_Renderer* renderer) {
 
 // RotatedRectRendererの実装
 inline void RotatedRectRenderer::render(Entity* entity, SDL_Renderer* renderer) {
-  // Entityのワールド座標、回転角度、スケールを取得
-  auto [world_x, world_y] = entity->getWorldPosition();
-  float world_angle = entity->getWorldAngle();
-  auto [scale_x, scale_y] = entity->getWorldScale();
+  // 描画用の変換から座標、回転、スケールを取得
+  const Transform2D world = entity->getRenderTransform();
+  float world_x = world.x;
+  float world_y = world.y;
+  float scale_x = world.scale_x;
+  float scale_y = world.scale_y;
 
   // カメラを使用してワールド座標から画面座標に変換
   float screen_x = world_x;
@@ -813,10 +3070,9 @@ inline void RotatedRectRenderer::render(Entity* entity, SDL_Renderer* renderer)
   float scaled_width = width_ * scale_x;
   float scaled_height = height_ * scale_y;
 
-  // 角度をラジアンに変換
-  float rad = world_angle * (3.14159265358979323846f / 180.0f);
-  float cos_a = std::cos(rad);
-  float sin_a = std::sin(rad);
+  // 回転のcos/sinはワールド変換の合成時に計算済み
+  float cos_a = world.cos_a;
+  float sin_a = world.sin_a;
 
   // 矩形の半分のサイズ
   float half_w = scaled_width / 2.0f;
@@ -902,7 +3158,9 @@ inline void TextRenderer::render(Entity* entity, SDL_Renderer* renderer) {
     screen_y = anchor_y + offset_y;
   } else {
     // ゲーム要素として扱う：ワールド座標 + カメラ変換
-    auto [world_x, world_y] = entity->getWorldPosition();
+    const Transform2D world = entity->getRenderTransform();
+    float world_x = world.x;
+    float world_y = world.y;
 
     // カメラを使用してワールド座標から画面座標に変換
     if (auto* camera = entity->getRenderCamera()) {
@@ -927,9 +3185,12 @@ inline void TextRenderer::render(Entity* entity, SDL_Renderer* renderer) {
 inline void SpriteRenderer::render(Entity* entity, SDL_Renderer* renderer) {
   if (!texture_) return;
 
-  // ワールド座標を取得
-  auto [world_x, world_y] = entity->getWorldPosition();
-  auto [scale_x, scale_y] = entity->getWorldScale();
+  // 描画用の変換から座標とスケールを取得
+  const Transform2D world = entity->getRenderTransform();
+  float world_x = world.x;
+  float world_y = world.y;
+  float scale_x = world.scale_x;
+  float scale_y = world.scale_y;
 
   // カメラを使用してワールド座標から画面座標に変換
   float screen_x = world_x;
@@ -973,20 +3234,27 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
   auto* direction_comp = entity->getComponent<DirectionComponent>();
   if (!direction_comp) return;
 
-  Direction new_direction = direction_comp->getDirection();
+  auto* animator = entity->getComponent<SpriteAnimator>();
+  if (!animator) {
+    current_direction_ = direction_comp->getDirection();
+    return;
+  }
+
+  step(direction_comp->getDirection(), *animator,
+       entity->getComponent<SpriteRenderer>());
+}
 
+inline void DirectionalSpriteAnimator::step(
+    Direction new_direction, SpriteAnimator& animator,
+    SpriteRenderer* sprite_renderer) {
   // 向きが変わった場合のみ、フレームを切り替える
   if (new_direction != current_direction_) {
     current_direction_ = new_direction;
 
-    auto* animator = entity->getComponent<SpriteAnimator>();
-    auto* sprite_renderer = entity->getComponent<SpriteRenderer>();
-    if (!animator) return;
-
     // 向きに応じてフレームを設定
     switch (new_direction) {
       case Direction::Down:
-        animator->setFrames(down_frames_);
+        animator.setFrames(down_frames_);
         if (sprite_renderer && !down_frames_.empty()) {
           sprite_renderer->setFlipHorizontal(false);
           // 即座に新しいアニメーションの最初のフレームを表示
@@ -995,7 +3263,7 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
         }
         break;
       case Direction::Up:
-        animator->setFrames(up_frames_);
+        animator.setFrames(up_frames_);
         if (sprite_renderer && !up_frames_.empty()) {
           sprite_renderer->setFlipHorizontal(false);
           // 即座に新しいアニメーションの最初のフレームを表示
@@ -1004,7 +3272,7 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
         }
         break;
       case Direction::Right:
-        animator->setFrames(right_frames_);
+        animator.setFrames(right_frames_);
         if (sprite_renderer && !right_frames_.empty()) {
           sprite_renderer->setFlipHorizontal(false);
           // 即座に新しいアニメーションの最初のフレームを表示
@@ -1015,7 +3283,7 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
       case Direction::Left:
         if (left_frames_.empty()) {
           // 左向きフレームが未定義の場合、右向きを左右反転
-          animator->setFrames(right_frames_);
+          animator.setFrames(right_frames_);
           if (sprite_renderer && !right_frames_.empty()) {
             sprite_renderer->setFlipHorizontal(true);
             // 即座に新しいアニメーションの最初のフレームを表示
@@ -1024,7 +3292,7 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
           }
         } else {
           // 左向きフレームが定義されている場合
-          animator->setFrames(left_frames_);
+          animator.setFrames(left_frames_);
           if (sprite_renderer && !left_frames_.empty()) {
             sprite_renderer->setFlipHorizontal(false);
             // 即座に新しいアニメーションの最初のフレームを表示
@@ -1042,25 +3310,9 @@ inline void DirectionalSpriteAnimator::update(Entity* entity, Uint64 delta_time)
 // =========================================================================
 
 inline void SpriteAnimator::update(Entity* entity, Uint64 delta_time) {
-  if (frames_.empty()) return;
-
   // SpriteRendererコンポーネントを取得
-  auto* sprite_renderer = entity->getComponent<SpriteRenderer>();
-  if (!sprite_renderer) return;
-
-  // タイマーを進める
-  timer_ += delta_time;
-
-  // フレーム切り替えが必要かチェック
-  if (timer_ >= frame_duration_) {
-    timer_ -= frame_duration_;
-
-    // 次のフレームへ
-    current_frame_ = (current_frame_ + 1) % frames_.size();
-
-    // SpriteRendererのタイルを更新
-    auto [tile_x, tile_y] = frames_[current_frame_];
-    sprite_renderer->setTile(tile_x, tile_y);
+  if (auto* sprite_renderer = entity->getComponent<SpriteRenderer>()) {
+    step(*sprite_renderer, delta_time);
   }
 }
 
@@ -1083,13 +3335,13 @@ inline std::unique_ptr<Entity> createRectEntity(
   auto entity = std::make_unique<Entity>(layer);
 
   // 座標コンポーネント
-  entity->addComponent(std::make_unique<Locator>(x, y));
+  entity->emplaceComponent<Locator>(x, y);
 
   // 移動コンポーネント
-  entity->addComponent(std::make_unique<VelocityMove>(0.0f, 0.0f));
+  entity->emplaceComponent<VelocityMove>(0.0f, 0.0f);
 
   // 描画コンポーネント
-  entity->addComponent(std::make_unique<RectRenderer>(w, h, color));
+  entity->emplaceComponent<RectRenderer>(w, h, color);
 
   return entity;
 }
@@ -1117,19 +3369,19 @@ inline std::unique_ptr<Entity> createRotateRectEntity(
   auto entity = std::make_unique<Entity>(layer);
 
   // 座標コンポーネント
-  entity->addComponent(std::make_unique<Locator>(x, y));
+  entity->emplaceComponent<Locator>(x, y);
 
   // 回転コンポーネント
-  entity->addComponent(std::make_unique<Rotater>(angle));
+  entity->emplaceComponent<Rotater>(angle);
 
   // 移動コンポーネント
-  entity->addComponent(std::make_unique<VelocityMove>(0.0f, 0.0f));
+  entity->emplaceComponent<VelocityMove>(0.0f, 0.0f);
 
   // 角速度コンポーネント
-  entity->addComponent(std::make_unique<AngularVelocity>(0.0f));
+  entity->emplaceComponent<AngularVelocity>(0.0f);
 
   // 回転矩形描画コンポーネント
-  entity->addComponent(std::make_unique<RotatedRectRenderer>(w, h, color, pivot_x, pivot_y));
+  entity->emplaceComponent<RotatedRectRenderer>(w, h, color, pivot_x, pivot_y);
 
   return entity;
 }
@@ -1155,14 +3407,14 @@ inline std::unique_ptr<Entity> createTextEntity(
   auto entity = std::make_unique<Entity>(layer);
 
   // 座標コンポーネント
-  entity->addComponent(std::make_unique<Locator>(x, y));
+  entity->emplaceComponent<Locator>(x, y);
 
   // テキスト描画コンポーネント
-  entity->addComponent(std::make_unique<TextRenderer>(text, color));
+  entity->emplaceComponent<TextRenderer>(text, color);
 
   // UIアンカーが指定されている場合は追加
   if (anchor) {
-    entity->addComponent(std::make_unique<UIAnchorComponent>(*anchor));
+    entity->emplaceComponent<UIAnchorComponent>(*anchor);
   }
 
   return entity;
@@ -1189,14 +3441,14 @@ inline std::unique_ptr<Entity> createTextEntity(
   auto entity = std::make_unique<Entity>(layer);
 
   // 座標コンポーネント
-  entity->addComponent(std::make_unique<Locator>(x, y));
+  entity->emplaceComponent<Locator>(x, y);
 
   // テキスト描画コンポーネント（動的）
-  entity->addComponent(std::make_unique<TextRenderer>(text_provider, color));
+  entity->emplaceComponent<TextRenderer>(text_provider, color);
 
   // UIアンカーが指定されている場合は追加
   if (anchor) {
-    entity->addComponent(std::make_unique<UIAnchorComponent>(*anchor));
+    entity->emplaceComponent<UIAnchorComponent>(*anchor);
   }
 
   return entity;
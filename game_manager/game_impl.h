@@ -11,6 +11,21 @@ concept GameImplementation = requires(T t, SDL_Event* e) {
   { t.update() } -> std::same_as<SDL_AppResult>;
 };
 
+/**
+ * @brief 固定ステップで更新するゲーム実装
+ *
+ * fixedUpdate()とrender()を持つ場合、GameManagerはupdate()の代わりに
+ * 経過時間を貯めて一定間隔でfixedUpdate()を呼び、フレームごとに1回render()を呼びます。
+ * - fixedUpdate(step_ms): シミュレーションを1ステップ進める（タイムスケール適用済みの間隔で呼ばれる）
+ * - render(alpha): 描画する。alphaは最新のステップから次のステップまでの経過割合（0.0～1.0）
+ */
+template <typename T>
+concept FixedStepGameImplementation =
+    GameImplementation<T> && requires(T t, Uint64 step_ms, float alpha) {
+      { t.fixedUpdate(step_ms) } -> std::same_as<SDL_AppResult>;
+      { t.render(alpha) } -> std::same_as<SDL_AppResult>;
+    };
+
 class GameImpl {
  public:
   virtual ~GameImpl() = default;
@@ -2,12 +2,14 @@
 
 #include <SDL3/SDL.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <string>
 
 #include "../game_constant.h"
 #include "game_impl.h"
+#include "utilities/game_clock.h"
 
 namespace MyGame {
 
@@ -18,6 +20,7 @@ namespace MyGame {
  *
  * GameImplementation conceptを使用して、コンパイル時に型チェックを行います。
  * ジョイスティックの管理や、SDL_Eventの委譲を担当します。
+ * ゲーム実装がFixedStepGameImplementationを満たす場合は、固定ステップの更新と描画補間の割合の計算も行います。
  * 
  * note: 現状、無理やりconceptのrequires試すためだけにtemplate書いてるだけになっていて恩恵は特にないけど練習なので気にせずで。
  */
@@ -34,13 +37,17 @@ class GameManager {
   float saved_timescale_ = 1.0f;   // ポーズ前のタイムスケールを保存
   bool is_paused_ = false;          // ポーズ状態
 
+  // 固定ステップ管理（FixedStepGameImplementationのみ）
+  Uint64 last_time_ns_ = 0;      // 前回のupdate()の時刻（ナノ秒）
+  double accumulator_ns_ = 0.0;  // まだステップに消化していない時間（タイムスケール適用済み、ナノ秒）
+
  public:
   /**
    * @brief GameManagerを構築します
    * @param impl ゲーム実装のインスタンス
    */
   explicit GameManager(std::unique_ptr<GameType> impl)
-      : impl(std::move(impl)) {}
+      : impl(std::move(impl)), last_time_ns_(Utilities::GameClock::getTicksNS()) {}
 
   /**
    * @brief デストラクタ
@@ -51,8 +58,18 @@ class GameManager {
   /**
    * @brief ゲームの更新処理を実行します
    * @return SDL_AppResult 実行結果
+   *
+   * FixedStepGameImplementationの場合は、前回からの経過時間にタイムスケールを掛けて貯め、
+   * FIXED_STEP_MSごとにfixedUpdate()を呼んでから、残りの割合を渡してrender()を呼びます。
+   * それ以外の場合はupdate()に任せます。
    */
-  SDL_AppResult update() { return impl->update(); }
+  SDL_AppResult update() {
+    if constexpr (FixedStepGameImplementation<GameType>) {
+      return updateFixedStep();
+    } else {
+      return impl->update();
+    }
+  }
 
   /**
    * @brief ジョイスティックを追加します
@@ -165,6 +182,38 @@ class GameManager {
    * @return bool ポーズ中の場合true
    */
   bool isPaused() const { return is_paused_; }
+
+ private:
+  /**
+   * @brief 固定ステップで更新して描画します
+   * @return SDL_AppResult 実行結果
+   *
+   * 時間はナノ秒で貯め、タイムスケールは浮動小数のまま掛けるため、切り捨てによる時間の損失はありません。
+   * 処理が重いフレームの後は複数のステップで追いつきます（MAX_FIXED_STEPS_PER_FRAMEまで。超えた分は捨てる）。
+   */
+  SDL_AppResult updateFixedStep() {
+    constexpr double step_ns = static_cast<double>(FIXED_STEP_MS * SDL_NS_PER_MS);
+
+    Uint64 now = Utilities::GameClock::getTicksNS();
+    Uint64 elapsed = now - last_time_ns_;
+    last_time_ns_ = now;
+    accumulator_ns_ += static_cast<double>(elapsed) * timescale_;
+
+    for (int steps = 0; accumulator_ns_ >= step_ns; ++steps) {
+      if (steps == MAX_FIXED_STEPS_PER_FRAME) {
+        // 追いつけない分は捨てる（デバッガでの停止などの後にステップが溜まり続けないように）
+        accumulator_ns_ = std::fmod(accumulator_ns_, step_ns);
+        break;
+      }
+      SDL_AppResult result = impl->fixedUpdate(FIXED_STEP_MS);
+      if (result != SDL_APP_CONTINUE) {
+        return result;
+      }
+      accumulator_ns_ -= step_ns;
+    }
+
+    return impl->render(static_cast<float>(accumulator_ns_ / step_ns));
+  }
 };
 
 }  // namespace MyGame
\ No newline at end of file
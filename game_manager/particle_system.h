@@ -0,0 +1,292 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "entity_manager.h"
+#include "utilities/frame_profiler.h"
+
+namespace MyGame {
+
+/**
+ * @brief パーティクルの放出設定
+ *
+ * 値の範囲（min～max）は放出時に一様乱数で決めます。
+ */
+struct ParticleEmitter {
+  float rate = 100.0f;               // 1秒あたりの放出数（emitOverTime()用）
+  float direction = -90.0f;          // 放出方向（度数法、0で右、-90で上）
+  float spread = 30.0f;              // 放出方向のばらつき（±度数）
+  float speed_min = 50.0f;           // 初速（ピクセル/秒）
+  float speed_max = 100.0f;
+  Uint64 lifetime_min_ms = 500;      // 寿命（ミリ秒）
+  Uint64 lifetime_max_ms = 1000;
+  float size_min = 2.0f;             // 一辺の長さ（ピクセル）
+  float size_max = 4.0f;
+  SDL_Color color{255, 255, 255, 255};  // 色
+  float carry = 0.0f;  // emitOverTime()で放出しきれなかった端数（内部状態）
+};
+
+/**
+ * @brief 大量のパーティクルを配列ごとに分けて（SoA）持つパーティクルシステム
+ *
+ * 座標・速度・経過割合・色をそれぞれ別の配列に持ち、update()は全パーティクル分の
+ * 単純なループで進めます。描画は全パーティクルの四角形を1つの頂点配列にまとめ、
+ * 1回のSDL_RenderGeometry()で行います（テクスチャごとにシステムを分ける）。
+ * 配列は最大数まで事前確保するため、放出と消滅で確保は発生しません。
+ *
+ * エンティティとは独立しており、ゲーム側で所有してupdate()/render()を呼びます。
+ *
+ * 使用例:
+ * @code
+ * ParticleSystem sparks(10000);
+ * ParticleEmitter emitter;
+ * emitter.color = SDL_Color{255, 200, 50, 255};
+ * sparks.emit(emitter, 320.0f, 240.0f, 200);  // 一度に放出
+ *
+ * // 毎フレーム
+ * sparks.emitOverTime(emitter, 320.0f, 240.0f, delta_time);  // 連続して放出
+ * sparks.update(delta_time);
+ * sparks.render(renderer, entity_manager.getCamera());
+ * @endcode
+ */
+class ParticleSystem {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param max_particles 同時に存在できる最大数（超えた分の放出は捨てる）
+   * @param seed 乱数の種（同じ種と入力なら同じ結果になる）
+   */
+  explicit ParticleSystem(size_t max_particles = 100000, Uint64 seed = 1)
+      : max_particles_(max_particles), random_state_(seed) {
+    for (std::vector<float>* values : arrays()) {
+      values->reserve(max_particles);
+    }
+    vertices_.reserve(max_particles * 4);
+    indices_.reserve(max_particles * 6);
+  }
+
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  /**
+   * @brief パーティクルを一度に放出
+   * @param emitter 放出設定
+   * @param x 放出位置のX座標（ワールド座標）
+   * @param y 放出位置のY座標（ワールド座標）
+   * @param count 放出数
+   */
+  void emit(const ParticleEmitter& emitter, float x, float y, size_t count) {
+    count = std::min(count, max_particles_ - std::min(max_particles_, x_.size()));
+    const float color_scale = 1.0f / 255.0f;
+    for (size_t i = 0; i < count; ++i) {
+      float angle = (emitter.direction + emitter.spread * (random() * 2.0f - 1.0f)) *
+                    SDL_PI_F / 180.0f;
+      float speed = lerp(emitter.speed_min, emitter.speed_max, random());
+      float lifetime = lerp(static_cast<float>(emitter.lifetime_min_ms),
+                            static_cast<float>(emitter.lifetime_max_ms), random());
+
+      x_.push_back(x);
+      y_.push_back(y);
+      vx_.push_back(std::cos(angle) * speed);
+      vy_.push_back(std::sin(angle) * speed);
+      life_.push_back(0.0f);
+      life_rate_.push_back(1.0f / std::max(lifetime, 1.0f));
+      size_.push_back(lerp(emitter.size_min, emitter.size_max, random()));
+      r_.push_back(emitter.color.r * color_scale);
+      g_.push_back(emitter.color.g * color_scale);
+      b_.push_back(emitter.color.b * color_scale);
+      a_.push_back(emitter.color.a * color_scale);
+    }
+  }
+
+  /**
+   * @brief 経過時間に応じた数のパーティクルを放出（emitter.rate個/秒）
+   * @param emitter 放出設定（端数をcarryに持ち越す）
+   * @param x 放出位置のX座標（ワールド座標）
+   * @param y 放出位置のY座標（ワールド座標）
+   * @param delta_time 経過時間（ミリ秒）
+   */
+  void emitOverTime(ParticleEmitter& emitter, float x, float y, Uint64 delta_time) {
+    emitter.carry += emitter.rate * static_cast<float>(delta_time) / 1000.0f;
+    size_t count = static_cast<size_t>(emitter.carry);
+    emitter.carry -= static_cast<float>(count);
+    emit(emitter, x, y, count);
+  }
+
+  /**
+   * @brief パーティクルを進め、寿命が尽きたものを取り除く
+   * @param delta_time 経過時間（ミリ秒）
+   */
+  void update(Uint64 delta_time) {
+    Utilities::FrameProfiler::Scope scope("particles.update");
+    const size_t count = x_.size();
+    const float dt_ms = static_cast<float>(delta_time);
+    const float dt_sec = dt_ms / 1000.0f;
+
+    // 速度（重力）・座標・経過割合の更新
+    float* x = x_.data();
+    float* y = y_.data();
+    float* vx = vx_.data();
+    float* vy = vy_.data();
+    float* life = life_.data();
+    const float* life_rate = life_rate_.data();
+    const float gx = gravity_x_ * dt_sec;
+    const float gy = gravity_y_ * dt_sec;
+    for (size_t i = 0; i < count; ++i) {
+      vx[i] += gx;
+      vy[i] += gy;
+      x[i] += vx[i] * dt_sec;
+      y[i] += vy[i] * dt_sec;
+      life[i] += life_rate[i] * dt_ms;
+    }
+
+    // 寿命が尽きたものを詰める（順序を保つので描画順が入れ替わらない）
+    // 判定に使うlife_は最後に詰める
+    size_t alive = count;
+    for (std::vector<float>* values : arrays()) {
+      float* data = values->data();
+      size_t write = 0;
+      for (size_t i = 0; i < count; ++i) {
+        if (life[i] < 1.0f) data[write++] = data[i];
+      }
+      alive = write;
+    }
+    if (alive != count) {
+      for (std::vector<float>* values : arrays()) {
+        values->resize(alive);
+      }
+    }
+  }
+
+  /**
+   * @brief すべてのパーティクルを1回の呼び出しで描画
+   * @param renderer SDLレンダラー
+   * @param camera 視点（nullptrならワールド座標をそのまま画面座標にする）
+   *
+   * テクスチャを設定している場合は、各パーティクルにテクスチャ全体を貼ります。
+   */
+  void render(SDL_Renderer* renderer, const Camera2D* camera = nullptr) {
+    Utilities::FrameProfiler::Scope scope("particles.render");
+    const size_t count = x_.size();
+    if (count == 0) return;
+
+    // カメラは平行移動とズームのみなので、screen = world * zoom + offsetで変換できる
+    float zoom = 1.0f;
+    float offset_x = 0.0f;
+    float offset_y = 0.0f;
+    if (camera) {
+      auto [ox, oy] = camera->worldToScreen(0.0f, 0.0f);
+      offset_x = ox;
+      offset_y = oy;
+      zoom = camera->getZoom();
+    }
+
+    // インデックスは四角形ごとに同じ並びなので、増えた分だけ追加する
+    for (size_t quad = indices_.size() / 6; quad < count; ++quad) {
+      int base = static_cast<int>(quad * 4);
+      for (int index : {0, 1, 2, 2, 3, 0}) {
+        indices_.push_back(base + index);
+      }
+    }
+
+    vertices_.resize(count * 4);
+    SDL_Vertex* vertex = vertices_.data();
+    for (size_t i = 0; i < count; ++i) {
+      float half = size_[i] * zoom * 0.5f;
+      float cx = x_[i] * zoom + offset_x;
+      float cy = y_[i] * zoom + offset_y;
+      float alpha = fade_out_ ? a_[i] * (1.0f - life_[i]) : a_[i];
+      SDL_FColor color{r_[i], g_[i], b_[i], alpha};
+      vertex[0] = SDL_Vertex{{cx - half, cy - half}, color, {0.0f, 0.0f}};
+      vertex[1] = SDL_Vertex{{cx + half, cy - half}, color, {1.0f, 0.0f}};
+      vertex[2] = SDL_Vertex{{cx + half, cy + half}, color, {1.0f, 1.0f}};
+      vertex[3] = SDL_Vertex{{cx - half, cy + half}, color, {0.0f, 1.0f}};
+      vertex += 4;
+    }
+
+    SDL_RenderGeometry(renderer, texture_, vertices_.data(), static_cast<int>(count * 4),
+                       indices_.data(), static_cast<int>(count * 6));
+  }
+
+  /**
+   * @brief 重力（加速度）を設定
+   * @param gravity_x X方向の加速度（ピクセル/秒^2）
+   * @param gravity_y Y方向の加速度（ピクセル/秒^2）
+   */
+  void setGravity(float gravity_x, float gravity_y) {
+    gravity_x_ = gravity_x;
+    gravity_y_ = gravity_y;
+  }
+
+  /**
+   * @brief 寿命に合わせて透明にするかを設定（デフォルト: true）
+   * @param fade_out 寿命の終わりに向けてアルファを0にするならtrue
+   */
+  void setFadeOut(bool fade_out) { fade_out_ = fade_out; }
+
+  /**
+   * @brief 描画に使うテクスチャを設定
+   * @param texture テクスチャ（nullptrなら塗りつぶし、所有権は移譲しない）
+   */
+  void setTexture(SDL_Texture* texture) { texture_ = texture; }
+
+  /**
+   * @brief 存在しているパーティクル数を取得
+   */
+  size_t getCount() const { return x_.size(); }
+
+  /**
+   * @brief 同時に存在できる最大数を取得
+   */
+  size_t getMaxParticles() const { return max_particles_; }
+
+  /**
+   * @brief すべてのパーティクルを消す
+   */
+  void clear() {
+    for (std::vector<float>* values : arrays()) {
+      values->clear();
+    }
+  }
+
+ private:
+  /**
+   * @brief パーティクルごとの値の配列（詰める・確保するときにまとめて扱う、life_は最後）
+   */
+  std::array<std::vector<float>*, 11> arrays() {
+    return {&x_, &y_, &vx_, &vy_, &life_rate_, &size_, &r_, &g_, &b_, &a_, &life_};
+  }
+
+  /**
+   * @brief 0～1の一様乱数
+   */
+  float random() { return SDL_randf_r(&random_state_); }
+
+  static float lerp(float from, float to, float t) { return from + (to - from) * t; }
+
+  size_t max_particles_;  // 同時に存在できる最大数
+  Uint64 random_state_;   // 乱数の状態
+  float gravity_x_ = 0.0f;  // 重力（ピクセル/秒^2）
+  float gravity_y_ = 0.0f;
+  bool fade_out_ = true;    // 寿命に合わせて透明にするか
+  SDL_Texture* texture_ = nullptr;  // 描画に使うテクスチャ（非所有）
+
+  // パーティクルごとの値（添字が同じものが1つのパーティクル）
+  std::vector<float> x_, y_;         // 座標（ワールド座標）
+  std::vector<float> vx_, vy_;       // 速度（ピクセル/秒）
+  std::vector<float> life_;          // 経過割合（0で放出、1で消滅）
+  std::vector<float> life_rate_;     // 1ミリ秒あたりの経過割合（1 / 寿命）
+  std::vector<float> size_;          // 一辺の長さ（ピクセル）
+  std::vector<float> r_, g_, b_, a_;  // 色（0.0～1.0）
+
+  // 描画用の作業バッファ
+  std::vector<SDL_Vertex> vertices_;  // 四角形ごとに4頂点
+  std::vector<int> indices_;          // 四角形ごとに6インデックス（2つの三角形）
+};
+
+}  // namespace MyGame
@@ -0,0 +1,900 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "entity_manager.h"
+#include "tile_grid.h"
+#include "utilities/frame_profiler.h"
+
+namespace MyGame {
+
+/**
+ * @brief タイルの上の移動の規則（経路探索とフローフィールドで共通）
+ *
+ * 8方向に1タイルずつ動き、斜めの移動は両隣のタイルが通れるときだけ許します（角を削らない）。
+ * コストは直進10、斜め14の整数で、グリッドの外は通れないものとして扱います。
+ */
+struct TileMove {
+  static constexpr int COUNT = 8;         // 方向の数（0～3が直進、4～7が斜め）
+  static constexpr Uint8 NONE = 8;        // 向きなし（ゴール、または到達できない）
+  static constexpr Uint32 STRAIGHT = 10;  // 直進のコスト
+  static constexpr Uint32 DIAGONAL = 14;  // 斜めのコスト
+  static constexpr std::array<int, COUNT> DX = {1, 0, -1, 0, 1, -1, -1, 1};
+  static constexpr std::array<int, COUNT> DY = {0, 1, 0, -1, 1, 1, -1, -1};
+
+  static constexpr Uint32 cost(int direction) { return direction < 4 ? STRAIGHT : DIAGONAL; }
+
+  /**
+   * @brief 2つのタイルの間の、障害物がない場合のコスト（8方向の距離）
+   */
+  static Uint32 octile(int dx, int dy) {
+    Uint32 ax = static_cast<Uint32>(std::abs(dx));
+    Uint32 ay = static_cast<Uint32>(std::abs(dy));
+    return STRAIGHT * std::max(ax, ay) + (DIAGONAL - STRAIGHT) * std::min(ax, ay);
+  }
+};
+
+/**
+ * @brief 1つのゴールに向かう積算コストと移動方向のフィールド
+ *
+ * ゴールから全タイルへのコスト（直進10、斜め14）をダイクストラ法で求め、
+ * 各タイルに「コストが最も小さくなる隣への向き」を持たせます。
+ * エージェントは自分のいるタイルの向きを読むだけで進めるため、数が多くても1体あたりO(1)です。
+ *
+ * コストは1回に高々14しか増えないので、優先度付きキューの代わりに
+ * コストの下位4ビットで分けた16個のバケツを使います（Dialの方法）。
+ * タイルの通れる／通れないが変わった場合は、update()で影響を受けたタイルだけを作り直します。
+ *
+ * 使用例:
+ * @code
+ * FlowField field;
+ * field.build(tiles, goal_x, goal_y);
+ *
+ * // 毎ステップ
+ * field.update(tiles);  // タイルが変わっていれば差分だけ作り直す
+ * auto [dir_x, dir_y] = field.sample(x, y);  // ワールド座標での進む向き（単位ベクトル）
+ * velocity.setVelocity(dir_x * speed, dir_y * speed);
+ * @endcode
+ */
+class FlowField {
+ public:
+  static constexpr Uint32 UNREACHABLE = 0xFFFFFFFF;  // 到達できないタイルのコスト
+
+  FlowField() = default;
+
+  /**
+   * @brief フィールドを全体から作る
+   * @param grid タイルグリッド
+   * @param goal_x ゴールの列
+   * @param goal_y ゴールの行（ゴールが範囲外か通れない場合、すべて到達できない）
+   */
+  void build(const TileGrid& grid, int goal_x, int goal_y) {
+    Utilities::FrameProfiler::Scope scope("flow_field.build");
+    goal_x_ = goal_x;
+    goal_y_ = goal_y;
+    width_ = grid.getWidth();
+    height_ = grid.getHeight();
+    stride_ = width_ + 2;
+    version_ = grid.getVersion();
+    copyPlacement(grid);
+
+    // 周囲に1タイルずつ通れない枠を付け、隣を見るときに範囲の判定を省く
+    const size_t size = static_cast<size_t>(stride_) * (height_ + 2);
+    passable_.assign(size, 0);
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        passable_[index(x, y)] = grid.isSolid(x, y) ? 0 : 1;
+      }
+    }
+    cost_.assign(size, UNREACHABLE);
+    direction_.assign(size, TileMove::NONE);
+    moves_.assign(size, 0);
+    touched_flags_.assign(size, 0);
+    for (int d = 0; d < TileMove::COUNT; ++d) {
+      offsets_[d] = TileMove::DX[d] + TileMove::DY[d] * stride_;
+    }
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        updateMoves(index(x, y));
+      }
+    }
+
+    if (!isGoalValid()) return;
+    const int goal = index(goal_x_, goal_y_);
+    cost_[goal] = 0;
+    seeds_.clear();
+    seeds_.push_back(Seed{0, goal});
+    propagate();
+    touched_.clear();
+    std::fill(touched_flags_.begin(), touched_flags_.end(), 0);
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        updateDirection(index(x, y));
+      }
+    }
+  }
+
+  /**
+   * @brief タイルの変更に合わせてフィールドを更新
+   * @param grid build()に渡したタイルグリッド
+   *
+   * 前回から通れなくなったタイルを通っていた経路だけを消してから、その周りのコストを広げ直します。
+   * 大きさが変わった場合や変更が多い場合は全体から作り直します。結果はbuild()と同じです。
+   */
+  void update(const TileGrid& grid) {
+    copyPlacement(grid);
+    if (grid.getVersion() == version_) return;
+    if (grid.getWidth() != width_ || grid.getHeight() != height_) {
+      build(grid, goal_x_, goal_y_);
+      return;
+    }
+
+    // 通れる／通れないが実際に変わったタイルを集める（変えて戻したものは除く）
+    changed_.clear();
+    bool ok = grid.forEachChangedTile(version_, [&](int x, int y) {
+      int i = index(x, y);
+      Uint8 passable = grid.isSolid(x, y) ? 0 : 1;
+      if (passable_[i] == passable) return;
+      passable_[i] = passable;
+      changed_.push_back(i);
+    });
+    version_ = grid.getVersion();
+    if (!ok || changed_.size() > static_cast<size_t>(width_) * height_ / 4) {
+      build(grid, goal_x_, goal_y_);
+      return;
+    }
+    if (changed_.empty()) return;
+    for (int i : changed_) {
+      updateMoves(i);
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        updateMoves(i + offsets_[d]);
+      }
+    }
+    if (!isGoalValid() || std::find(changed_.begin(), changed_.end(),
+                                    index(goal_x_, goal_y_)) != changed_.end()) {
+      build(grid, goal_x_, goal_y_);
+      return;
+    }
+    Utilities::FrameProfiler::Scope scope("flow_field.update");
+
+    // 1. 通れなくなったタイルと、それを通っていた（向きをたどると行き着く）タイルのコストを消す
+    //    斜めの移動で角にしていたタイルも、その移動ができなくなるので消す
+    stack_.clear();
+    for (int i : changed_) {
+      if (passable_[i]) {
+        touch(i);  // 通れるようになったタイルは、隣から広げ直す
+        continue;
+      }
+      stack_.push_back(i);
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        int neighbor = i - offsets_[d];
+        Uint8 used = direction_[neighbor];
+        if (used >= 4 && used != TileMove::NONE &&
+            (neighbor + TileMove::DX[used] == i || neighbor + TileMove::DY[used] * stride_ == i)) {
+          stack_.push_back(neighbor);
+        }
+      }
+    }
+    while (!stack_.empty()) {
+      int i = stack_.back();
+      stack_.pop_back();
+      if (touched_flags_[i]) continue;
+      touch(i);
+      cost_[i] = UNREACHABLE;
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        int neighbor = i - offsets_[d];
+        if (direction_[neighbor] == d && !touched_flags_[neighbor]) stack_.push_back(neighbor);
+      }
+    }
+
+    // 2. 消したタイルに隣接する、コストが残っているタイルから広げ直す
+    seeds_.clear();
+    for (size_t t = 0; t < touched_.size(); ++t) {
+      int i = touched_[t];
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        int neighbor = i + offsets_[d];
+        if (!touched_flags_[neighbor] && cost_[neighbor] != UNREACHABLE) {
+          seeds_.push_back(Seed{cost_[neighbor], neighbor});
+        }
+      }
+    }
+    std::sort(seeds_.begin(), seeds_.end(),
+              [](const Seed& a, const Seed& b) { return a.cost < b.cost; });
+    propagate();
+
+    // 3. コストが変わったタイルとその隣の向きを選び直す
+    for (int i : touched_) {
+      updateDirection(i);
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        updateDirection(i + offsets_[d]);
+      }
+    }
+    for (int i : touched_) {
+      touched_flags_[i] = 0;
+    }
+    touched_.clear();
+  }
+
+  /**
+   * @brief ワールド座標での進む向きを取得
+   * @return 単位ベクトル（ゴールのタイル、到達できないタイル、範囲外では{0, 0}）
+   */
+  std::pair<float, float> sample(float world_x, float world_y) const {
+    int x = static_cast<int>(std::floor((world_x - origin_x_) / tile_width_));
+    int y = static_cast<int>(std::floor((world_y - origin_y_) / tile_height_));
+    Uint8 d = getDirection(x, y);
+    return {DIRECTION_X[d], DIRECTION_Y[d]};
+  }
+
+  /**
+   * @brief タイルの進む向きを取得
+   * @return 0～7の方向（TileMove::DX/DY）、向きがなければTileMove::NONE
+   */
+  Uint8 getDirection(int x, int y) const {
+    if (!inBounds(x, y)) return TileMove::NONE;
+    return direction_[index(x, y)];
+  }
+
+  /**
+   * @brief タイルからゴールまでのコストを取得（直進10、斜め14）
+   * @return 到達できなければUNREACHABLE
+   */
+  Uint32 getCost(int x, int y) const {
+    if (!inBounds(x, y)) return UNREACHABLE;
+    return cost_[index(x, y)];
+  }
+
+  int getGoalX() const { return goal_x_; }
+  int getGoalY() const { return goal_y_; }
+
+  /**
+   * @brief 反映済みのタイルグリッドの版
+   */
+  Uint64 getVersion() const { return version_; }
+
+ private:
+  // 方向ごとの単位ベクトル（最後は向きなし）
+  static constexpr float DIAGONAL_UNIT = 0.70710678f;
+  static constexpr std::array<float, 9> DIRECTION_X = {
+      1.0f, 0.0f, -1.0f, 0.0f, DIAGONAL_UNIT, -DIAGONAL_UNIT, -DIAGONAL_UNIT, DIAGONAL_UNIT, 0.0f};
+  static constexpr std::array<float, 9> DIRECTION_Y = {
+      0.0f, 1.0f, 0.0f, -1.0f, DIAGONAL_UNIT, DIAGONAL_UNIT, -DIAGONAL_UNIT, -DIAGONAL_UNIT, 0.0f};
+
+  static constexpr int BUCKETS = 16;  // 1回の移動のコスト（最大14）より多いこと
+
+  /**
+   * @brief 広げ始めるタイル
+   */
+  struct Seed {
+    Uint32 cost;
+    int index;
+  };
+
+  bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+  int index(int x, int y) const { return (y + 1) * stride_ + x + 1; }
+  bool isGoalValid() const { return inBounds(goal_x_, goal_y_) && passable_[index(goal_x_, goal_y_)]; }
+
+  void copyPlacement(const TileGrid& grid) {
+    auto [origin_x, origin_y] = grid.getOrigin();
+    origin_x_ = origin_x;
+    origin_y_ = origin_y;
+    tile_width_ = grid.getTileWidth();
+    tile_height_ = grid.getTileHeight();
+  }
+
+  /**
+   * @brief タイルiから動ける方向のビットを作り直す（斜めは両隣が通れること）
+   */
+  void updateMoves(int i) {
+    if (!passable_[i]) {
+      moves_[i] = 0;
+      return;
+    }
+    unsigned moves = 0;
+    for (int d = 0; d < TileMove::COUNT; ++d) {
+      unsigned open = passable_[i + offsets_[d]];
+      if (d >= 4) open &= passable_[i + TileMove::DX[d]] & passable_[i + TileMove::DY[d] * stride_];
+      moves |= open << d;
+    }
+    moves_[i] = static_cast<Uint8>(moves);
+  }
+
+  void touch(int i) {
+    if (touched_flags_[i]) return;
+    touched_flags_[i] = 1;
+    touched_.push_back(i);
+  }
+
+  /**
+   * @brief seeds_（コストの昇順）からコストを広げる
+   *
+   * 処理中のコストをcとすると、キューにあるタイルのコストは常にc～c+14に収まるので、
+   * コストの下位4ビットでバケツを選べば取り出す順が保たれます。
+   * 開始点は自分のコストに達したときにキューに入れます。
+   */
+  void propagate() {
+    size_t next_seed = 0;
+    size_t queued = 0;
+    Uint32 current = seeds_.empty() ? 0 : seeds_.front().cost;
+    while (queued > 0 || next_seed < seeds_.size()) {
+      if (queued == 0) current = std::max(current, seeds_[next_seed].cost);
+      while (next_seed < seeds_.size() && seeds_[next_seed].cost == current) {
+        buckets_[current % BUCKETS].push_back(seeds_[next_seed++].index);
+        ++queued;
+      }
+      std::vector<int>& bucket = buckets_[current % BUCKETS];
+      // 移動のコストは10以上なので、処理中に同じバケツへ追加されることはない
+      for (int i : bucket) {
+        if (cost_[i] != current) continue;  // より小さいコストで処理済み
+        for (unsigned moves = moves_[i]; moves != 0; moves &= moves - 1) {
+          int d = std::countr_zero(moves);
+          int neighbor = i + offsets_[d];
+          Uint32 cost = current + TileMove::cost(d);
+          if (cost < cost_[neighbor]) {
+            cost_[neighbor] = cost;
+            buckets_[cost % BUCKETS].push_back(neighbor);
+            ++queued;
+            touch(neighbor);
+          }
+        }
+      }
+      queued -= bucket.size();
+      bucket.clear();
+      ++current;
+    }
+  }
+
+  /**
+   * @brief タイルの向きを、コストが最も小さくなる隣に向ける（同じなら直進を優先）
+   *
+   * 障害物の配置によって分岐の結果がばらつくので、比較は選択（条件演算子）で行います。
+   * 動けない方向はmoves_で除きます（枠のタイルは動ける方向がないので隣を読まない）。
+   */
+  void updateDirection(int i) {
+    Uint64 best_cost = UNREACHABLE;
+    unsigned best = TileMove::NONE;
+    const unsigned moves = moves_[i];
+    if (moves != 0 && cost_[i] != 0) {
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        Uint64 cost = static_cast<Uint64>(cost_[i + offsets_[d]]) + TileMove::cost(d);
+        cost = ((moves >> d) & 1) ? cost : UNREACHABLE;
+        bool better = cost < best_cost;
+        best_cost = better ? cost : best_cost;
+        best = better ? static_cast<unsigned>(d) : best;
+      }
+    }
+    direction_[i] = static_cast<Uint8>(best);
+  }
+
+  int goal_x_ = 0;  // ゴールのタイル
+  int goal_y_ = 0;
+  int width_ = 0;   // タイル数（横）
+  int height_ = 0;  // タイル数（縦）
+  int stride_ = 2;  // 枠を含めた1行の長さ
+  Uint64 version_ = 0;  // 反映済みのタイルグリッドの版
+  float origin_x_ = 0.0f;  // グリッドの左上のワールド座標
+  float origin_y_ = 0.0f;
+  float tile_width_ = 1.0f;   // タイルの大きさ（ピクセル）
+  float tile_height_ = 1.0f;
+  std::array<int, TileMove::COUNT> offsets_{};  // 方向ごとの隣の添字の差
+
+  // タイルごとの値（枠を含む、添字はindex()）
+  std::vector<Uint8> passable_;   // 通れるなら1
+  std::vector<Uint32> cost_;      // ゴールまでのコスト
+  std::vector<Uint8> direction_;  // 進む向き
+  std::vector<Uint8> moves_;      // 動ける方向のビット（ビットdが方向d）
+
+  // 作業用
+  std::array<std::vector<int>, BUCKETS> buckets_;  // コストの下位4ビットごとのキュー
+  std::vector<Seed> seeds_;          // 広げ始めるタイル
+  std::vector<int> changed_;         // 通れる／通れないが変わったタイル
+  std::vector<int> stack_;           // コストを消すタイル
+  std::vector<int> touched_;         // コストが変わったタイル
+  std::vector<Uint8> touched_flags_;  // touched_に入っているなら1
+};
+
+/**
+ * @brief ゴールごとのフローフィールドを持つキャッシュ
+ *
+ * 同じゴールへのフィールドは使い回し、タイルが変わっていれば差分だけ更新します。
+ * 持てる数を超えたら、最も長く使われていないフィールドを新しいゴールで作り直します
+ * （配列は再利用するので確保は起きません）。
+ *
+ * 使用例:
+ * @code
+ * FlowFieldCache flow_fields(tiles);
+ *
+ * // 毎ステップ: プレイヤーのいるタイルに向かうフィールド
+ * auto [goal_x, goal_y] = tiles.worldToTile(player_x, player_y);
+ * const FlowField& field = flow_fields.get(goal_x, goal_y);
+ * @endcode
+ */
+class FlowFieldCache {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param grid タイルグリッド（キャッシュより長く生存すること）
+   * @param capacity 同時に持つフィールドの数
+   */
+  explicit FlowFieldCache(const TileGrid& grid, size_t capacity = 8)
+      : grid_(grid), capacity_(std::max<size_t>(capacity, 1)) {}
+
+  FlowFieldCache(const FlowFieldCache&) = delete;
+  FlowFieldCache& operator=(const FlowFieldCache&) = delete;
+
+  /**
+   * @brief ゴールへのフィールドを取得（なければ作り、タイルが変わっていれば更新する）
+   * @param goal_x ゴールの列
+   * @param goal_y ゴールの行
+   * @return フィールド（次に別のゴールでget()を呼ぶまで有効）
+   */
+  const FlowField& get(int goal_x, int goal_y) {
+    ++use_counter_;
+    Entry* oldest = nullptr;
+    for (Entry& entry : entries_) {
+      if (entry.field->getGoalX() == goal_x && entry.field->getGoalY() == goal_y) {
+        entry.last_used = use_counter_;
+        entry.field->update(grid_);
+        return *entry.field;
+      }
+      if (!oldest || entry.last_used < oldest->last_used) oldest = &entry;
+    }
+    if (entries_.size() < capacity_) {
+      entries_.push_back(Entry{std::make_unique<FlowField>(), 0});
+      oldest = &entries_.back();
+    }
+    oldest->last_used = use_counter_;
+    oldest->field->build(grid_, goal_x, goal_y);
+    return *oldest->field;
+  }
+
+  /**
+   * @brief 持っているフィールドの数
+   */
+  size_t size() const { return entries_.size(); }
+
+  /**
+   * @brief すべてのフィールドを捨てる
+   */
+  void clear() { entries_.clear(); }
+
+ private:
+  struct Entry {
+    std::unique_ptr<FlowField> field;
+    Uint64 last_used;  // 最後にget()で返したときのuse_counter_
+  };
+
+  const TileGrid& grid_;
+  size_t capacity_;
+  std::vector<Entry> entries_;
+  Uint64 use_counter_ = 0;
+};
+
+/**
+ * @brief 経路探索の方法
+ */
+enum class PathSearch {
+  AStar,      // すべての隣を調べるA*
+  JumpPoint,  // 直線上の分岐のないタイルを飛ばすジャンプポイント探索（結果のコストはA*と同じ）
+};
+
+/**
+ * @brief タイルグリッド上の2点間の最短経路を求める（1回限りの問い合わせ用）
+ *
+ * 移動の規則とコストはFlowFieldと同じ（8方向、角を削らない）で、ヒューリスティックには
+ * 障害物がない場合のコスト（8方向の距離）を使います。
+ * ジャンプポイント探索の直進は、TileGridの行・列のビット列を64タイルずつ調べて
+ * 壁と分岐（横が開けるタイル）を探します。
+ *
+ * 作業用の配列を持ち回すので、同じインスタンスを使い続けると確保が起きません。
+ *
+ * 使用例:
+ * @code
+ * PathFinder finder;
+ * std::vector<std::pair<int, int>> path;
+ * if (finder.findPath(tiles, start_x, start_y, goal_x, goal_y, path)) {
+ *   // path[0]がスタート、path.back()がゴール（隣り合うタイルの並び）
+ * }
+ * @endcode
+ */
+class PathFinder {
+ public:
+  /**
+   * @brief 最短経路を求める
+   * @param grid タイルグリッド
+   * @param start_x スタートの列
+   * @param start_y スタートの行
+   * @param goal_x ゴールの列
+   * @param goal_y ゴールの行
+   * @param out_path スタートからゴールまでのタイル（両端を含み、隣り合うタイルの並び）
+   * @param search 探索の方法
+   * @return 経路が見つかった場合true（見つからなければout_pathは空）
+   */
+  bool findPath(const TileGrid& grid, int start_x, int start_y, int goal_x, int goal_y,
+                std::vector<std::pair<int, int>>& out_path,
+                PathSearch search = PathSearch::JumpPoint) {
+    Utilities::FrameProfiler::Scope scope("path_finder.search");
+    out_path.clear();
+    grid_ = &grid;
+    width_ = grid.getWidth();
+    goal_x_ = goal_x;
+    goal_y_ = goal_y;
+    if (!isOpen(start_x, start_y) || !isOpen(goal_x, goal_y)) return false;
+
+    const size_t size = static_cast<size_t>(width_) * grid.getHeight();
+    if (nodes_.size() != size) {
+      nodes_.assign(size, Node{});
+      search_id_ = 0;
+    }
+    if (++search_id_ == 0) {
+      // 一周したら印をすべて消す
+      std::fill(nodes_.begin(), nodes_.end(), Node{});
+      search_id_ = 1;
+    }
+    open_.clear();
+
+    const int start = start_y * width_ + start_x;
+    const int goal = goal_y * width_ + goal_x;
+    reach(start, -1, 0);
+    while (!open_.empty()) {
+      std::pop_heap(open_.begin(), open_.end(), OpenEntry::Greater{});
+      OpenEntry entry = open_.back();
+      open_.pop_back();
+      Node& node = nodes_[entry.index];
+      if (node.closed == search_id_ || entry.cost != node.cost) continue;
+      node.closed = search_id_;
+      if (entry.index == goal) {
+        buildPath(goal, out_path);
+        return true;
+      }
+      if (search == PathSearch::JumpPoint) {
+        expandJumpPoints(entry.index);
+      } else {
+        expandNeighbors(entry.index);
+      }
+    }
+    return false;
+  }
+
+ private:
+  /**
+   * @brief タイルごとの探索の状態（search_id_と一致する印だけが今回の探索のもの）
+   */
+  struct Node {
+    Uint32 opened = 0;  // コストを付けた探索の番号
+    Uint32 closed = 0;  // 確定した探索の番号
+    Uint32 cost = 0;    // スタートからのコスト
+    int parent = -1;    // 直前のタイル（ジャンプポイント探索では直前のジャンプポイント）
+  };
+
+  struct OpenEntry {
+    Uint32 estimate;  // コスト + ヒューリスティック
+    Uint32 cost;
+    int index;
+
+    // 推定値が同じなら、ゴールに近い（コストが大きい）方を先に取り出す
+    struct Greater {
+      bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+        if (a.estimate != b.estimate) return a.estimate > b.estimate;
+        return a.cost < b.cost;
+      }
+    };
+  };
+
+  bool isOpen(int x, int y) const {
+    return x >= 0 && y >= 0 && x < width_ && y < grid_->getHeight() && !grid_->isSolid(x, y);
+  }
+
+  bool canMove(int x, int y, int dx, int dy) const {
+    if (!isOpen(x + dx, y + dy)) return false;
+    return dx == 0 || dy == 0 || (isOpen(x + dx, y) && isOpen(x, y + dy));
+  }
+
+  /**
+   * @brief タイルにコストを付けてキューに入れる（より小さいコストが付いていれば何もしない）
+   */
+  void reach(int index, int parent, Uint32 cost) {
+    Node& node = nodes_[index];
+    if (node.closed == search_id_ || (node.opened == search_id_ && node.cost <= cost)) return;
+    node.opened = search_id_;
+    node.cost = cost;
+    node.parent = parent;
+    int x = index % width_;
+    int y = index / width_;
+    open_.push_back(OpenEntry{cost + TileMove::octile(goal_x_ - x, goal_y_ - y), cost, index});
+    std::push_heap(open_.begin(), open_.end(), OpenEntry::Greater{});
+  }
+
+  void expandNeighbors(int index) {
+    const int x = index % width_;
+    const int y = index / width_;
+    const Uint32 cost = nodes_[index].cost;
+    for (int d = 0; d < TileMove::COUNT; ++d) {
+      if (canMove(x, y, TileMove::DX[d], TileMove::DY[d])) {
+        reach(index + TileMove::DY[d] * width_ + TileMove::DX[d], index, cost + TileMove::cost(d));
+      }
+    }
+  }
+
+  /**
+   * @brief ジャンプポイントから、来た向きに応じて残す方向へ跳ぶ
+   */
+  void expandJumpPoints(int index) {
+    const int x = index % width_;
+    const int y = index / width_;
+    const int parent = nodes_[index].parent;
+
+    std::array<std::pair<int, int>, TileMove::COUNT> directions;
+    int count = 0;
+    auto add = [&](int dx, int dy) { directions[count++] = {dx, dy}; };
+    if (parent < 0) {
+      for (int d = 0; d < TileMove::COUNT; ++d) {
+        if (canMove(x, y, TileMove::DX[d], TileMove::DY[d])) add(TileMove::DX[d], TileMove::DY[d]);
+      }
+    } else {
+      const int dx = sign(x - parent % width_);
+      const int dy = sign(y - parent / width_);
+      if (dx != 0 && dy != 0) {
+        // 斜め: そのまま斜めと、その成分の直進
+        bool open_x = isOpen(x + dx, y);
+        bool open_y = isOpen(x, y + dy);
+        if (open_x) add(dx, 0);
+        if (open_y) add(0, dy);
+        if (open_x && open_y && isOpen(x + dx, y + dy)) add(dx, dy);
+      } else if (dx != 0) {
+        // 横: そのまま直進と、上下（開けた側への斜めも）
+        bool open_next = isOpen(x + dx, y);
+        bool open_up = isOpen(x, y - 1);
+        bool open_down = isOpen(x, y + 1);
+        if (open_next) {
+          add(dx, 0);
+          if (open_up && isOpen(x + dx, y - 1)) add(dx, -1);
+          if (open_down && isOpen(x + dx, y + 1)) add(dx, 1);
+        }
+        if (open_up) add(0, -1);
+        if (open_down) add(0, 1);
+      } else {
+        // 縦: 横と同じ（軸を入れ替える）
+        bool open_next = isOpen(x, y + dy);
+        bool open_left = isOpen(x - 1, y);
+        bool open_right = isOpen(x + 1, y);
+        if (open_next) {
+          add(0, dy);
+          if (open_left && isOpen(x - 1, y + dy)) add(-1, dy);
+          if (open_right && isOpen(x + 1, y + dy)) add(1, dy);
+        }
+        if (open_left) add(-1, 0);
+        if (open_right) add(1, 0);
+      }
+    }
+
+    const Uint32 cost = nodes_[index].cost;
+    for (int i = 0; i < count; ++i) {
+      auto [dx, dy] = directions[i];
+      int jump_x, jump_y;
+      if (jump(x + dx, y + dy, dx, dy, jump_x, jump_y)) {
+        reach(jump_y * width_ + jump_x, index, cost + TileMove::octile(jump_x - x, jump_y - y));
+      }
+    }
+  }
+
+  /**
+   * @brief (x, y)から(dx, dy)の向きに進み、次のジャンプポイントを探す
+   * @return 見つかった場合true（壁や範囲外で行き止まりならfalse）
+   */
+  bool jump(int x, int y, int dx, int dy, int& out_x, int& out_y) const {
+    if (dx == 0 || dy == 0) return jumpStraight(x, y, dx, dy, out_x, out_y);
+    while (isOpen(x, y)) {
+      int ignored_x, ignored_y;
+      if ((x == goal_x_ && y == goal_y_) || jumpStraight(x + dx, y, dx, 0, ignored_x, ignored_y) ||
+          jumpStraight(x, y + dy, 0, dy, ignored_x, ignored_y)) {
+        out_x = x;
+        out_y = y;
+        return true;
+      }
+      // 角を削らないので、両隣が通れなければ斜めに進めない
+      if (!isOpen(x + dx, y) || !isOpen(x, y + dy)) return false;
+      x += dx;
+      y += dy;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 直進のジャンプ（行または列のビット列を64タイルずつ調べる）
+   *
+   * 進む先で最初に現れる「通れないタイル」と「横のタイルが開けるタイル」
+   * （横が通れて、1つ手前の横が通れない）をビット演算でまとめて探します。
+   */
+  bool jumpStraight(int x, int y, int dx, int dy, int& out_x, int& out_y) const {
+    const bool horizontal = dy == 0;
+    const int line = horizontal ? y : x;
+    const int position = horizontal ? x : y;
+    const int direction = horizontal ? dx : dy;
+    const int length = horizontal ? width_ : grid_->getHeight();
+    const int lines = horizontal ? grid_->getHeight() : width_;
+    if (line < 0 || line >= lines || position < 0 || position >= length) return false;
+
+    auto bits_of = [&](int index) -> const Uint64* {
+      if (index < 0 || index >= lines) return nullptr;
+      return horizontal ? grid_->getRowBits(index) : grid_->getColumnBits(index);
+    };
+    const Uint64* blocked = bits_of(line);
+    const Uint64* side_a = bits_of(line - 1);
+    const Uint64* side_b = bits_of(line + 1);
+    const int words = horizontal ? grid_->getRowWordCount() : grid_->getColumnWordCount();
+    const int goal_line = horizontal ? goal_y_ : goal_x_;
+    const int goal_position = (goal_line == line) ? (horizontal ? goal_x_ : goal_y_) : -1;
+
+    // 範囲外（長さより先）のビットは通れないものとして扱う
+    auto word_at = [&](const Uint64* bits, int word) -> Uint64 {
+      if (!bits || word < 0 || word >= words) return ~Uint64{0};
+      Uint64 value = bits[word];
+      if (word == words - 1 && length % 64 != 0) value |= ~Uint64{0} << (length % 64);
+      return value;
+    };
+    auto found = [&](int at) {
+      out_x = horizontal ? at : line;
+      out_y = horizontal ? line : at;
+      return true;
+    };
+
+    if (direction > 0) {
+      for (int word = position / 64; word < words; ++word) {
+        // 横が開ける: 横が通れて、1つ手前（ビットの下位側）の横が通れない
+        Uint64 forced = 0;
+        for (const Uint64* side : {side_a, side_b}) {
+          Uint64 bits = word_at(side, word);
+          Uint64 before = (bits << 1) | (word_at(side, word - 1) >> 63);
+          forced |= ~bits & before;
+        }
+        Uint64 stops = word_at(blocked, word) | forced;
+        if (word == position / 64) stops &= ~Uint64{0} << (position % 64);
+        if (stops == 0) continue;
+        int at = word * 64 + std::countr_zero(stops);
+        if (goal_position >= position && goal_position <= at) return found(goal_position);
+        if ((word_at(blocked, word) >> (at % 64)) & 1) return false;
+        return found(at);
+      }
+    } else {
+      for (int word = position / 64; word >= 0; --word) {
+        // 横が開ける: 横が通れて、1つ手前（ビットの上位側）の横が通れない
+        Uint64 forced = 0;
+        for (const Uint64* side : {side_a, side_b}) {
+          Uint64 bits = word_at(side, word);
+          Uint64 before = (bits >> 1) | (word_at(side, word + 1) << 63);
+          forced |= ~bits & before;
+        }
+        Uint64 stops = word_at(blocked, word) | forced;
+        if (word == position / 64) stops &= ~Uint64{0} >> (63 - position % 64);
+        if (stops == 0) continue;
+        int at = word * 64 + 63 - std::countl_zero(stops);
+        if (goal_position >= at && goal_position <= position) return found(goal_position);
+        if ((word_at(blocked, word) >> (at % 64)) & 1) return false;
+        return found(at);
+      }
+    }
+    // 端まで壁も分岐もない
+    if (goal_position >= 0 && (direction > 0 ? goal_position >= position : goal_position <= position)) {
+      return found(goal_position);
+    }
+    return false;
+  }
+
+  /**
+   * @brief 親をたどって経路を作る（ジャンプポイントの間は1タイルずつ埋める）
+   */
+  void buildPath(int goal, std::vector<std::pair<int, int>>& out_path) const {
+    for (int index = goal; index >= 0; index = nodes_[index].parent) {
+      int x = index % width_;
+      int y = index / width_;
+      int parent = nodes_[index].parent;
+      if (parent < 0) {
+        out_path.emplace_back(x, y);
+        break;
+      }
+      int px = parent % width_;
+      int py = parent / width_;
+      int dx = sign(px - x);
+      int dy = sign(py - y);
+      for (; x != px || y != py; x += dx, y += dy) {
+        out_path.emplace_back(x, y);
+      }
+    }
+    std::reverse(out_path.begin(), out_path.end());
+  }
+
+  static int sign(int value) { return (value > 0) - (value < 0); }
+
+  const TileGrid* grid_ = nullptr;  // 探索中のグリッド
+  int width_ = 0;
+  int goal_x_ = 0;
+  int goal_y_ = 0;
+  Uint32 search_id_ = 0;   // 探索ごとに増える番号
+  std::vector<Node> nodes_;       // タイルごとの状態
+  std::vector<OpenEntry> open_;   // 優先度付きキュー（ヒープ）
+};
+
+/**
+ * @brief フローフィールドに沿って進むコンポーネント
+ *
+ * FlowFieldFollower::apply()が、フィールドの向きに速さを掛けた速度をVelocityMoveに設定します。
+ * 処理はゲーム側が登録するシステムがまとめて行います（Locator、VelocityMoveが必要）。
+ *
+ * 使用例:
+ * @code
+ * scheduler.addSystem<FlowFieldFollower, Locator, VelocityMove>(
+ *     "follow_flow_field", componentSignature<VelocityMove>(),
+ *     [this](Uint64, Entity&, FlowFieldFollower& follower, Locator& locator,
+ *            VelocityMove& velocity) { follower.apply(*field_, locator, velocity); });
+ * @endcode
+ *
+ * note: 座標はLocatorの値をそのままワールド座標として使います（親を持たないエンティティ向け）
+ */
+class FlowFieldFollower : public Component {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param speed 速さ（ピクセル/秒）
+   * @param offset_x フィールドを読む位置（Locatorの座標からのずれ、矩形なら中心を指す）
+   * @param offset_y
+   */
+  explicit FlowFieldFollower(float speed = 60.0f, float offset_x = 0.0f, float offset_y = 0.0f)
+      : speed_(speed), offset_x_(offset_x), offset_y_(offset_y) {}
+
+  // 移動中はVelocityMoveがエンティティを起こしておくので、それ自体は時間に依存しない
+  bool isTimeDependent() const override { return false; }
+
+  /**
+   * @brief フィールドの向きに進む速度を設定
+   * @param field 進む向きを読むフィールド（読むだけなので、複数のスレッドから呼べる）
+   * @param locator 座標
+   * @param velocity 書き換える速度（向きがなければ止まる）
+   */
+  void apply(const FlowField& field, const Locator& locator, VelocityMove& velocity) const {
+    auto [x, y] = locator.getPosition();
+    auto [dir_x, dir_y] = field.sample(x + offset_x_, y + offset_y_);
+    auto [vx, vy] = velocity.getVelocity();
+    float new_vx = dir_x * speed_;
+    float new_vy = dir_y * speed_;
+    if (new_vx != vx || new_vy != vy) {
+      velocity.setVelocity(new_vx, new_vy);
+    }
+  }
+
+  /**
+   * @brief 速さを設定
+   * @param speed 速さ（ピクセル/秒）
+   */
+  void setSpeed(float speed) {
+    speed_ = speed;
+    markChanged();
+  }
+
+  /**
+   * @brief 速さを取得
+   * @return 速さ（ピクセル/秒）
+   */
+  float getSpeed() const { return speed_; }
+
+  /**
+   * @brief フィールドを読む位置を取得
+   * @return Locatorの座標からのずれ {x, y}
+   */
+  std::pair<float, float> getOffset() const { return {offset_x_, offset_y_}; }
+
+ private:
+  float speed_;     // 速さ（ピクセル/秒）
+  float offset_x_;  // フィールドを読む位置（Locatorの座標からのずれ）
+  float offset_y_;
+};
+
+}  // namespace MyGame
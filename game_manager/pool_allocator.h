@@ -0,0 +1,231 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace MyGame {
+
+/**
+ * @brief 同じサイズのブロックをフリーリストで払い出すプール
+ *
+ * ブロックはチャンク単位でまとめて確保し、解放されたブロックはフリーリストに戻して再利用します。
+ * チャンク自体はプールが破棄されるまで解放しません（確保・解放を繰り返してもヒープを断片化させない）。
+ */
+class FixedBlockPool {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param block_size ブロックのサイズ（バイト、ポインタサイズ以上）
+   * @param blocks_per_chunk 1チャンクあたりのブロック数
+   */
+  FixedBlockPool(size_t block_size, size_t blocks_per_chunk)
+      : block_size_(block_size), blocks_per_chunk_(blocks_per_chunk) {}
+
+  FixedBlockPool(const FixedBlockPool&) = delete;
+  FixedBlockPool& operator=(const FixedBlockPool&) = delete;
+
+  /**
+   * @brief ブロックを1つ確保
+   * @return ブロックの先頭アドレス
+   */
+  void* allocate() {
+    if (!free_list_) {
+      addChunk();
+    }
+    FreeNode* node = free_list_;
+    free_list_ = node->next;
+    ++live_blocks_;
+    return node;
+  }
+
+  /**
+   * @brief ブロックをプールに返却
+   * @param block allocate()で確保したブロック
+   */
+  void deallocate(void* block) {
+    FreeNode* node = static_cast<FreeNode*>(block);
+    node->next = free_list_;
+    free_list_ = node;
+    --live_blocks_;
+  }
+
+  /**
+   * @brief 空きブロックが指定数以上になるまでチャンクを事前確保
+   * @param free_blocks 必要な空きブロック数
+   */
+  void reserve(size_t free_blocks) {
+    while (getCapacity() - live_blocks_ < free_blocks) {
+      addChunk();
+    }
+  }
+
+  /**
+   * @brief 使用中のブロック数を取得
+   */
+  size_t getLiveBlocks() const { return live_blocks_; }
+
+  /**
+   * @brief 確保済みのブロック数（チャンク数×チャンクあたりのブロック数）を取得
+   */
+  size_t getCapacity() const { return chunks_.size() * blocks_per_chunk_; }
+
+ private:
+  struct FreeNode {
+    FreeNode* next;
+  };
+
+  void addChunk() {
+    // new[]で確保した領域は__STDCPP_DEFAULT_NEW_ALIGNMENT__に揃っている
+    chunks_.push_back(std::make_unique<std::byte[]>(block_size_ * blocks_per_chunk_));
+    std::byte* base = chunks_.back().get();
+    // 先頭のブロックから使われるよう逆順に積む
+    for (size_t i = blocks_per_chunk_; i > 0; --i) {
+      FreeNode* node = reinterpret_cast<FreeNode*>(base + block_size_ * (i - 1));
+      node->next = free_list_;
+      free_list_ = node;
+    }
+  }
+
+  size_t block_size_;
+  size_t blocks_per_chunk_;
+  FreeNode* free_list_ = nullptr;                     // 空きブロックのリスト
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;  // 確保済みチャンク
+  size_t live_blocks_ = 0;                            // 使用中のブロック数
+};
+
+/**
+ * @brief サイズクラスごとのFixedBlockPoolに振り分けるアロケータ
+ *
+ * 要求サイズをALIGNMENT単位に切り上げ、対応するサイズクラスのプールから確保します。
+ * MAX_BLOCK_SIZEを超える要求は通常のoperator newに委譲します。
+ * Entity・Componentのoperator new/delete、およびPoolAllocatorから使用されます。
+ *
+ * note: スレッドセーフではありません（メインスレッドからのみ使用してください）
+ */
+class SizeClassAllocator {
+ public:
+  static constexpr size_t ALIGNMENT = 16;          // ブロックの境界（サイズクラスの刻み）
+  static constexpr size_t MAX_BLOCK_SIZE = 512;    // プールで扱う最大サイズ
+  static constexpr size_t BLOCKS_PER_CHUNK = 128;  // 1チャンクあたりのブロック数
+  static constexpr size_t CLASS_COUNT = MAX_BLOCK_SIZE / ALIGNMENT;
+
+  static_assert(ALIGNMENT <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                "Block alignment exceeds operator new alignment");
+
+  /**
+   * @brief 共有アロケータを取得
+   *
+   * note: 静的オブジェクトの破棄順序問題を避けるため、意図的に解放しません
+   */
+  static SizeClassAllocator& shared() {
+    static SizeClassAllocator* allocator = new SizeClassAllocator();
+    return *allocator;
+  }
+
+  /**
+   * @brief メモリを確保
+   * @param size 要求サイズ（バイト）
+   * @return 確保した領域（ALIGNMENT境界に揃っている）
+   */
+  void* allocate(size_t size) {
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+      return ::operator new(size);
+    }
+    return poolFor(size).allocate();
+  }
+
+  /**
+   * @brief メモリを解放
+   * @param block allocate()で確保した領域
+   * @param size 確保時と同じ要求サイズ（バイト）
+   */
+  void deallocate(void* block, size_t size) {
+    if (!block) {
+      return;
+    }
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+      ::operator delete(block);
+      return;
+    }
+    poolFor(size).deallocate(block);
+  }
+
+  /**
+   * @brief 指定サイズのブロックを事前確保
+   * @param size 要求サイズ（バイト）
+   * @param count 必要な空きブロック数
+   *
+   * 大量の生成（プレハブの一括生成など）の前に呼ぶと、途中でチャンクを追加せずに済みます。
+   * MAX_BLOCK_SIZEを超えるサイズの場合は何もしません。
+   */
+  void reserve(size_t size, size_t count) {
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+      return;
+    }
+    poolFor(size).reserve(count);
+  }
+
+  /**
+   * @brief 全サイズクラスの使用中ブロック数の合計を取得
+   */
+  size_t getLiveBlocks() const {
+    size_t total = 0;
+    for (const auto& pool : pools_) {
+      if (pool) total += pool->getLiveBlocks();
+    }
+    return total;
+  }
+
+ private:
+  SizeClassAllocator() = default;
+
+  FixedBlockPool& poolFor(size_t size) {
+    size_t index = (size + ALIGNMENT - 1) / ALIGNMENT - 1;
+    if (!pools_[index]) {
+      pools_[index] = std::make_unique<FixedBlockPool>(
+          (index + 1) * ALIGNMENT, BLOCKS_PER_CHUNK);
+    }
+    return *pools_[index];
+  }
+
+  std::array<std::unique_ptr<FixedBlockPool>, CLASS_COUNT> pools_;  // サイズクラス別プール
+};
+
+/**
+ * @brief SizeClassAllocatorを使うSTL互換アロケータ
+ * @tparam T 要素の型
+ *
+ * Entityの子リストやコンポーネント配列など、小さく頻繁に確保される
+ * コンテナのバッファをプールから確保するために使用します。
+ */
+template <typename T>
+struct PoolAllocator {
+  using value_type = T;
+
+  static_assert(alignof(T) <= SizeClassAllocator::ALIGNMENT,
+                "PoolAllocator does not support over-aligned types");
+
+  PoolAllocator() = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(SizeClassAllocator::shared().allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    SizeClassAllocator::shared().deallocate(p, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const { return true; }
+  template <typename U>
+  bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+}  // namespace MyGame
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "component_pool.h"
+#include "component_registry.h"
+#include "entity_manager.h"
+#include "pool_allocator.h"
+
+namespace MyGame {
+
+/**
+ * @brief エンティティの雛形（プレハブ）
+ *
+ * コンポーネント・状態フラグ・子エンティティの構成を一度だけ登録し、
+ * 同じ構成のエンティティをまとめて生成します。
+ * spawn()は必要なメモリ（エンティティ本体・コンポーネントのプール・各種配列）を
+ * 最初に一括で確保し、コンポーネントは型ごとに1回のループでプールへまとめてコピーしてから
+ * エンティティに組み立てます。
+ *
+ * 使用例:
+ * @code
+ * Prefab bullet(1);
+ * bullet.addComponent<Locator>(0.0f, 0.0f);
+ * bullet.addComponent<VelocityMove>(0.0f, -300.0f);
+ * bullet.addComponent<RectRenderer>(4.0f, 8.0f, SDL_Color{255, 255, 0, 255});
+ * bullet.setStateFlag(0, true);
+ *
+ * bullet.spawn(entity_manager, 10000, [](Entity& entity, size_t i) {
+ *   entity.getComponent<Locator>()->setPosition(i % 100 * 6.0f, i / 100 * 10.0f);
+ * });
+ * @endcode
+ */
+class Prefab {
+ public:
+  // 生成した各インスタンスを追加前に調整する関数（インスタンス、0から始まる通し番号）
+  using InitFunc = std::function<void(Entity&, size_t)>;
+
+  /**
+   * @brief コンストラクタ
+   * @param layer 生成するエンティティのレイヤー番号
+   */
+  explicit Prefab(int layer = 0) : layer_(layer) {}
+
+  Prefab(Prefab&&) = default;
+  Prefab& operator=(Prefab&&) = default;
+
+  /**
+   * @brief 雛形にコンポーネントを追加
+   * @tparam T コンポーネントの型（コピー構築できること）
+   * @param args コンストラクタ引数
+   * @return 雛形のコンポーネント（値の調整用）
+   *
+   * 同じ型を2回追加した場合は置き換えます。
+   */
+  template <typename T, typename... Args>
+  T& addComponent(Args&&... args) {
+    static_assert(std::is_copy_constructible_v<T>,
+                  "Prefab components must be copy constructible");
+    ComponentPrototype prototype;
+    prototype.id = componentTypeId<T>();
+    prototype.component = std::make_unique<T>(std::forward<Args>(args)...);
+    prototype.clone = [](const Component& source, size_t count, ComponentPtr* out,
+                         size_t stride) {
+      ComponentPool<T>::shared().makeCopies(static_cast<const T&>(source), count, out,
+                                            stride);
+    };
+    prototype.reserve = [](size_t count) {
+      ComponentPool<T>::shared().reserve(count);
+    };
+    T* raw = static_cast<T*>(prototype.component.get());
+
+    // 型ID順に保つ（生成時にEntityの配列へ末尾追加だけで済む）
+    auto it = std::lower_bound(
+        components_.begin(), components_.end(), prototype.id,
+        [](const ComponentPrototype& p, ComponentTypeId id) { return p.id < id; });
+    if (it != components_.end() && it->id == prototype.id) {
+      *it = std::move(prototype);
+    } else {
+      components_.insert(it, std::move(prototype));
+    }
+    return *raw;
+  }
+
+  /**
+   * @brief 雛形のコンポーネントを取得
+   * @tparam T コンポーネントの型
+   * @return 雛形のコンポーネント（存在しない場合はnullptr）
+   */
+  template <typename T>
+  T* getComponent() {
+    ComponentTypeId id = componentTypeId<T>();
+    for (auto& prototype : components_) {
+      if (prototype.id == id) {
+        return static_cast<T*>(prototype.component.get());
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief 雛形の状態フラグを設定
+   * @param index フラグのインデックス（0～Entity::MAX_STATE_FLAGS-1）
+   * @param set trueで立てる、falseで下ろす
+   */
+  void setStateFlag(size_t index, bool set) {
+    Entity::StateFlagBits bit = Entity::StateFlagBits{1} << index;
+    state_flags_ = set ? (state_flags_ | bit) : (state_flags_ & ~bit);
+  }
+
+  /**
+   * @brief 子の雛形を追加
+   * @param child 子の雛形
+   * @return 追加した子の雛形（値の調整用）
+   */
+  Prefab& addChild(Prefab child) {
+    children_.push_back(std::move(child));
+    return children_.back();
+  }
+
+  /**
+   * @brief インスタンスを1つ生成（EntityManagerには追加しない）
+   * @return 生成したエンティティ
+   *
+   * コマンドバッファ経由で追加したい場合などに使います。
+   */
+  std::unique_ptr<Entity> instantiate() const {
+    std::vector<std::unique_ptr<Entity>> entities;
+    instantiateMany(1, entities);
+    return std::move(entities.front());
+  }
+
+  /**
+   * @brief インスタンスをまとめて生成（EntityManagerには追加しない）
+   * @param count 生成数
+   * @param out 生成したエンティティの追加先
+   *
+   * コンポーネントは型ごとに1回のループでcount個分をプールへコピーし、
+   * その後で各エンティティへ型ID順に割り当てます（子の雛形も同様に型ごとにまとめて生成）。
+   */
+  void instantiateMany(size_t count, std::vector<std::unique_ptr<Entity>>& out) const {
+    if (count == 0) return;
+
+    // 型ごとのパス: staging[i * 型数 + k] に、i番目のインスタンスのk番目のコンポーネントを置く
+    const size_t type_count = components_.size();
+    std::vector<ComponentPtr> staging(count * type_count);
+    for (size_t k = 0; k < type_count; ++k) {
+      const ComponentPrototype& prototype = components_[k];
+      prototype.clone(*prototype.component, count, staging.data() + k, type_count);
+    }
+
+    std::vector<std::unique_ptr<Entity>> children;
+    if (!children_.empty()) {
+      children.reserve(count * children_.size());
+      for (const auto& child : children_) {
+        child.instantiateMany(count, children);  // 子の雛形ごとにcount個ずつ並ぶ
+      }
+    }
+
+    out.reserve(out.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+      auto entity = std::make_unique<Entity>(layer_);
+      for (size_t index = 0; index < Entity::MAX_STATE_FLAGS; ++index) {
+        if ((state_flags_ >> index) & 1) {
+          entity->setStateFlag(index, true);
+        }
+      }
+
+      entity->reserveComponents(type_count);
+      for (size_t k = 0; k < type_count; ++k) {
+        ComponentPtr& component = staging[i * type_count + k];
+        component->setChangedTick(0);  // 雛形の変更記録は引き継がない
+        entity->addComponentById(components_[k].id, std::move(component));
+      }
+
+      entity->reserveChildren(children_.size());
+      for (size_t c = 0; c < children_.size(); ++c) {
+        entity->addChild(std::move(children[c * count + i]));
+      }
+      out.push_back(std::move(entity));
+    }
+  }
+
+  /**
+   * @brief インスタンスを一括生成してEntityManagerに追加
+   * @param manager 追加先のEntityManager
+   * @param count 生成数
+   * @param init 各インスタンスを追加前に調整する関数（nullptr可）
+   * @param parent 親エンティティ（nullptrならroot）
+   * @param out_handles 生成したエンティティのハンドルの追加先（nullptr可）
+   *
+   * 生成前に、count個分のエンティティ本体・コンポーネント・配列のメモリを
+   * 種類ごとにまとめて確保し、SPAWN_BATCH個ずつinstantiateMany()で組み立てます。
+   * note: EntityManager::addEntity()と同じく、updateAll()の走査中には呼ばないでください
+   * （その場合はinstantiate()とcommands().spawn()を使ってください）
+   */
+  void spawn(EntityManager& manager, size_t count, const InitFunc& init = nullptr,
+             Entity* parent = nullptr,
+             std::vector<EntityHandle>* out_handles = nullptr) const {
+    if (count == 0) return;
+
+    reserve(count);
+    manager.reserveEntities(count * getEntityCount());
+    Entity* target = parent ? parent : manager.getRoot();
+    target->reserveChildren(target->getChildren().size() + count);
+    if (out_handles) {
+      out_handles->reserve(out_handles->size() + count);
+    }
+
+    std::vector<std::unique_ptr<Entity>> batch;
+    for (size_t first = 0; first < count; first += SPAWN_BATCH) {
+      size_t batch_count = std::min(SPAWN_BATCH, count - first);
+      batch.clear();
+      instantiateMany(batch_count, batch);
+      for (size_t i = 0; i < batch_count; ++i) {
+        if (init) {
+          init(*batch[i], first + i);
+        }
+        EntityHandle handle = manager.addEntityTo(target, std::move(batch[i]));
+        if (out_handles) {
+          out_handles->push_back(handle);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief count個のインスタンス分のメモリを事前確保
+   * @param count 生成予定のインスタンス数
+   */
+  void reserve(size_t count) const {
+    Reservation reservation;
+    collectReservation(count, reservation);
+
+    for (const auto& [size, blocks] : reservation.blocks) {
+      SizeClassAllocator::shared().reserve(size, blocks);
+    }
+    for (ComponentTypeId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+      if (reservation.component_counts[id] > 0) {
+        reservation.component_reserve[id](reservation.component_counts[id]);
+      }
+    }
+  }
+
+  /**
+   * @brief 1インスタンスあたりのエンティティ数（自身と子孫）を取得
+   */
+  size_t getEntityCount() const {
+    size_t total = 1;
+    for (const auto& child : children_) {
+      total += child.getEntityCount();
+    }
+    return total;
+  }
+
+ private:
+  // spawn()で一度に組み立てる数（型ごとの一時配列が大きくなりすぎないようにする）
+  static constexpr size_t SPAWN_BATCH = 1024;
+
+  struct ComponentPrototype {
+    ComponentTypeId id = 0;
+    std::unique_ptr<Component> component;  // 雛形（コピー元）
+    // 型ごとのプールへcount個まとめてコピー（out[0], out[stride], ...へ書き込む）
+    void (*clone)(const Component&, size_t, ComponentPtr*, size_t) = nullptr;
+    void (*reserve)(size_t) = nullptr;     // 型ごとのプールの事前確保
+  };
+
+  /**
+   * @brief 事前確保する量の集計（子の雛形の分も合算する）
+   */
+  struct Reservation {
+    std::map<size_t, size_t> blocks;  // サイズクラスごとのブロック数（キーは切り上げたサイズ）
+    std::array<size_t, MAX_COMPONENT_TYPES> component_counts{};  // 型ごとのコンポーネント数
+    std::array<void (*)(size_t), MAX_COMPONENT_TYPES> component_reserve{};  // 型ごとの確保関数
+
+    void addBlocks(size_t size, size_t count) {
+      if (size == 0 || count == 0) return;
+      size_t rounded = (size + SizeClassAllocator::ALIGNMENT - 1) /
+                       SizeClassAllocator::ALIGNMENT * SizeClassAllocator::ALIGNMENT;
+      blocks[rounded] += count;
+    }
+  };
+
+  void collectReservation(size_t count, Reservation& reservation) const {
+    // エンティティ本体と、コンポーネント・子の配列のバッファ
+    reservation.addBlocks(sizeof(Entity), count);
+    reservation.addBlocks(sizeof(ComponentPtr) * components_.size(), count);
+    reservation.addBlocks(sizeof(std::unique_ptr<Entity>) * children_.size(), count);
+
+    for (const auto& prototype : components_) {
+      reservation.component_counts[prototype.id] += count;
+      reservation.component_reserve[prototype.id] = prototype.reserve;
+    }
+    for (const auto& child : children_) {
+      child.collectReservation(count, reservation);
+    }
+  }
+
+  int layer_;                                 // レイヤー番号
+  Entity::StateFlagBits state_flags_ = 0;     // 状態フラグ
+  std::vector<ComponentPrototype> components_;  // コンポーネントの雛形（型ID順）
+  std::vector<Prefab> children_;              // 子の雛形
+};
+
+}  // namespace MyGame
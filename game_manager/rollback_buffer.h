@@ -0,0 +1,405 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include "component_registry.h"
+#include "entity_handle.h"
+#include "entity_manager.h"
+
+namespace MyGame {
+
+/**
+ * @brief ロールバックで保存するコンポーネントの状態
+ * @tparam T コンポーネントの型
+ *
+ * 型ごとに、保存する値（State）と読み書きの方法を定義します。
+ * ALWAYS_CAPTUREがtrueの型は、セッターを通さずに毎フレーム変わる値を持つため、
+ * 差分フレームでも全件を保存します。
+ */
+template <typename T>
+struct RollbackState;
+
+template <>
+struct RollbackState<Locator> {
+  struct State {
+    float x, y;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const Locator& c) { return {c.getX(), c.getY()}; }
+  static void write(Locator& c, const State& s) { c.setPosition(s.x, s.y); }
+};
+
+template <>
+struct RollbackState<Rotater> {
+  struct State {
+    float angle;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const Rotater& c) { return {c.getAngle()}; }
+  static void write(Rotater& c, const State& s) { c.setAngle(s.angle); }
+};
+
+template <>
+struct RollbackState<Scaler> {
+  struct State {
+    float scale_x, scale_y;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const Scaler& c) { return {c.getScaleX(), c.getScaleY()}; }
+  static void write(Scaler& c, const State& s) { c.setScale(s.scale_x, s.scale_y); }
+};
+
+template <>
+struct RollbackState<VelocityMove> {
+  struct State {
+    float vx, vy;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const VelocityMove& c) {
+    auto [vx, vy] = c.getVelocity();
+    return {vx, vy};
+  }
+  static void write(VelocityMove& c, const State& s) { c.setVelocity(s.vx, s.vy); }
+};
+
+template <>
+struct RollbackState<AngularVelocity> {
+  struct State {
+    float angular_velocity;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const AngularVelocity& c) { return {c.getAngularVelocity()}; }
+  static void write(AngularVelocity& c, const State& s) {
+    c.setAngularVelocity(s.angular_velocity);
+  }
+};
+
+template <>
+struct RollbackState<DirectionComponent> {
+  struct State {
+    Direction direction;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const DirectionComponent& c) { return {c.getDirection()}; }
+  static void write(DirectionComponent& c, const State& s) { c.setDirection(s.direction); }
+};
+
+template <>
+struct RollbackState<SpriteRenderer> {
+  struct State {
+    int tile_x, tile_y;
+    bool flip_horizontal;
+  };
+  static constexpr bool ALWAYS_CAPTURE = false;
+  static State read(const SpriteRenderer& c) {
+    auto [tile_x, tile_y] = c.getTile();
+    return {tile_x, tile_y, c.isFlipHorizontal()};
+  }
+  static void write(SpriteRenderer& c, const State& s) {
+    c.setTile(s.tile_x, s.tile_y);
+    c.setFlipHorizontal(s.flip_horizontal);
+  }
+};
+
+template <>
+struct RollbackState<DirectionalSpriteAnimator> {
+  struct State {
+    Direction applied_direction;
+  };
+  // 反映済みの向きはstep()の中で書き換わる（変更記録なし）
+  static constexpr bool ALWAYS_CAPTURE = true;
+  static State read(const DirectionalSpriteAnimator& c) { return {c.getAppliedDirection()}; }
+  static void write(DirectionalSpriteAnimator& c, const State& s) {
+    c.setAppliedDirection(s.applied_direction);
+  }
+};
+
+template <>
+struct RollbackState<SpriteAnimator> {
+  struct State {
+    size_t current_frame;
+    Uint64 timer;
+  };
+  // タイマーはstep()の中で毎フレーム進む（変更記録なし）
+  static constexpr bool ALWAYS_CAPTURE = true;
+  static State read(const SpriteAnimator& c) { return {c.getCurrentFrame(), c.getTimer()}; }
+  static void write(SpriteAnimator& c, const State& s) {
+    c.setPlaybackPosition(s.current_frame, s.timer);
+  }
+};
+
+/**
+ * @brief ロールバックで保存する組み込みコンポーネントの一覧
+ *
+ * シミュレーションで値が変わるものだけを対象にします（描画サイズや色などの見た目の設定は含まない）。
+ */
+using RollbackComponentTypes =
+    ComponentTypeList<Locator, Rotater, Scaler, VelocityMove, AngularVelocity,
+                      DirectionComponent, SpriteRenderer, DirectionalSpriteAnimator,
+                      SpriteAnimator>;
+
+/**
+ * @brief 直近Nフレーム分のワールドの状態を保持するリングバッファ
+ *
+ * 毎フレームcapture()で状態を記録し、restore()で任意の記録済みティックに戻します。
+ * 巻き戻し、ネットワークのロールバック、デバッグ用です。
+ *
+ * keyframe_intervalフレームごとに全件を保存するキーフレームを作り、その間のフレームは
+ * 前回の記録から変更されたコンポーネントだけを保存します（EntityManager::forEachChanged()）。
+ * 復元は直前のキーフレームから対象フレームまでの記録を順に書き戻します。
+ *
+ * 対象はRollbackComponentTypesのコンポーネントの値のみです。
+ * エンティティの生成・削除は巻き戻りません（記録時に存在し、現在も生存しているエンティティだけを復元します）。
+ *
+ * 使用例:
+ * @code
+ * RollbackBuffer rollback(60);
+ * // 毎フレーム
+ * entity_manager.updateAll(delta_time);
+ * rollback.capture(entity_manager, ++tick);
+ * // 巻き戻し
+ * if (rollback.restore(entity_manager, tick - 10)) tick -= 10;
+ * @endcode
+ */
+class RollbackBuffer {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param capacity 保持するフレーム数
+   * @param keyframe_interval キーフレームの間隔（フレーム数、capacity以下）
+   */
+  explicit RollbackBuffer(size_t capacity = 60, size_t keyframe_interval = 30)
+      : frames_(std::max<size_t>(capacity, 1)),
+        keyframe_interval_(std::clamp<size_t>(keyframe_interval, 1, frames_.size())) {}
+
+  /**
+   * @brief 現在のワールドの状態を記録
+   * @param manager 記録するEntityManager
+   * @param tick このフレームのティック（前回より大きいこと）
+   *
+   * 最も古いフレームを上書きします。各フレームのバッファは再利用されるため、
+   * 定常状態では確保が起きません。
+   */
+  void capture(EntityManager& manager, Uint64 tick) {
+    if (count_ > 0 && tick <= newestFrame().tick) {
+      SDL_Log("RollbackBuffer: tick %llu is not newer than the last captured tick",
+              static_cast<unsigned long long>(tick));
+      return;
+    }
+
+    // 別のEntityManagerに切り替わった場合は変更記録の位置が使えないのでキーフレームにする
+    bool keyframe = force_keyframe_ || manager_ != &manager ||
+                    frames_since_keyframe_ + 1 >= keyframe_interval_;
+    manager_ = &manager;
+    force_keyframe_ = false;
+    frames_since_keyframe_ = keyframe ? 0 : frames_since_keyframe_ + 1;
+
+    // 末尾に1フレーム追加（満杯なら最も古いフレームを上書き）
+    size_t index = (head_ + count_) % frames_.size();
+    if (count_ == frames_.size()) {
+      head_ = (head_ + 1) % frames_.size();
+    } else {
+      ++count_;
+    }
+    Frame& frame = frames_[index];
+    frame.tick = tick;
+    frame.keyframe = keyframe;
+    captureTracks(manager, frame, RollbackComponentTypes{});
+  }
+
+  /**
+   * @brief 記録済みのティックの状態に戻す
+   * @param manager 書き戻すEntityManager（capture()と同じもの）
+   * @param tick 戻すティック
+   * @return 成功した場合true（記録が残っていない場合false）
+   *
+   * 戻したティックより新しい記録は破棄されます（以降のcapture()はそこから続く）。
+   */
+  bool restore(EntityManager& manager, Uint64 tick) {
+    if (manager_ != &manager) {
+      SDL_Log("RollbackBuffer: restore() called with a different EntityManager");
+      return false;
+    }
+
+    // 対象フレームと、その直前のキーフレームを探す
+    size_t target = count_;
+    for (size_t i = 0; i < count_; ++i) {
+      if (frameAt(i).tick == tick) {
+        target = i;
+        break;
+      }
+    }
+    if (target == count_) {
+      return false;
+    }
+    size_t keyframe = target + 1;
+    for (size_t i = target + 1; i > 0; --i) {
+      if (frameAt(i - 1).keyframe) {
+        keyframe = i - 1;
+        break;
+      }
+    }
+    if (keyframe > target) {
+      return false;  // キーフレームが上書き済み
+    }
+
+    for (size_t i = keyframe; i <= target; ++i) {
+      applyTracks(manager, frameAt(i), RollbackComponentTypes{});
+    }
+
+    // 対象より新しいフレームを破棄
+    count_ = target + 1;
+    frames_since_keyframe_ = target - keyframe;
+    return true;
+  }
+
+  /**
+   * @brief 指定したティックに戻せるかどうか
+   * @param tick ティック
+   */
+  bool canRestore(Uint64 tick) const {
+    bool seen_keyframe = false;
+    for (size_t i = 0; i < count_; ++i) {
+      const Frame& frame = frameAt(i);
+      seen_keyframe = seen_keyframe || frame.keyframe;
+      if (frame.tick == tick) return seen_keyframe;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 戻せる最も古いティックを取得
+   * @return ティック（戻せるフレームがない場合は0）
+   */
+  Uint64 getOldestRestorableTick() const {
+    for (size_t i = 0; i < count_; ++i) {
+      if (frameAt(i).keyframe) return frameAt(i).tick;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief 最後に記録したティックを取得
+   * @return ティック（記録がない場合は0）
+   */
+  Uint64 getNewestTick() const { return count_ > 0 ? newestFrame().tick : 0; }
+
+  /**
+   * @brief 記録しているフレーム数を取得
+   */
+  size_t getFrameCount() const { return count_; }
+
+  /**
+   * @brief 記録用に確保しているメモリ量を取得
+   * @return バイト数（各フレームのバッファの容量の合計）
+   */
+  size_t getMemoryUsage() const {
+    size_t total = 0;
+    for (const Frame& frame : frames_) {
+      std::apply([&total](const auto&... tracks) {
+        ((total += tracks.handles.capacity() * sizeof(EntityHandle) +
+                   tracks.states.capacity() * sizeof(tracks.states[0])), ...);
+      }, frame.tracks);
+    }
+    return total;
+  }
+
+  /**
+   * @brief すべての記録を破棄
+   */
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+    force_keyframe_ = true;
+  }
+
+ private:
+  /**
+   * @brief 1つの型の記録（ハンドルと状態の並列配列）
+   */
+  template <typename T>
+  struct Track {
+    std::vector<EntityHandle> handles;
+    std::vector<typename RollbackState<T>::State> states;
+  };
+
+  template <typename... Ts>
+  static std::tuple<Track<Ts>...> makeTracks(ComponentTypeList<Ts...>);
+
+  /**
+   * @brief 1フレーム分の記録
+   */
+  struct Frame {
+    Uint64 tick = 0;
+    bool keyframe = false;  // 全件を保存したフレームか
+    decltype(makeTracks(RollbackComponentTypes{})) tracks;
+  };
+
+  const Frame& frameAt(size_t i) const { return frames_[(head_ + i) % frames_.size()]; }
+  const Frame& newestFrame() const { return frameAt(count_ - 1); }
+
+  template <typename... Ts>
+  void captureTracks(EntityManager& manager, Frame& frame, ComponentTypeList<Ts...>) {
+    size_t type_index = 0;
+    (captureTrack<Ts>(manager, frame, type_index++), ...);
+  }
+
+  template <typename T>
+  void captureTrack(EntityManager& manager, Frame& frame, size_t type_index) {
+    using Traits = RollbackState<T>;
+    Track<T>& track = std::get<Track<T>>(frame.tracks);
+    track.handles.clear();
+    track.states.clear();
+
+    auto record = [&track](Entity& entity, T& component) {
+      track.handles.push_back(entity.getHandle());
+      track.states.push_back(Traits::read(component));
+    };
+
+    if (frame.keyframe || Traits::ALWAYS_CAPTURE) {
+      manager.view<T>().each(record);
+      // 次の差分の起点を今の時点に進める
+      change_cursors_[type_index] = manager.template forEachChanged<T>(
+          change_cursors_[type_index], [](Entity&, T&) {});
+    } else {
+      change_cursors_[type_index] =
+          manager.template forEachChanged<T>(change_cursors_[type_index], record);
+    }
+  }
+
+  template <typename... Ts>
+  static void applyTracks(EntityManager& manager, const Frame& frame,
+                          ComponentTypeList<Ts...>) {
+    (applyTrack<Ts>(manager, frame), ...);
+  }
+
+  template <typename T>
+  static void applyTrack(EntityManager& manager, const Frame& frame) {
+    const Track<T>& track = std::get<Track<T>>(frame.tracks);
+    for (size_t i = 0; i < track.handles.size(); ++i) {
+      Entity* entity = manager.resolve(track.handles[i]);
+      if (!entity) continue;  // 記録後に削除されたエンティティ
+      if (T* component = entity->getComponent<T>()) {
+        RollbackState<T>::write(*component, track.states[i]);
+      }
+    }
+  }
+
+  static constexpr size_t TYPE_COUNT = detail::countComponentTypes(RollbackComponentTypes{});
+
+  std::vector<Frame> frames_;  // リングバッファ
+  size_t head_ = 0;            // 最も古いフレームの位置
+  size_t count_ = 0;           // 記録しているフレーム数
+  size_t keyframe_interval_;   // キーフレームの間隔
+  size_t frames_since_keyframe_ = 0;  // 最後のキーフレームからのフレーム数
+  bool force_keyframe_ = true;        // 次の記録をキーフレームにする
+  EntityManager* manager_ = nullptr;  // 記録対象（非所有）
+  std::array<Uint64, TYPE_COUNT> change_cursors_{};  // 型ごとの変更記録の読み出し位置
+};
+
+}  // namespace MyGame
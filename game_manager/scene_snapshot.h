@@ -0,0 +1,827 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "component_pool.h"
+#include "entity_manager.h"
+#include "pool_allocator.h"
+
+namespace MyGame {
+
+/**
+ * @brief エンティティツリーのバイナリスナップショット
+ *
+ * エンティティの階層・レイヤー・状態フラグと、組み込みコンポーネントの値を
+ * バージョン付きのバイナリ形式で保存・復元します。
+ *
+ * フォーマット（リトルエンディアン前提、各ブロックは4バイト境界）:
+ * - Header
+ * - EntityRecord × entity_count（幅優先順。親の添字は常に自身より小さい）
+ * - Section × section_count（SectionHeader + 固定長レコード × count）
+ *
+ * コンポーネントは型ごとのセクションに固定長レコードとしてまとめて並べます。
+ * 可変長データ（フレームリスト・文字列）は先頭のBlobセクションに詰め、レコードからはオフセットで参照します。
+ * 復元はバイト列を先頭から1回走査するだけなので、メモリマップしたファイルを
+ * restoreFrom()に直接渡すこともできます。
+ *
+ * 復元では、セクションごとにコンポーネントのプールを事前確保してから、レコードごとに
+ * emplaceComponent()で作ります（コンストラクタでの値の補正と変更の記録を通すため、
+ * プールへの一括コピーはしません）。範囲外の添字や列挙値を含むスナップショットは、
+ * 何も追加せずに失敗します。
+ *
+ * 保存されないもの:
+ * - 組み込み以外のコンポーネント、Entityの派生クラス（通常のEntityとして復元される）
+ * - TextRendererのテキストプロバイダー（保存時点のテキストのみ）
+ * - SpriteRendererのテクスチャ（TextureToId/IdToTextureで番号に置き換える）
+ *
+ * 使用例:
+ * @code
+ * SceneSnapshot snapshot;
+ * snapshot.capture(*entity_manager.getRoot());  // メインスレッドで（バッファへのコピーのみ）
+ * snapshot.saveToFile("save.bin");              // ファイル書き込みはワーカースレッドでも可
+ * ...
+ * SceneSnapshot loaded;
+ * if (loaded.loadFromFile("save.bin")) {
+ *   entity_manager.clear();
+ *   loaded.restore(entity_manager);
+ * }
+ * @endcode
+ */
+class SceneSnapshot {
+ public:
+  static constexpr Uint32 MAGIC = 0x53534D47;  // "GMSS"
+  static constexpr Uint32 VERSION = 1;
+
+  // テクスチャと保存用の番号の対応（保存時・復元時）
+  using TextureToId = std::function<Uint32(SDL_Texture*)>;
+  using IdToTexture = std::function<SDL_Texture*(Uint32)>;
+
+  /**
+   * @brief エンティティツリーを保存
+   * @param root 保存するツリーの根（根自身は含まず、子孫のみを保存）
+   * @param texture_to_id テクスチャを番号に変換する関数（nullptrなら0）
+   *
+   * 作業用バッファは再利用されるため、毎フレーム保存しても定常状態では確保が起きません。
+   */
+  void capture(const Entity& root, const TextureToId& texture_to_id = nullptr) {
+    clearScratch();
+
+    // 幅優先で添字を振る（親が必ず先に来る）
+    scratch_.entities.push_back(&root);
+    scratch_.parents.push_back(NO_PARENT);
+    for (size_t i = 0; i < scratch_.entities.size(); ++i) {
+      const Entity* entity = scratch_.entities[i];
+      // 根は保存しないので、根の子の親はNO_PARENT、それ以外は1つずらした添字
+      Uint32 parent = i == 0 ? NO_PARENT : static_cast<Uint32>(i - 1);
+      for (const auto& child : entity->getChildren()) {
+        scratch_.entities.push_back(child.get());
+        scratch_.parents.push_back(parent);
+      }
+    }
+
+    for (size_t i = 1; i < scratch_.entities.size(); ++i) {
+      captureEntity(*scratch_.entities[i], static_cast<Uint32>(i - 1),
+                    scratch_.parents[i], texture_to_id);
+    }
+
+    // バッファに書き出す
+    data_.clear();
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.entity_count = static_cast<Uint32>(scratch_.records.size());
+    appendBytes(&header, sizeof(header));
+    appendBytes(scratch_.records.data(), sizeof(EntityRecord) * scratch_.records.size());
+
+    Uint32 section_count = 0;
+    appendBlob(scratch_.blob, section_count);
+    appendSection(SectionType::Locator, scratch_.locators, section_count);
+    appendSection(SectionType::Rotater, scratch_.rotaters, section_count);
+    appendSection(SectionType::Scaler, scratch_.scalers, section_count);
+    appendSection(SectionType::VelocityMove, scratch_.velocities, section_count);
+    appendSection(SectionType::AngularVelocity, scratch_.angular_velocities, section_count);
+    appendSection(SectionType::RectRenderer, scratch_.rects, section_count);
+    appendSection(SectionType::RotatedRectRenderer, scratch_.rotated_rects, section_count);
+    appendSection(SectionType::UIAnchor, scratch_.anchors, section_count);
+    appendSection(SectionType::TextRenderer, scratch_.texts, section_count);
+    appendSection(SectionType::Direction, scratch_.directions, section_count);
+    appendSection(SectionType::SpriteRenderer, scratch_.sprites, section_count);
+    appendSection(SectionType::DirectionalSpriteAnimator, scratch_.directional_animators,
+                  section_count);
+    appendSection(SectionType::SpriteAnimator, scratch_.animators, section_count);
+    appendSection(SectionType::Collider, scratch_.colliders, section_count);
+
+    // セクション数はヘッダーに後から書き込む
+    header.section_count = section_count;
+    std::memcpy(data_.data(), &header, sizeof(header));
+  }
+
+  /**
+   * @brief スナップショットからエンティティを復元してEntityManagerに追加
+   * @param manager 追加先のEntityManager
+   * @param parent 復元したツリーの親（nullptrならroot）
+   * @param id_to_texture 番号をテクスチャに変換する関数（nullptrならテクスチャなし）
+   * @param out_handles 最上位のエンティティのハンドルの追加先（nullptr可）
+   * @return 成功した場合true
+   */
+  bool restore(EntityManager& manager, Entity* parent = nullptr,
+               const IdToTexture& id_to_texture = nullptr,
+               std::vector<EntityHandle>* out_handles = nullptr) const {
+    return restoreFrom(data_.data(), data_.size(), manager, parent, id_to_texture,
+                       out_handles);
+  }
+
+  /**
+   * @brief バイト列からエンティティを復元してEntityManagerに追加
+   * @param data スナップショットのバイト列（メモリマップしたファイルなど）
+   * @param size バイト数
+   * @param manager 追加先のEntityManager
+   * @param parent 復元したツリーの親（nullptrならroot）
+   * @param id_to_texture 番号をテクスチャに変換する関数（nullptrならテクスチャなし）
+   * @param out_handles 最上位のエンティティのハンドルの追加先（nullptr可）
+   * @return 成功した場合true（失敗した場合、EntityManagerには何も追加されない）
+   */
+  static bool restoreFrom(const void* data, size_t size, EntityManager& manager,
+                          Entity* parent = nullptr,
+                          const IdToTexture& id_to_texture = nullptr,
+                          std::vector<EntityHandle>* out_handles = nullptr) {
+    Reader reader{static_cast<const std::byte*>(data), size};
+
+    Header header;
+    if (!reader.read(header)) {
+      SDL_Log("Scene snapshot is too small");
+      return false;
+    }
+    if (header.magic != MAGIC) {
+      SDL_Log("Invalid scene snapshot (bad magic)");
+      return false;
+    }
+    if (header.version != VERSION) {
+      SDL_Log("Unsupported scene snapshot version: %u", header.version);
+      return false;
+    }
+
+    // エンティティ本体（階層の接続は最後に行う）
+    Uint32 entity_count = header.entity_count;
+    const std::byte* entity_records = reader.skip(sizeof(EntityRecord) * entity_count);
+    if (!entity_records) {
+      SDL_Log("Scene snapshot is truncated (entities)");
+      return false;
+    }
+    SizeClassAllocator::shared().reserve(sizeof(Entity), entity_count);
+    std::vector<std::unique_ptr<Entity>> entities(entity_count);
+    for (Uint32 i = 0; i < entity_count; ++i) {
+      EntityRecord record;
+      std::memcpy(&record, entity_records + sizeof(EntityRecord) * i, sizeof(record));
+      if (record.parent != NO_PARENT && record.parent >= i) {
+        SDL_Log("Invalid scene snapshot (entity %u has parent %u)", i, record.parent);
+        return false;
+      }
+      entities[i] = std::make_unique<Entity>(record.layer);
+      for (size_t flag = 0; flag < Entity::MAX_STATE_FLAGS; ++flag) {
+        if ((record.state_flags >> flag) & 1) {
+          entities[i]->setStateFlag(flag, true);
+        }
+      }
+    }
+
+    // コンポーネント（セクションは型ID順に並んでいるので、各Entityの配列には末尾追加になる）
+    Blob blob{nullptr, 0};
+    for (Uint32 s = 0; s < header.section_count; ++s) {
+      SectionHeader section;
+      if (!reader.read(section)) {
+        SDL_Log("Scene snapshot is truncated (section %u)", s);
+        return false;
+      }
+      bool ok = true;
+      switch (static_cast<SectionType>(section.type)) {
+        case SectionType::Blob:
+          blob.data = reader.skip(section.count);
+          blob.size = section.count;
+          ok = blob.data != nullptr && reader.skip(paddingFor(section.count)) != nullptr;
+          break;
+        case SectionType::Locator:
+          ok = readSection<LocatorRecord, Locator>(reader, section, entities, [](Entity& e, const LocatorRecord& r) {
+            e.emplaceComponent<Locator>(r.x, r.y);
+            return true;
+          });
+          break;
+        case SectionType::Rotater:
+          ok = readSection<RotaterRecord, Rotater>(reader, section, entities, [](Entity& e, const RotaterRecord& r) {
+            e.emplaceComponent<Rotater>(r.angle);
+            return true;
+          });
+          break;
+        case SectionType::Scaler:
+          ok = readSection<ScalerRecord, Scaler>(reader, section, entities, [](Entity& e, const ScalerRecord& r) {
+            e.emplaceComponent<Scaler>(r.scale_x, r.scale_y);
+            return true;
+          });
+          break;
+        case SectionType::VelocityMove:
+          ok = readSection<VelocityRecord, VelocityMove>(reader, section, entities, [](Entity& e, const VelocityRecord& r) {
+            e.emplaceComponent<VelocityMove>(r.vx, r.vy);
+            return true;
+          });
+          break;
+        case SectionType::AngularVelocity:
+          ok = readSection<AngularVelocityRecord, AngularVelocity>(reader, section, entities, [](Entity& e, const AngularVelocityRecord& r) {
+            e.emplaceComponent<AngularVelocity>(r.angular_velocity);
+            return true;
+          });
+          break;
+        case SectionType::RectRenderer:
+          ok = readSection<RectRecord, RectRenderer>(reader, section, entities, [](Entity& e, const RectRecord& r) {
+            e.emplaceComponent<RectRenderer>(r.width, r.height, r.color);
+            return true;
+          });
+          break;
+        case SectionType::RotatedRectRenderer:
+          ok = readSection<RotatedRectRecord, RotatedRectRenderer>(reader, section, entities, [](Entity& e, const RotatedRectRecord& r) {
+            e.emplaceComponent<RotatedRectRenderer>(r.width, r.height, r.color, r.pivot_x, r.pivot_y);
+            return true;
+          });
+          break;
+        case SectionType::UIAnchor:
+          ok = readSection<AnchorRecord, UIAnchorComponent>(reader, section, entities, [](Entity& e, const AnchorRecord& r) {
+            if (r.anchor > static_cast<Uint32>(UIAnchor::Center)) return false;
+            e.emplaceComponent<UIAnchorComponent>(static_cast<UIAnchor>(r.anchor));
+            return true;
+          });
+          break;
+        case SectionType::TextRenderer:
+          ok = readSection<TextRecord, TextRenderer>(reader, section, entities, [&blob](Entity& e, const TextRecord& r) {
+            std::string text;
+            if (!blob.readString(r.text, text)) return false;
+            e.emplaceComponent<TextRenderer>(text, r.color);
+            return true;
+          });
+          break;
+        case SectionType::Direction:
+          ok = readSection<DirectionRecord, DirectionComponent>(reader, section, entities, [](Entity& e, const DirectionRecord& r) {
+            if (!isValidDirection(r.direction)) return false;
+            e.emplaceComponent<DirectionComponent>(static_cast<Direction>(r.direction));
+            return true;
+          });
+          break;
+        case SectionType::SpriteRenderer:
+          ok = readSection<SpriteRecord, SpriteRenderer>(reader, section, entities, [&id_to_texture](Entity& e, const SpriteRecord& r) {
+            SDL_Texture* texture = id_to_texture ? id_to_texture(r.texture_id) : nullptr;
+            e.emplaceComponent<SpriteRenderer>(texture, r.tile_size, r.tile_x, r.tile_y,
+                                               r.flip_horizontal != 0);
+            return true;
+          });
+          break;
+        case SectionType::DirectionalSpriteAnimator:
+          ok = readSection<DirectionalAnimatorRecord, DirectionalSpriteAnimator>(reader, section, entities, [&blob](Entity& e, const DirectionalAnimatorRecord& r) {
+            if (!isValidDirection(r.applied_direction)) return false;
+            std::vector<std::pair<int, int>> frames[4];
+            for (int d = 0; d < 4; ++d) {
+              if (!blob.readFrames(r.frames[d], frames[d])) return false;
+            }
+            auto* animator = e.emplaceComponent<DirectionalSpriteAnimator>(
+                frames[0], frames[1], frames[2], frames[3]);
+            animator->setAppliedDirection(static_cast<Direction>(r.applied_direction));
+            return true;
+          });
+          break;
+        case SectionType::SpriteAnimator:
+          ok = readSection<AnimatorRecord, SpriteAnimator>(reader, section, entities, [&blob](Entity& e, const AnimatorRecord& r) {
+            std::vector<std::pair<int, int>> frames;
+            if (!blob.readFrames(r.frames, frames)) return false;
+            auto* animator = e.emplaceComponent<SpriteAnimator>(frames, r.frame_duration);
+            animator->setPlaybackPosition(r.current_frame, r.timer);
+            return true;
+          });
+          break;
+        case SectionType::Collider:
+          ok = readSection<ColliderRecord, Collider>(reader, section, entities, [](Entity& e, const ColliderRecord& r) {
+            e.emplaceComponent<Collider>(r.layer, r.mask);
+            return true;
+          });
+          break;
+        default:
+          // 未知のセクションは読み飛ばす（新しいバージョンで追加された型など）
+          ok = reader.skip(static_cast<size_t>(section.count) * section.record_size) != nullptr;
+          break;
+      }
+      if (!ok) {
+        SDL_Log("Invalid scene snapshot (section %u, type %u)", s, section.type);
+        return false;
+      }
+    }
+
+    // 階層を組み立て、最上位のエンティティをまとめて追加
+    std::vector<Entity*> raw(entity_count);
+    for (Uint32 i = 0; i < entity_count; ++i) {
+      raw[i] = entities[i].get();
+    }
+    Entity* target = parent ? parent : manager.getRoot();
+    manager.reserveEntities(entity_count);
+    for (Uint32 i = 0; i < entity_count; ++i) {
+      EntityRecord record;
+      std::memcpy(&record, entity_records + sizeof(EntityRecord) * i, sizeof(record));
+      if (record.parent != NO_PARENT) {
+        raw[record.parent]->addChild(std::move(entities[i]));
+      }
+    }
+    for (Uint32 i = 0; i < entity_count; ++i) {
+      if (entities[i]) {
+        EntityHandle handle = manager.addEntityTo(target, std::move(entities[i]));
+        if (out_handles) {
+          out_handles->push_back(handle);
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief スナップショットをファイルに保存
+   * @param path 保存先のパス
+   * @return 成功した場合true
+   *
+   * capture()済みのバッファを書き出すだけなので、ワーカースレッドから呼んでも構いません
+   * （書き込み中にcapture()を呼ばないでください）。
+   */
+  bool saveToFile(const std::string& path) const {
+    if (!SDL_SaveFile(path.c_str(), data_.data(), data_.size())) {
+      SDL_Log("Failed to save scene snapshot %s: %s", path.c_str(), SDL_GetError());
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief ファイルからスナップショットを読み込む
+   * @param path 読み込むファイルのパス
+   * @return 成功した場合true（内容の検証はrestore()で行う）
+   */
+  bool loadFromFile(const std::string& path) {
+    size_t size = 0;
+    void* file = SDL_LoadFile(path.c_str(), &size);
+    if (!file) {
+      SDL_Log("Failed to load scene snapshot %s: %s", path.c_str(), SDL_GetError());
+      return false;
+    }
+    const std::byte* bytes = static_cast<const std::byte*>(file);
+    data_.assign(bytes, bytes + size);
+    SDL_free(file);
+    return true;
+  }
+
+  /**
+   * @brief スナップショットのバイト列を取得
+   */
+  const std::vector<std::byte>& getData() const { return data_; }
+
+  /**
+   * @brief スナップショットのバイト列を設定（ネットワーク経由で受け取った場合など）
+   * @param data バイト列の先頭
+   * @param size バイト数
+   */
+  void setData(const void* data, size_t size) {
+    const std::byte* bytes = static_cast<const std::byte*>(data);
+    data_.assign(bytes, bytes + size);
+  }
+
+ private:
+  static constexpr Uint32 NO_PARENT = 0xFFFFFFFF;  // 復元先の親に直接つながる
+
+  // セクションの種類（保存形式の一部なので、既存の値は変更しないこと）
+  enum class SectionType : Uint32 {
+    Locator = 1,
+    Rotater = 2,
+    Scaler = 3,
+    VelocityMove = 4,
+    AngularVelocity = 5,
+    RectRenderer = 6,
+    RotatedRectRenderer = 7,
+    UIAnchor = 8,
+    TextRenderer = 9,
+    Direction = 10,
+    SpriteRenderer = 11,
+    DirectionalSpriteAnimator = 12,
+    SpriteAnimator = 13,
+    Collider = 14,
+    Blob = 0x100,  // 可変長データ（record_sizeは1）
+  };
+
+  struct Header {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 entity_count;
+    Uint32 section_count;
+  };
+
+  struct EntityRecord {
+    Uint32 parent;       // 親の添字（NO_PARENTなら復元先の親）
+    Sint32 layer;        // レイヤー番号
+    Uint32 state_flags;  // 状態フラグのビット集合
+    Uint32 reserved;
+  };
+
+  struct SectionHeader {
+    Uint32 type;         // SectionType
+    Uint32 count;        // レコード数
+    Uint32 record_size;  // 1レコードのバイト数（未知の型を読み飛ばすため）
+    Uint32 reserved;
+  };
+
+  // Blob内の範囲（offsetはバイト単位、lengthは要素数）
+  struct BlobRef {
+    Uint32 offset;
+    Uint32 length;
+  };
+
+  struct FrameRecord {
+    Sint32 tile_x;
+    Sint32 tile_y;
+  };
+
+  // 各コンポーネントのレコード（先頭は必ずエンティティの添字）
+  struct LocatorRecord {
+    Uint32 entity;
+    float x, y;
+  };
+  struct RotaterRecord {
+    Uint32 entity;
+    float angle;
+  };
+  struct ScalerRecord {
+    Uint32 entity;
+    float scale_x, scale_y;
+  };
+  struct VelocityRecord {
+    Uint32 entity;
+    float vx, vy;
+  };
+  struct AngularVelocityRecord {
+    Uint32 entity;
+    float angular_velocity;
+  };
+  struct RectRecord {
+    Uint32 entity;
+    float width, height;
+    SDL_Color color;
+  };
+  struct RotatedRectRecord {
+    Uint32 entity;
+    float width, height;
+    SDL_Color color;
+    float pivot_x, pivot_y;
+  };
+  struct AnchorRecord {
+    Uint32 entity;
+    Uint32 anchor;
+  };
+  struct TextRecord {
+    Uint32 entity;
+    SDL_Color color;
+    BlobRef text;
+  };
+  struct DirectionRecord {
+    Uint32 entity;
+    Uint32 direction;
+  };
+  struct SpriteRecord {
+    Uint32 entity;
+    Uint32 texture_id;
+    Sint32 tile_size;
+    Sint32 tile_x, tile_y;
+    Uint32 flip_horizontal;
+  };
+  struct DirectionalAnimatorRecord {
+    Uint32 entity;
+    BlobRef frames[4];  // Down, Up, Right, Leftの順
+    Uint32 applied_direction;
+  };
+  struct AnimatorRecord {
+    Uint32 entity;
+    BlobRef frames;
+    Uint32 current_frame;
+    Uint64 frame_duration;
+    Uint64 timer;
+  };
+  struct ColliderRecord {
+    Uint32 entity;
+    Uint32 layer;
+    Uint32 mask;
+  };
+
+  /**
+   * @brief 範囲を確認しながら先頭から読み進める
+   */
+  struct Reader {
+    const std::byte* data;
+    size_t size;
+    size_t position = 0;
+
+    const std::byte* skip(size_t bytes) {
+      if (bytes > size - position) return nullptr;
+      const std::byte* current = data + position;
+      position += bytes;
+      return current;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+      const std::byte* bytes = skip(sizeof(T));
+      if (!bytes) return false;
+      std::memcpy(&value, bytes, sizeof(T));
+      return true;
+    }
+  };
+
+  /**
+   * @brief 読み込んだBlobセクション
+   */
+  struct Blob {
+    const std::byte* data;
+    size_t size;
+
+    // 範囲外ならnullptr（長さ0の範囲は呼び出し側で扱う）
+    const std::byte* at(BlobRef ref, size_t element_size) const {
+      if (!data || ref.offset > size ||
+          static_cast<size_t>(ref.length) * element_size > size - ref.offset) {
+        return nullptr;
+      }
+      return data + ref.offset;
+    }
+
+    bool readString(BlobRef ref, std::string& out) const {
+      if (ref.length == 0) return true;
+      const std::byte* bytes = at(ref, 1);
+      if (!bytes) return false;
+      out.assign(reinterpret_cast<const char*>(bytes), ref.length);
+      return true;
+    }
+
+    bool readFrames(BlobRef ref, std::vector<std::pair<int, int>>& out) const {
+      if (ref.length == 0) return true;
+      const std::byte* bytes = at(ref, sizeof(FrameRecord));
+      if (!bytes) return false;
+      out.resize(ref.length);
+      for (Uint32 i = 0; i < ref.length; ++i) {
+        FrameRecord frame;
+        std::memcpy(&frame, bytes + sizeof(FrameRecord) * i, sizeof(frame));
+        out[i] = {frame.tile_x, frame.tile_y};
+      }
+      return true;
+    }
+  };
+
+  /**
+   * @brief 保存時の作業用バッファ（フレーム間で再利用）
+   */
+  struct Scratch {
+    std::vector<const Entity*> entities;
+    std::vector<Uint32> parents;
+    std::vector<EntityRecord> records;
+    std::vector<std::byte> blob;
+    std::vector<LocatorRecord> locators;
+    std::vector<RotaterRecord> rotaters;
+    std::vector<ScalerRecord> scalers;
+    std::vector<VelocityRecord> velocities;
+    std::vector<AngularVelocityRecord> angular_velocities;
+    std::vector<RectRecord> rects;
+    std::vector<RotatedRectRecord> rotated_rects;
+    std::vector<AnchorRecord> anchors;
+    std::vector<TextRecord> texts;
+    std::vector<DirectionRecord> directions;
+    std::vector<SpriteRecord> sprites;
+    std::vector<DirectionalAnimatorRecord> directional_animators;
+    std::vector<AnimatorRecord> animators;
+    std::vector<ColliderRecord> colliders;
+  };
+
+  void clearScratch() {
+    scratch_.entities.clear();
+    scratch_.parents.clear();
+    scratch_.records.clear();
+    scratch_.blob.clear();
+    scratch_.locators.clear();
+    scratch_.rotaters.clear();
+    scratch_.scalers.clear();
+    scratch_.velocities.clear();
+    scratch_.angular_velocities.clear();
+    scratch_.rects.clear();
+    scratch_.rotated_rects.clear();
+    scratch_.anchors.clear();
+    scratch_.texts.clear();
+    scratch_.directions.clear();
+    scratch_.sprites.clear();
+    scratch_.directional_animators.clear();
+    scratch_.animators.clear();
+    scratch_.colliders.clear();
+  }
+
+  /**
+   * @brief 1エンティティ分のレコードを作業用バッファに追加
+   */
+  void captureEntity(const Entity& entity, Uint32 index, Uint32 parent,
+                     const TextureToId& texture_to_id) {
+    EntityRecord record{};
+    record.parent = parent;
+    record.layer = entity.getLayer();
+    record.state_flags = entity.getStateFlags();
+    scratch_.records.push_back(record);
+
+    if (const auto* c = entity.getComponent<Locator>()) {
+      LocatorRecord r{};
+      r.entity = index;
+      std::tie(r.x, r.y) = c->getPosition();
+      scratch_.locators.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<Rotater>()) {
+      RotaterRecord r{};
+      r.entity = index;
+      r.angle = c->getAngle();
+      scratch_.rotaters.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<Scaler>()) {
+      ScalerRecord r{};
+      r.entity = index;
+      std::tie(r.scale_x, r.scale_y) = c->getScale();
+      scratch_.scalers.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<VelocityMove>()) {
+      VelocityRecord r{};
+      r.entity = index;
+      std::tie(r.vx, r.vy) = c->getVelocity();
+      scratch_.velocities.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<AngularVelocity>()) {
+      AngularVelocityRecord r{};
+      r.entity = index;
+      r.angular_velocity = c->getAngularVelocity();
+      scratch_.angular_velocities.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<RectRenderer>()) {
+      RectRecord r{};
+      r.entity = index;
+      std::tie(r.width, r.height) = c->getSize();
+      r.color = c->getColor();
+      scratch_.rects.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<RotatedRectRenderer>()) {
+      RotatedRectRecord r{};
+      r.entity = index;
+      std::tie(r.width, r.height) = c->getSize();
+      r.color = c->getColor();
+      std::tie(r.pivot_x, r.pivot_y) = c->getPivot();
+      scratch_.rotated_rects.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<UIAnchorComponent>()) {
+      AnchorRecord r{};
+      r.entity = index;
+      r.anchor = static_cast<Uint32>(c->getAnchor());
+      scratch_.anchors.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<TextRenderer>()) {
+      TextRecord r{};
+      r.entity = index;
+      r.color = c->getColor();
+      r.text = appendToBlob(c->getText().data(), c->getText().size());
+      scratch_.texts.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<DirectionComponent>()) {
+      DirectionRecord r{};
+      r.entity = index;
+      r.direction = static_cast<Uint32>(c->getDirection());
+      scratch_.directions.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<SpriteRenderer>()) {
+      SpriteRecord r{};
+      r.entity = index;
+      r.texture_id = texture_to_id ? texture_to_id(c->getTexture()) : 0;
+      r.tile_size = c->getTileSize();
+      std::tie(r.tile_x, r.tile_y) = c->getTile();
+      r.flip_horizontal = c->isFlipHorizontal() ? 1 : 0;
+      scratch_.sprites.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<DirectionalSpriteAnimator>()) {
+      DirectionalAnimatorRecord r{};
+      r.entity = index;
+      const Direction directions[4] = {Direction::Down, Direction::Up,
+                                       Direction::Right, Direction::Left};
+      for (int d = 0; d < 4; ++d) {
+        r.frames[d] = appendFrames(c->getFrames(directions[d]));
+      }
+      r.applied_direction = static_cast<Uint32>(c->getAppliedDirection());
+      scratch_.directional_animators.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<SpriteAnimator>()) {
+      AnimatorRecord r{};
+      r.entity = index;
+      r.frames = appendFrames(c->getFrames());
+      r.current_frame = static_cast<Uint32>(c->getCurrentFrame());
+      r.frame_duration = c->getFrameDuration();
+      r.timer = c->getTimer();
+      scratch_.animators.push_back(r);
+    }
+    if (const auto* c = entity.getComponent<Collider>()) {
+      ColliderRecord r{};
+      r.entity = index;
+      r.layer = c->getLayer();
+      r.mask = c->getMask();
+      scratch_.colliders.push_back(r);
+    }
+  }
+
+  BlobRef appendToBlob(const void* bytes, size_t size) {
+    BlobRef ref{static_cast<Uint32>(scratch_.blob.size()), static_cast<Uint32>(size)};
+    const std::byte* begin = static_cast<const std::byte*>(bytes);
+    scratch_.blob.insert(scratch_.blob.end(), begin, begin + size);
+    return ref;
+  }
+
+  BlobRef appendFrames(const std::vector<std::pair<int, int>>& frames) {
+    // フレームは4バイト境界に揃える
+    scratch_.blob.resize(scratch_.blob.size() + paddingFor(scratch_.blob.size()));
+    BlobRef ref{static_cast<Uint32>(scratch_.blob.size()), static_cast<Uint32>(frames.size())};
+    for (const auto& [tile_x, tile_y] : frames) {
+      FrameRecord frame{tile_x, tile_y};
+      const std::byte* begin = reinterpret_cast<const std::byte*>(&frame);
+      scratch_.blob.insert(scratch_.blob.end(), begin, begin + sizeof(frame));
+    }
+    return ref;
+  }
+
+  static size_t paddingFor(size_t size) { return (4 - size % 4) % 4; }
+
+  /**
+   * @brief 保存された向きが列挙値の範囲内か（範囲外ならそのセクションは読み込まない）
+   */
+  static bool isValidDirection(Uint32 direction) {
+    return direction <= static_cast<Uint32>(Direction::Left);
+  }
+
+  void appendBytes(const void* bytes, size_t size) {
+    const std::byte* begin = static_cast<const std::byte*>(bytes);
+    data_.insert(data_.end(), begin, begin + size);
+  }
+
+  void appendBlob(const std::vector<std::byte>& blob, Uint32& section_count) {
+    if (blob.empty()) return;
+    SectionHeader header{};
+    header.type = static_cast<Uint32>(SectionType::Blob);
+    header.count = static_cast<Uint32>(blob.size());
+    header.record_size = 1;
+    appendBytes(&header, sizeof(header));
+    appendBytes(blob.data(), blob.size());
+    data_.resize(data_.size() + paddingFor(blob.size()));
+    ++section_count;
+  }
+
+  template <typename Record>
+  void appendSection(SectionType type, const std::vector<Record>& records,
+                     Uint32& section_count) {
+    static_assert(std::is_trivially_copyable_v<Record>);
+    static_assert(sizeof(Record) % 4 == 0, "Records must keep 4-byte alignment");
+    if (records.empty()) return;
+    SectionHeader header{};
+    header.type = static_cast<Uint32>(type);
+    header.count = static_cast<Uint32>(records.size());
+    header.record_size = sizeof(Record);
+    appendBytes(&header, sizeof(header));
+    appendBytes(records.data(), sizeof(Record) * records.size());
+    ++section_count;
+  }
+
+  /**
+   * @brief セクションのレコードを読み、対応するエンティティにコンポーネントを追加
+   * @tparam Record レコードの型
+   * @tparam T 追加するコンポーネントの型（プールを事前確保する）
+   * @param apply (Entity&, const Record&)を受け取り、成功したらtrueを返す関数
+   */
+  template <typename Record, typename T, typename Apply>
+  static bool readSection(Reader& reader, const SectionHeader& section,
+                          const std::vector<std::unique_ptr<Entity>>& entities,
+                          Apply&& apply) {
+    if (section.record_size != sizeof(Record)) return false;
+    const std::byte* records = reader.skip(static_cast<size_t>(section.count) * sizeof(Record));
+    if (!records) return false;
+    ComponentPool<T>::shared().reserve(section.count);
+    for (Uint32 i = 0; i < section.count; ++i) {
+      Record record;
+      std::memcpy(&record, records + sizeof(Record) * i, sizeof(record));
+      if (record.entity >= entities.size()) return false;
+      if (!apply(*entities[record.entity], record)) return false;
+    }
+    return true;
+  }
+
+  std::vector<std::byte> data_;  // スナップショットのバイト列
+  Scratch scratch_;              // 保存時の作業用バッファ
+};
+
+}  // namespace MyGame
@@ -0,0 +1,654 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "entity_handle.h"
+#include "entity_manager.h"
+#include "utilities/frame_profiler.h"
+
+namespace MyGame {
+
+/**
+ * @brief 軸に平行な矩形（ワールド座標）
+ */
+struct Aabb {
+  float min_x = 0.0f, min_y = 0.0f;
+  float max_x = 0.0f, max_y = 0.0f;
+
+  /**
+   * @brief 重なっているか（辺が接している場合を含む）
+   */
+  bool overlaps(const Aabb& other) const {
+    return min_x <= other.max_x && other.min_x <= max_x && min_y <= other.max_y &&
+           other.min_y <= max_y;
+  }
+
+  /**
+   * @brief 点を含むか（辺上を含む）
+   */
+  bool contains(float x, float y) const {
+    return min_x <= x && x <= max_x && min_y <= y && y <= max_y;
+  }
+
+  /**
+   * @brief 点を含むように広げる
+   */
+  void expand(float x, float y) {
+    min_x = std::min(min_x, x);
+    min_y = std::min(min_y, y);
+    max_x = std::max(max_x, x);
+    max_y = std::max(max_y, y);
+  }
+};
+
+/**
+ * @brief 重なっている2つのエンティティ（a.index < b.index）
+ */
+struct CollisionPair {
+  EntityHandle a;
+  EntityHandle b;
+
+  bool operator==(const CollisionPair& other) const {
+    return a == other.a && b == other.b;
+  }
+};
+
+/**
+ * @brief レイキャストの結果
+ */
+struct RaycastHit {
+  EntityHandle entity;  // 最初に当たったエンティティ
+  float distance = 0.0f;  // 始点からの距離（始点が矩形の中なら0）
+  float x = 0.0f, y = 0.0f;  // 当たった位置
+};
+
+/**
+ * @brief エンティティの衝突範囲（描画コンポーネントの矩形のワールド座標での外接矩形）を計算
+ * @param entity 対象のエンティティ
+ * @param out_bounds 範囲の出力先
+ * @return 範囲を持つか（RectRenderer・RotatedRectRenderer・SpriteRendererのいずれもなければfalse）
+ *
+ * 複数の描画コンポーネントを持つ場合は、すべてを含む矩形になります。
+ */
+inline bool computeColliderBounds(Entity& entity, Aabb& out_bounds) {
+  const Transform2D& world = entity.getWorldTransform();
+  bool found = false;
+  auto add = [&](float x, float y) {
+    if (!found) {
+      out_bounds = Aabb{x, y, x, y};
+      found = true;
+    } else {
+      out_bounds.expand(x, y);
+    }
+  };
+
+  // 左上を基準に描画されるもの
+  if (const auto* rect = entity.getComponent<RectRenderer>()) {
+    auto [width, height] = rect->getSize();
+    add(world.x, world.y);
+    add(world.x + width * world.scale_x, world.y + height * world.scale_y);
+  }
+  if (const auto* sprite = entity.getComponent<SpriteRenderer>()) {
+    float size = static_cast<float>(sprite->getTileSize());
+    add(world.x, world.y);
+    add(world.x + size * world.scale_x, world.y + size * world.scale_y);
+  }
+
+  // 中心を基準に、ピボットを原点として回転して描画されるもの
+  if (const auto* rotated = entity.getComponent<RotatedRectRenderer>()) {
+    auto [width, height] = rotated->getSize();
+    auto [pivot_x, pivot_y] = rotated->getPivot();
+    float scaled_width = width * world.scale_x;
+    float scaled_height = height * world.scale_y;
+    float pivot_offset_x = (pivot_x - 0.5f) * scaled_width;
+    float pivot_offset_y = (pivot_y - 0.5f) * scaled_height;
+    for (int corner = 0; corner < 4; ++corner) {
+      float x = (corner == 1 || corner == 2 ? 0.5f : -0.5f) * scaled_width - pivot_offset_x;
+      float y = (corner >= 2 ? 0.5f : -0.5f) * scaled_height - pivot_offset_y;
+      add(x * world.cos_a - y * world.sin_a + pivot_offset_x + world.x,
+          x * world.sin_a + y * world.cos_a + pivot_offset_y + world.y);
+    }
+  }
+  return found;
+}
+
+/**
+ * @brief Colliderを持つエンティティの空間ハッシュ（ブロードフェーズ）
+ *
+ * ワールドを一辺cell_sizeの格子に分け、各エンティティの衝突範囲が重なるセルに登録します。
+ * update()では前回から変更されたコンポーネント（座標・回転・スケール・サイズ・Collider）を
+ * forEachChanged()で調べ、動いたエンティティ（とその子孫）だけを登録し直します。
+ * 親の付け替えも、付け替えたエンティティの変更として記録されるので検出されます。
+ * 削除されたエンティティ・外されたColliderはforEachRemoved()の記録から登録を解除します。
+ * 占めるセルが変わらなければ、範囲を書き換えるだけでセルの操作はしません。
+ *
+ * 重なりの判定はセルごとに行い、結果はupdate()の後にまとめて取得できます。
+ * - getCollisions(): 現在重なっているペア
+ * - getCollisionBegins() / getCollisionEnds(): 今回重なり始めた／離れたペア
+ *
+ * 使用例:
+ * @code
+ * SpatialHash collision(64.0f);
+ *
+ * // 毎ステップ（updateAll()の後）
+ * collision.update(entity_manager);
+ * for (const CollisionPair& pair : collision.getCollisionBegins()) {
+ *   Entity* a = entity_manager.resolve(pair.a);
+ *   Entity* b = entity_manager.resolve(pair.b);
+ *   ...
+ * }
+ *
+ * // クエリ
+ * std::vector<EntityHandle> hits;
+ * collision.queryAabb(Aabb{0.0f, 0.0f, 100.0f, 100.0f}, ENEMY_LAYER, hits);
+ * RaycastHit hit;
+ * if (collision.raycast(x, y, 1.0f, 0.0f, 500.0f, WALL_LAYER, hit)) { ... }
+ * @endcode
+ *
+ * note: クエリの結果はupdate()した時点の位置で答えます
+ */
+class SpatialHash {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param cell_size セルの一辺の長さ（ピクセル、典型的なエンティティより少し大きくする）
+   */
+  explicit SpatialHash(float cell_size = 64.0f)
+      : cell_size_(std::max(cell_size, 1.0f)), inv_cell_size_(1.0f / cell_size_) {}
+
+  SpatialHash(const SpatialHash&) = delete;
+  SpatialHash& operator=(const SpatialHash&) = delete;
+
+  /**
+   * @brief 変更されたエンティティを登録し直し、重なっているペアを求める
+   * @param manager 対象のEntityManager（毎回同じものを渡すこと）
+   */
+  void update(EntityManager& manager) {
+    Utilities::FrameProfiler::Scope scope("spatial_hash.update");
+    ++update_stamp_;
+
+    // 削除されたエンティティ・外されたColliderの登録を解除
+    bool complete = manager.forEachRemoved<Collider>(removal_cursor_, [this](EntityHandle handle) {
+      if (Uint32 id = findProxy(handle); id != NO_PROXY) removeProxy(id);
+    });
+    if (!complete) {
+      // 削除の記録が切り詰められていたので、登録をすべて確かめる
+      for (Uint32 id = 0; id < proxies_.size(); ++id) {
+        const Proxy& proxy = proxies_[id];
+        if (!proxy.alive) continue;
+        Entity* entity = manager.resolve(proxy.handle);
+        if (!entity || !entity->isActive() || !entity->getComponent<Collider>()) {
+          removeProxy(id);
+        }
+      }
+    }
+
+    // 範囲に影響するコンポーネントが変更されたエンティティ（と子孫）を集める
+    dirty_.clear();
+    auto mark = [this](Entity& entity, auto&) { markDirty(entity); };
+    cursors_[0] = manager.forEachChanged<Locator>(cursors_[0], mark);
+    cursors_[1] = manager.forEachChanged<Rotater>(cursors_[1], mark);
+    cursors_[2] = manager.forEachChanged<Scaler>(cursors_[2], mark);
+    cursors_[3] = manager.forEachChanged<RectRenderer>(cursors_[3], mark);
+    cursors_[4] = manager.forEachChanged<RotatedRectRenderer>(cursors_[4], mark);
+    cursors_[5] = manager.forEachChanged<SpriteRenderer>(cursors_[5], mark);
+    cursors_[6] = manager.forEachChanged<Collider>(cursors_[6], mark);
+
+    for (Entity* entity : dirty_) {
+      const Collider* collider = entity->getComponent<Collider>();
+      Aabb bounds;
+      if (collider && computeColliderBounds(*entity, bounds)) {
+        updateProxy(entity->getHandle(), bounds, collider->getLayer(), collider->getMask());
+      } else if (Uint32 id = findProxy(entity->getHandle()); id != NO_PROXY) {
+        removeProxy(id);
+      }
+    }
+
+    findPairs();
+  }
+
+  /**
+   * @brief 現在重なっているペアを取得
+   * @return ペアのリスト（(a.index, b.index)の昇順、次のupdate()まで有効）
+   */
+  const std::vector<CollisionPair>& getCollisions() const { return pairs_; }
+
+  /**
+   * @brief 前回のupdate()から重なり始めたペアを取得
+   */
+  const std::vector<CollisionPair>& getCollisionBegins() const { return begins_; }
+
+  /**
+   * @brief 前回のupdate()から離れたペアを取得（削除されたエンティティのペアを含む）
+   */
+  const std::vector<CollisionPair>& getCollisionEnds() const { return ends_; }
+
+  /**
+   * @brief 矩形と重なるエンティティを列挙
+   * @param area 矩形（ワールド座標）
+   * @param mask 対象のレイヤー（Colliderのレイヤーとのビット積が0でないもの）
+   * @param out_entities 結果の追加先（重複なし、順不同）
+   */
+  void queryAabb(const Aabb& area, Uint32 mask, std::vector<EntityHandle>& out_entities) const {
+    ++query_stamp_;
+    CellRange range = cellRange(area);
+    for (int cy = range.min_y; cy <= range.max_y; ++cy) {
+      for (int cx = range.min_x; cx <= range.max_x; ++cx) {
+        const std::vector<Uint32>* cell = findCell(cx, cy);
+        if (!cell) continue;
+        for (Uint32 id : *cell) {
+          const Proxy& proxy = proxies_[id];
+          if (!visit(id) || (proxy.layer & mask) == 0) continue;
+          if (proxy.bounds.overlaps(area)) out_entities.push_back(proxy.handle);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 点を含むエンティティを列挙
+   * @param x X座標（ワールド座標）
+   * @param y Y座標（ワールド座標）
+   * @param mask 対象のレイヤー
+   * @param out_entities 結果の追加先（順不同）
+   */
+  void queryPoint(float x, float y, Uint32 mask, std::vector<EntityHandle>& out_entities) const {
+    const std::vector<Uint32>* cell = findCell(toCell(x), toCell(y));
+    if (!cell) return;
+    for (Uint32 id : *cell) {
+      const Proxy& proxy = proxies_[id];
+      if ((proxy.layer & mask) != 0 && proxy.bounds.contains(x, y)) {
+        out_entities.push_back(proxy.handle);
+      }
+    }
+  }
+
+  /**
+   * @brief 半直線と最初に交わるエンティティを求める
+   * @param x 始点のX座標（ワールド座標）
+   * @param y 始点のY座標（ワールド座標）
+   * @param dir_x 方向のX成分（正規化は不要）
+   * @param dir_y 方向のY成分
+   * @param max_distance 調べる最大距離（無限大も可）
+   * @param mask 対象のレイヤー
+   * @param out_hit 結果の出力先
+   * @return 当たった場合true
+   *
+   * 始点から近い順にセルをたどり、当たりが見つかったセルより先は調べません。
+   * たどるのは、登録のあるセル全体を囲む範囲と半直線が重なる区間だけです。
+   */
+  bool raycast(float x, float y, float dir_x, float dir_y, float max_distance, Uint32 mask,
+               RaycastHit& out_hit) const {
+    float length = std::sqrt(dir_x * dir_x + dir_y * dir_y);
+    if (length <= 0.0f || !(max_distance >= 0.0f) || occupied_cells_ == 0) return false;
+    dir_x /= length;
+    dir_y /= length;
+
+    // 登録のあるセルの範囲に半直線を切り詰める（遠い最大距離でも範囲の外はたどらない）
+    const CellRange& range = occupied_range_;
+    const Aabb area{range.min_x * cell_size_, range.min_y * cell_size_,
+                    (range.max_x + 1) * cell_size_, (range.max_y + 1) * cell_size_};
+    float cell_enter;
+    if (!intersectRay(area, x, y, dir_x, dir_y, max_distance, cell_enter)) return false;
+    ++query_stamp_;
+
+    // 格子をたどる準備（各軸で次のセル境界までの距離と、1セル進むのにかかる距離）
+    constexpr float INF = std::numeric_limits<float>::infinity();
+    int cx = std::clamp(toCell(x + dir_x * cell_enter), range.min_x, range.max_x);
+    int cy = std::clamp(toCell(y + dir_y * cell_enter), range.min_y, range.max_y);
+    const int step_x = dir_x > 0.0f ? 1 : -1;
+    const int step_y = dir_y > 0.0f ? 1 : -1;
+    const float delta_x = dir_x != 0.0f ? cell_size_ / std::abs(dir_x) : INF;
+    const float delta_y = dir_y != 0.0f ? cell_size_ / std::abs(dir_y) : INF;
+    float next_x = dir_x != 0.0f
+                       ? ((cx + (step_x > 0 ? 1 : 0)) * cell_size_ - x) / dir_x
+                       : INF;
+    float next_y = dir_y != 0.0f
+                       ? ((cy + (step_y > 0 ? 1 : 0)) * cell_size_ - y) / dir_y
+                       : INF;
+
+    float best = max_distance;
+    bool hit = false;
+    while (cell_enter <= best && cx >= range.min_x && cx <= range.max_x && cy >= range.min_y &&
+           cy <= range.max_y) {
+      if (const std::vector<Uint32>* cell = findCell(cx, cy)) {
+        for (Uint32 id : *cell) {
+          const Proxy& proxy = proxies_[id];
+          if (!visit(id) || (proxy.layer & mask) == 0) continue;
+          float distance;
+          if (intersectRay(proxy.bounds, x, y, dir_x, dir_y, best, distance)) {
+            best = distance;
+            hit = true;
+            out_hit.entity = proxy.handle;
+            out_hit.distance = distance;
+          }
+        }
+      }
+      // 次のセルへ
+      if (next_x < next_y) {
+        cell_enter = next_x;
+        next_x += delta_x;
+        cx += step_x;
+      } else {
+        cell_enter = next_y;
+        next_y += delta_y;
+        cy += step_y;
+      }
+    }
+
+    if (hit) {
+      out_hit.x = x + dir_x * out_hit.distance;
+      out_hit.y = y + dir_y * out_hit.distance;
+    }
+    return hit;
+  }
+
+  /**
+   * @brief 登録されている範囲を取得
+   * @param entity 対象のエンティティ
+   * @param out_bounds 範囲の出力先
+   * @return 登録されている場合true
+   */
+  bool getBounds(EntityHandle entity, Aabb& out_bounds) const {
+    Uint32 id = findProxy(entity);
+    if (id == NO_PROXY) return false;
+    out_bounds = proxies_[id].bounds;
+    return true;
+  }
+
+  /**
+   * @brief 登録されているエンティティ数を取得
+   */
+  size_t getCount() const { return proxies_.size() - free_proxies_.size(); }
+
+  /**
+   * @brief セルの一辺の長さを取得
+   */
+  float getCellSize() const { return cell_size_; }
+
+  /**
+   * @brief 登録とペアをすべて破棄（次のupdate()で全エンティティを登録し直す）
+   */
+  void clear() {
+    proxies_.clear();
+    free_proxies_.clear();
+    slots_.clear();
+    cells_.clear();
+    occupied_cells_ = 0;
+    occupied_range_ = CellRange{0, 0, -1, -1};
+    pairs_.clear();
+    begins_.clear();
+    ends_.clear();
+    cursors_.fill(0);
+    removal_cursor_ = 0;
+  }
+
+ private:
+  static constexpr Uint32 NO_PROXY = 0xFFFFFFFF;
+
+  struct CellRange {
+    int min_x, min_y, max_x, max_y;
+
+    bool operator==(const CellRange& other) const {
+      return min_x == other.min_x && min_y == other.min_y && max_x == other.max_x &&
+             max_y == other.max_y;
+    }
+  };
+
+  /**
+   * @brief 登録されたエンティティ
+   */
+  struct Proxy {
+    EntityHandle handle;
+    Aabb bounds;
+    Uint32 layer = 0;
+    Uint32 mask = 0;
+    CellRange cells{0, 0, -1, -1};  // 登録しているセルの範囲
+    bool alive = false;             // 使用中か（falseなら空き）
+  };
+
+  /**
+   * @brief エンティティのスロット番号ごとの情報
+   */
+  struct Slot {
+    Uint32 proxy = NO_PROXY;  // 登録先
+    Uint32 dirty_stamp = 0;   // 最後にmarkDirty()されたupdate()の番号
+  };
+
+  int toCell(float v) const { return static_cast<int>(std::floor(v * inv_cell_size_)); }
+
+  CellRange cellRange(const Aabb& bounds) const {
+    return CellRange{toCell(bounds.min_x), toCell(bounds.min_y), toCell(bounds.max_x),
+                     toCell(bounds.max_y)};
+  }
+
+  static Uint64 cellKey(int cx, int cy) {
+    return (static_cast<Uint64>(static_cast<Uint32>(cx)) << 32) | static_cast<Uint32>(cy);
+  }
+
+  const std::vector<Uint32>* findCell(int cx, int cy) const {
+    auto it = cells_.find(cellKey(cx, cy));
+    return it != cells_.end() && !it->second.empty() ? &it->second : nullptr;
+  }
+
+  /**
+   * @brief クエリ中に初めて見るものならtrue（複数のセルにまたがるものを1回だけ調べる）
+   */
+  bool visit(Uint32 id) const {
+    if (visited_.size() < proxies_.size()) visited_.resize(proxies_.size(), 0);
+    if (visited_[id] == query_stamp_) return false;
+    visited_[id] = query_stamp_;
+    return true;
+  }
+
+  Slot& slotOf(EntityHandle handle) {
+    if (handle.index >= slots_.size()) slots_.resize(handle.index + 1);
+    return slots_[handle.index];
+  }
+
+  Uint32 findProxy(EntityHandle handle) const {
+    if (handle.index >= slots_.size()) return NO_PROXY;
+    Uint32 id = slots_[handle.index].proxy;
+    return id != NO_PROXY && proxies_[id].handle == handle ? id : NO_PROXY;
+  }
+
+  /**
+   * @brief エンティティと子孫を登録し直す対象にする
+   */
+  void markDirty(Entity& entity) {
+    Slot& slot = slotOf(entity.getHandle());
+    if (slot.dirty_stamp == update_stamp_) return;
+    slot.dirty_stamp = update_stamp_;
+    dirty_.push_back(&entity);
+    for (const auto& child : entity.getChildren()) {
+      if (child->isActive()) markDirty(*child);
+    }
+  }
+
+  void updateProxy(EntityHandle handle, const Aabb& bounds, Uint32 layer, Uint32 mask) {
+    Uint32 id = findProxy(handle);
+    if (id == NO_PROXY) {
+      if (!free_proxies_.empty()) {
+        id = free_proxies_.back();
+        free_proxies_.pop_back();
+      } else {
+        id = static_cast<Uint32>(proxies_.size());
+        proxies_.emplace_back();
+      }
+      proxies_[id] = Proxy{};
+      proxies_[id].handle = handle;
+      proxies_[id].alive = true;
+      slotOf(handle).proxy = id;
+    }
+
+    Proxy& proxy = proxies_[id];
+    proxy.bounds = bounds;
+    proxy.layer = layer;
+    proxy.mask = mask;
+    CellRange range = cellRange(bounds);
+    if (range == proxy.cells) return;  // 同じセルの中で動いただけ
+
+    removeFromCells(id, proxy.cells);
+    for (int cy = range.min_y; cy <= range.max_y; ++cy) {
+      for (int cx = range.min_x; cx <= range.max_x; ++cx) {
+        cells_[cellKey(cx, cy)].push_back(id);
+      }
+    }
+    proxy.cells = range;
+  }
+
+  void removeProxy(Uint32 id) {
+    Proxy& proxy = proxies_[id];
+    removeFromCells(id, proxy.cells);
+    if (proxy.handle.index < slots_.size()) slots_[proxy.handle.index].proxy = NO_PROXY;
+    proxy.alive = false;
+    proxy.cells = CellRange{0, 0, -1, -1};
+    free_proxies_.push_back(id);
+  }
+
+  void removeFromCells(Uint32 id, const CellRange& range) {
+    for (int cy = range.min_y; cy <= range.max_y; ++cy) {
+      for (int cx = range.min_x; cx <= range.max_x; ++cx) {
+        // 空になったセルも容量を残して再利用する
+        auto found = cells_.find(cellKey(cx, cy));
+        if (found == cells_.end()) continue;
+        std::vector<Uint32>& cell = found->second;
+        auto it = std::find(cell.begin(), cell.end(), id);
+        if (it != cell.end()) {
+          *it = cell.back();
+          cell.pop_back();
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief セルごとに重なりを調べ、前回との差分を求める
+   *
+   * 複数のセルで見つかる同じペアは、重なり部分の左上の点を含むセルでだけ数えます。
+   * 空のセルが使用中のセルより多くなったら、走査のついでに取り除きます。
+   */
+  void findPairs() {
+    previous_pairs_.swap(pairs_);
+    pairs_.clear();
+    const bool prune = cells_.size() > occupied_cells_ * 2 + 64;
+    occupied_cells_ = 0;
+    occupied_range_ = CellRange{std::numeric_limits<int>::max(), std::numeric_limits<int>::max(),
+                                std::numeric_limits<int>::min(), std::numeric_limits<int>::min()};
+    for (auto it = cells_.begin(); it != cells_.end();) {
+      if (it->second.empty()) {
+        it = prune ? cells_.erase(it) : std::next(it);
+        continue;
+      }
+      ++occupied_cells_;
+      const std::vector<Uint32>& cell = it->second;
+      const Uint64 key = it->first;
+      ++it;
+      int cx = static_cast<int>(static_cast<Uint32>(key >> 32));
+      int cy = static_cast<int>(static_cast<Uint32>(key));
+      occupied_range_.min_x = std::min(occupied_range_.min_x, cx);
+      occupied_range_.min_y = std::min(occupied_range_.min_y, cy);
+      occupied_range_.max_x = std::max(occupied_range_.max_x, cx);
+      occupied_range_.max_y = std::max(occupied_range_.max_y, cy);
+      if (cell.size() < 2) continue;
+      for (size_t i = 0; i < cell.size(); ++i) {
+        const Proxy& a = proxies_[cell[i]];
+        for (size_t j = i + 1; j < cell.size(); ++j) {
+          const Proxy& b = proxies_[cell[j]];
+          if ((a.layer & b.mask) == 0 || (b.layer & a.mask) == 0) continue;
+          if (!a.bounds.overlaps(b.bounds)) continue;
+          if (toCell(std::max(a.bounds.min_x, b.bounds.min_x)) != cx ||
+              toCell(std::max(a.bounds.min_y, b.bounds.min_y)) != cy) {
+            continue;
+          }
+          pairs_.push_back(a.handle.index < b.handle.index ? CollisionPair{a.handle, b.handle}
+                                                           : CollisionPair{b.handle, a.handle});
+        }
+      }
+    }
+    std::sort(pairs_.begin(), pairs_.end(), PairLess{});
+
+    // 前回と今回のペアを比べて、重なり始め・離れたペアを求める
+    begins_.clear();
+    ends_.clear();
+    std::set_difference(pairs_.begin(), pairs_.end(), previous_pairs_.begin(),
+                        previous_pairs_.end(), std::back_inserter(begins_), PairLess{});
+    std::set_difference(previous_pairs_.begin(), previous_pairs_.end(), pairs_.begin(),
+                        pairs_.end(), std::back_inserter(ends_), PairLess{});
+  }
+
+  /**
+   * @brief ペアの並び順（(a.index, b.index)、同じなら世代番号）
+   */
+  struct PairLess {
+    bool operator()(const CollisionPair& lhs, const CollisionPair& rhs) const {
+      Uint64 lhs_index = key(lhs.a.index, lhs.b.index);
+      Uint64 rhs_index = key(rhs.a.index, rhs.b.index);
+      if (lhs_index != rhs_index) return lhs_index < rhs_index;
+      return key(lhs.a.generation, lhs.b.generation) < key(rhs.a.generation, rhs.b.generation);
+    }
+
+    static Uint64 key(Uint32 high, Uint32 low) { return (static_cast<Uint64>(high) << 32) | low; }
+  };
+
+  /**
+   * @brief 半直線と矩形の交差（スラブ法）
+   * @return max_distance以内で交わる場合true（out_distanceに入る距離）
+   */
+  static bool intersectRay(const Aabb& box, float x, float y, float dir_x, float dir_y,
+                           float max_distance, float& out_distance) {
+    float t_min = 0.0f;
+    float t_max = max_distance;
+    const float origin[2] = {x, y};
+    const float dir[2] = {dir_x, dir_y};
+    const float lo[2] = {box.min_x, box.min_y};
+    const float hi[2] = {box.max_x, box.max_y};
+    for (int axis = 0; axis < 2; ++axis) {
+      if (dir[axis] == 0.0f) {
+        if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+        continue;
+      }
+      float t1 = (lo[axis] - origin[axis]) / dir[axis];
+      float t2 = (hi[axis] - origin[axis]) / dir[axis];
+      if (t1 > t2) std::swap(t1, t2);
+      t_min = std::max(t_min, t1);
+      t_max = std::min(t_max, t2);
+      if (t_min > t_max) return false;
+    }
+    out_distance = t_min;
+    return true;
+  }
+
+  float cell_size_;      // セルの一辺の長さ
+  float inv_cell_size_;  // 1 / cell_size_
+
+  std::vector<Proxy> proxies_;       // 登録されたエンティティ
+  std::vector<Uint32> free_proxies_;  // proxies_の空き
+  std::vector<Slot> slots_;           // エンティティのスロット番号ごとの情報
+  std::unordered_map<Uint64, std::vector<Uint32>> cells_;  // セルごとのproxies_の添字
+  size_t occupied_cells_ = 0;  // 前回のfindPairs()で空でなかったセルの数
+  CellRange occupied_range_{0, 0, -1, -1};  // 前回のfindPairs()で空でなかったセルを囲む範囲
+
+  std::array<Uint64, 7> cursors_{};  // 型ごとのforEachChanged()の続きのティック
+  Uint64 removal_cursor_ = 0;        // forEachRemoved<Collider>()の続きのティック
+  Uint32 update_stamp_ = 0;          // update()の番号
+  std::vector<Entity*> dirty_;       // 登録し直すエンティティ（作業用）
+
+  std::vector<CollisionPair> pairs_;           // 重なっているペア
+  std::vector<CollisionPair> previous_pairs_;  // 前回のupdate()のペア（作業用）
+  std::vector<CollisionPair> begins_;          // 重なり始めたペア
+  std::vector<CollisionPair> ends_;            // 離れたペア
+
+  mutable Uint32 query_stamp_ = 0;       // クエリの番号
+  mutable std::vector<Uint32> visited_;  // proxies_ごとに最後に調べたクエリの番号
+};
+
+}  // namespace MyGame
@@ -0,0 +1,476 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "entity_manager.h"
+#include "spatial_hash.h"
+#include "utilities/tiled_map_loader.h"
+
+namespace MyGame {
+
+/**
+ * @brief TileGrid::sweep()の結果
+ */
+struct TileSweep {
+  float dx = 0.0f, dy = 0.0f;  // 実際に動ける量（ピクセル）
+  bool hit_x = false;          // X方向の移動が壁で止まったか
+  bool hit_y = false;          // Y方向の移動が壁で止まったか
+};
+
+/**
+ * @brief 通れないタイルをビット列で持つ当たり判定用のグリッド
+ *
+ * タイルごとの「通れない」を1ビットにまとめ、行ごと（横に64タイルで1ワード）と
+ * 列ごと（縦に64タイルで1ワード）の2通りに並べて持ちます。
+ * 矩形の移動では、進む先の列（横移動）や行（縦移動）について、矩形が占める範囲の
+ * ビットをマスクしたワードで一度に調べるため、タイルを1つずつ見ることはありません。
+ *
+ * 移動はX方向、Y方向の順に分けて行い、壁に当たった軸はその手前で止めます。
+ * グリッドの外は通れるものとして扱います。
+ *
+ * 使用例:
+ * @code
+ * Utilities::TiledMap map;
+ * Utilities::load_tiled_map("resources/maps/stage1.tmj", map);
+ * TileGrid tiles;
+ * tiles.loadLayer(map, "blocks");  // 0以外のタイルを通れないものにする
+ *
+ * // 毎ステップ（updateAll()の前）: 次のステップで壁にめり込まない速度に抑える
+ * tiles.clampVelocity(*player, step_ms);
+ * @endcode
+ *
+ * note: エンティティを扱う関数は、ワールド座標とローカル座標が平行移動だけで
+ *       対応する（親が回転・拡大していない）エンティティを前提にしています
+ */
+class TileGrid {
+ public:
+  TileGrid() = default;
+
+  /**
+   * @brief コンストラクタ（すべて通れるタイルで初期化）
+   * @param width タイル数（横）
+   * @param height タイル数（縦）
+   * @param tile_width タイルの幅（ピクセル）
+   * @param tile_height タイルの高さ（ピクセル）
+   */
+  TileGrid(int width, int height, float tile_width, float tile_height) {
+    resize(width, height, tile_width, tile_height);
+  }
+
+  /**
+   * @brief 大きさを変えて、すべて通れるタイルにする
+   * @param width タイル数（横）
+   * @param height タイル数（縦）
+   * @param tile_width タイルの幅（ピクセル）
+   * @param tile_height タイルの高さ（ピクセル）
+   */
+  void resize(int width, int height, float tile_width, float tile_height) {
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+    tile_width_ = tile_width > 0.0f ? tile_width : 1.0f;
+    tile_height_ = tile_height > 0.0f ? tile_height : 1.0f;
+    row_words_ = (width_ + 63) / 64;
+    column_words_ = (height_ + 63) / 64;
+    rows_.assign(static_cast<size_t>(row_words_) * height_, 0);
+    columns_.assign(static_cast<size_t>(column_words_) * width_, 0);
+    ++version_;
+    // 大きさが変わると以前のタイル座標は意味を持たないので、変更の記録もやり直す
+    changes_.clear();
+    change_log_floor_ = version_;
+  }
+
+  /**
+   * @brief Tiledのタイルレイヤーから読み込む（0以外のタイルを通れないものにする）
+   * @param map 読み込んだマップ
+   * @param layer_name タイルレイヤーの名前
+   * @return レイヤーが見つかった場合true
+   */
+  bool loadLayer(const Utilities::TiledMap& map, std::string_view layer_name) {
+    return loadLayer(map, layer_name, [](Uint32 gid) { return gid != 0; });
+  }
+
+  /**
+   * @brief Tiledのタイルレイヤーから読み込む
+   * @param map 読み込んだマップ
+   * @param layer_name タイルレイヤーの名前
+   * @param is_solid (Uint32 gid) -> bool。通れないタイルならtrue
+   * @return レイヤーが見つかった場合true
+   */
+  template <typename IsSolid>
+  bool loadLayer(const Utilities::TiledMap& map, std::string_view layer_name,
+                 IsSolid&& is_solid) {
+    const Utilities::TiledTileLayer* layer = map.findTileLayer(layer_name);
+    if (!layer) {
+      SDL_Log("TileGrid: tile layer '%.*s' not found", static_cast<int>(layer_name.size()),
+              layer_name.data());
+      return false;
+    }
+    resize(layer->width, layer->height, static_cast<float>(map.tile_width),
+           static_cast<float>(map.tile_height));
+    for (int y = 0; y < height_; ++y) {
+      for (int x = 0; x < width_; ++x) {
+        if (is_solid(layer->getTile(x, y))) setBits(x, y, true);
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief グリッドの左上のワールド座標を設定（デフォルト: (0, 0)）
+   */
+  void setOrigin(float x, float y) {
+    origin_x_ = x;
+    origin_y_ = y;
+    ++version_;
+  }
+
+  /**
+   * @brief タイルを通れる／通れないに設定（範囲外は無視）
+   */
+  void setSolid(int x, int y, bool solid) {
+    if (!inBounds(x, y) || isSolid(x, y) == solid) return;
+    setBits(x, y, solid);
+    ++version_;
+    if (changes_.size() >= MAX_CHANGE_LOG) {
+      // 古い半分を捨てる（それより前の版からの問い合わせには全体を作り直してもらう）
+      size_t dropped = changes_.size() / 2;
+      change_log_floor_ = changes_[dropped - 1].version;
+      changes_.erase(changes_.begin(), changes_.begin() + dropped);
+    }
+    changes_.push_back(TileChange{version_, x, y});
+  }
+
+  /**
+   * @brief 通れないタイルか（範囲外はfalse）
+   */
+  bool isSolid(int x, int y) const {
+    if (!inBounds(x, y)) return false;
+    return (rows_[static_cast<size_t>(y) * row_words_ + x / 64] >> (x % 64)) & 1;
+  }
+
+  /**
+   * @brief 行yのx0～x1（両端を含む）に通れないタイルがあるか
+   */
+  bool anySolidInRow(int y, int x0, int x1) const {
+    if (y < 0 || y >= height_) return false;
+    return findFirst(rowWords(y), std::max(x0, 0), std::min(x1, width_ - 1)) >= 0;
+  }
+
+  /**
+   * @brief 列xのy0～y1（両端を含む）に通れないタイルがあるか
+   */
+  bool anySolidInColumn(int x, int y0, int y1) const {
+    if (x < 0 || x >= width_) return false;
+    return findFirst(columnWords(x), std::max(y0, 0), std::min(y1, height_ - 1)) >= 0;
+  }
+
+  /**
+   * @brief 矩形（ワールド座標）が通れないタイルに重なっているか（辺が接するだけなら重ならない）
+   */
+  bool overlapsSolid(const Aabb& box) const {
+    int x0 = firstColumn(box.min_x);
+    int x1 = lastColumn(box.max_x);
+    for (int y = std::max(firstRow(box.min_y), 0); y <= std::min(lastRow(box.max_y), height_ - 1);
+         ++y) {
+      if (anySolidInRow(y, x0, x1)) return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief 矩形をX方向、Y方向の順に動かしたときに、壁の手前までで動ける量を求める
+   * @param box 動かす矩形（ワールド座標）
+   * @param dx X方向の移動量（ピクセル）
+   * @param dy Y方向の移動量（ピクセル）
+   * @return 動ける量と、止まった軸
+   *
+   * 進む先の列（行）ごとに、矩形が占める行（列）の範囲をまとめて調べます。
+   * 最初から重なっているタイルは無視します（めり込んだ状態からは抜け出せる）。
+   */
+  TileSweep sweep(const Aabb& box, float dx, float dy) const {
+    TileSweep result;
+    result.dx = dx;
+    result.dy = dy;
+    if (width_ == 0 || height_ == 0) return result;
+
+    // X方向: 進む先の列を、矩形が占める行の範囲で調べる
+    if (dx != 0.0f) {
+      int y0 = firstRow(box.min_y);
+      int y1 = lastRow(box.max_y);
+      if (dx > 0.0f) {
+        int from = std::max(lastColumn(box.max_x) + 1, 0);
+        int to = std::min(lastColumn(box.max_x + dx), width_ - 1);
+        for (int x = from; x <= to; ++x) {
+          if (anySolidInColumn(x, y0, y1)) {
+            result.dx = origin_x_ + x * tile_width_ - box.max_x;
+            result.hit_x = true;
+            break;
+          }
+        }
+      } else {
+        int from = std::min(firstColumn(box.min_x) - 1, width_ - 1);
+        int to = std::max(firstColumn(box.min_x + dx), 0);
+        for (int x = from; x >= to; --x) {
+          if (anySolidInColumn(x, y0, y1)) {
+            result.dx = origin_x_ + (x + 1) * tile_width_ - box.min_x;
+            result.hit_x = true;
+            break;
+          }
+        }
+      }
+    }
+
+    // Y方向: X方向に動いた後の矩形で、進む先の行を調べる
+    if (dy != 0.0f) {
+      int x0 = firstColumn(box.min_x + result.dx);
+      int x1 = lastColumn(box.max_x + result.dx);
+      if (dy > 0.0f) {
+        int from = std::max(lastRow(box.max_y) + 1, 0);
+        int to = std::min(lastRow(box.max_y + dy), height_ - 1);
+        for (int y = from; y <= to; ++y) {
+          if (anySolidInRow(y, x0, x1)) {
+            result.dy = origin_y_ + y * tile_height_ - box.max_y;
+            result.hit_y = true;
+            break;
+          }
+        }
+      } else {
+        int from = std::min(firstRow(box.min_y) - 1, height_ - 1);
+        int to = std::max(firstRow(box.min_y + dy), 0);
+        for (int y = from; y >= to; --y) {
+          if (anySolidInRow(y, x0, x1)) {
+            result.dy = origin_y_ + (y + 1) * tile_height_ - box.min_y;
+            result.hit_y = true;
+            break;
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief エンティティを壁の手前まで動かす（Locatorの座標を書き換える）
+   * @param entity 動かすエンティティ（衝突範囲はcomputeColliderBounds()）
+   * @param dx X方向の移動量（ピクセル）
+   * @param dy Y方向の移動量（ピクセル）
+   * @return 動いた量と、止まった軸
+   */
+  TileSweep moveEntity(Entity& entity, float dx, float dy) const {
+    Aabb box;
+    auto* locator = entity.getComponent<Locator>();
+    if (!locator || !computeColliderBounds(entity, box)) {
+      return TileSweep{0.0f, 0.0f, false, false};
+    }
+    TileSweep result = sweep(box, dx, dy);
+    auto [x, y] = locator->getPosition();
+    locator->setPosition(x + result.dx, y + result.dy);
+    return result;
+  }
+
+  /**
+   * @brief 次のステップで壁にめり込まないように、VelocityMoveの速度を抑える
+   * @param entity 対象のエンティティ（衝突範囲はcomputeColliderBounds()）
+   * @param delta_time 次のステップの時間（ミリ秒）
+   * @return 次のステップで動く量と、止まる軸
+   *
+   * 壁に当たる軸の速度を、ちょうど壁に接する位置で止まる速さに書き換えます。
+   * 移動はこれまでどおりVelocityMoveが行うため、描画の補間などはそのまま使えます。
+   * 壁に接した後の速度は0になります。
+   */
+  TileSweep clampVelocity(Entity& entity, Uint64 delta_time) const {
+    auto* velocity = entity.getComponent<VelocityMove>();
+    Aabb box;
+    if (!velocity || delta_time == 0 || !computeColliderBounds(entity, box)) {
+      return TileSweep{0.0f, 0.0f, false, false};
+    }
+    const float dt_sec = static_cast<float>(delta_time) / 1000.0f;
+    auto [vx, vy] = velocity->getVelocity();
+    TileSweep result = sweep(box, vx * dt_sec, vy * dt_sec);
+    if (result.hit_x || result.hit_y) {
+      velocity->setVelocity(result.hit_x ? result.dx / dt_sec : vx,
+                            result.hit_y ? result.dy / dt_sec : vy);
+    }
+    return result;
+  }
+
+  /**
+   * @brief 通れないタイルを塗りつぶして描画（デバッグ用）
+   * @param renderer SDLレンダラー
+   * @param camera 視点（nullptrならワールド座標をそのまま画面座標にする）
+   *
+   * 行ごとに連続した通れないタイルを1つの矩形にまとめて描画します。色は呼び出し側で設定します。
+   */
+  void render(SDL_Renderer* renderer, const Camera2D* camera = nullptr) const {
+    float zoom = 1.0f;
+    float offset_x = 0.0f;
+    float offset_y = 0.0f;
+    if (camera) {
+      auto [ox, oy] = camera->worldToScreen(0.0f, 0.0f);
+      offset_x = ox;
+      offset_y = oy;
+      zoom = camera->getZoom();
+    }
+
+    std::vector<SDL_FRect>& rects = render_rects_;
+    rects.clear();
+    for (int y = 0; y < height_; ++y) {
+      const Uint64* words = rowWords(y);
+      int x = 0;
+      while ((x = findFirst(words, x, width_ - 1)) >= 0) {
+        int end = findFirst<true>(words, x, width_ - 1);
+        if (end < 0) end = width_;
+        rects.push_back(SDL_FRect{(origin_x_ + x * tile_width_) * zoom + offset_x,
+                                  (origin_y_ + y * tile_height_) * zoom + offset_y,
+                                  (end - x) * tile_width_ * zoom, tile_height_ * zoom});
+        x = end;
+      }
+    }
+    if (!rects.empty()) {
+      SDL_RenderFillRects(renderer, rects.data(), static_cast<int>(rects.size()));
+    }
+  }
+
+  int getWidth() const { return width_; }
+  int getHeight() const { return height_; }
+  float getTileWidth() const { return tile_width_; }
+  float getTileHeight() const { return tile_height_; }
+  std::pair<float, float> getOrigin() const { return {origin_x_, origin_y_}; }
+
+  /**
+   * @brief 変更の版（タイルや大きさが変わるたびに増える）
+   *
+   * 経路のキャッシュなど、グリッドから作ったデータを作り直すかの判定に使います。
+   */
+  Uint64 getVersion() const { return version_; }
+
+  /**
+   * @brief 指定した版より後に通れる／通れないが変わったタイルを列挙
+   * @param since_version 前回見たときのgetVersion()の値
+   * @param func (int x, int y)を受け取る関数（同じタイルが複数回来ることがある）
+   * @return 列挙できた場合true。大きさが変わった、または記録が古くて残っていない場合はfalse
+   *
+   * falseの場合は、グリッドから作ったデータを全体から作り直してください。
+   */
+  template <typename Func>
+  bool forEachChangedTile(Uint64 since_version, Func&& func) const {
+    if (since_version < change_log_floor_) return false;
+    auto first = std::upper_bound(
+        changes_.begin(), changes_.end(), since_version,
+        [](Uint64 version, const TileChange& change) { return version < change.version; });
+    for (; first != changes_.end(); ++first) {
+      func(first->x, first->y);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 行yのビット列（getRowWordCount()個のワード、ビットxが列x、幅より先のビットは0）
+   */
+  const Uint64* getRowBits(int y) const { return rowWords(y); }
+  int getRowWordCount() const { return row_words_; }
+
+  /**
+   * @brief 列xのビット列（getColumnWordCount()個のワード、ビットyが行y、高さより先のビットは0）
+   */
+  const Uint64* getColumnBits(int x) const { return columnWords(x); }
+  int getColumnWordCount() const { return column_words_; }
+
+  /**
+   * @brief ワールド座標からタイルの座標を求める（範囲外も含む）
+   * @return {列, 行}
+   */
+  std::pair<int, int> worldToTile(float x, float y) const {
+    return {static_cast<int>(std::floor((x - origin_x_) / tile_width_)),
+            static_cast<int>(std::floor((y - origin_y_) / tile_height_))};
+  }
+
+ private:
+  // 矩形の辺がタイルの境界にちょうど乗っているときに、浮動小数点の誤差で
+  // 隣のタイルに重なったとみなさないための幅（ピクセル）
+  static constexpr float EDGE_EPSILON = 0.01f;
+
+  // setSolid()の記録を残す最大数（超えたら古い半分を捨てる）
+  static constexpr size_t MAX_CHANGE_LOG = 4096;
+
+  /**
+   * @brief setSolid()による変更の記録
+   */
+  struct TileChange {
+    Uint64 version;  // 変更後の版
+    int x, y;        // タイルの座標
+  };
+
+  bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < width_ && y < height_; }
+
+  void setBits(int x, int y, bool solid) {
+    Uint64& row = rows_[static_cast<size_t>(y) * row_words_ + x / 64];
+    Uint64& column = columns_[static_cast<size_t>(x) * column_words_ + y / 64];
+    Uint64 row_bit = Uint64{1} << (x % 64);
+    Uint64 column_bit = Uint64{1} << (y % 64);
+    row = solid ? (row | row_bit) : (row & ~row_bit);
+    column = solid ? (column | column_bit) : (column & ~column_bit);
+  }
+
+  const Uint64* rowWords(int y) const { return rows_.data() + static_cast<size_t>(y) * row_words_; }
+  const Uint64* columnWords(int x) const {
+    return columns_.data() + static_cast<size_t>(x) * column_words_;
+  }
+
+  /**
+   * @brief ビット列のfrom～to（両端を含む）で最初に立っているビットの位置を探す
+   * @tparam Inverted trueなら立っていないビットを探す
+   * @return 見つからなければ-1
+   */
+  template <bool Inverted = false>
+  static int findFirst(const Uint64* words, int from, int to) {
+    if (from > to) return -1;
+    int last_word = to / 64;
+    for (int word = from / 64; word <= last_word; ++word) {
+      Uint64 bits = Inverted ? ~words[word] : words[word];
+      if (word == from / 64) bits &= ~Uint64{0} << (from % 64);
+      if (word == last_word) bits &= ~Uint64{0} >> (63 - to % 64);
+      if (bits != 0) return word * 64 + std::countr_zero(bits);
+    }
+    return -1;
+  }
+
+  // 矩形が重なるタイルの範囲（辺がタイルの境界に乗っている場合、その先のタイルは含まない）
+  int firstColumn(float min_x) const {
+    return static_cast<int>(std::floor((min_x - origin_x_ + EDGE_EPSILON) / tile_width_));
+  }
+  int lastColumn(float max_x) const {
+    return static_cast<int>(std::ceil((max_x - origin_x_ - EDGE_EPSILON) / tile_width_)) - 1;
+  }
+  int firstRow(float min_y) const {
+    return static_cast<int>(std::floor((min_y - origin_y_ + EDGE_EPSILON) / tile_height_));
+  }
+  int lastRow(float max_y) const {
+    return static_cast<int>(std::ceil((max_y - origin_y_ - EDGE_EPSILON) / tile_height_)) - 1;
+  }
+
+  int width_ = 0;   // タイル数（横）
+  int height_ = 0;  // タイル数（縦）
+  float tile_width_ = 1.0f;   // タイルの幅（ピクセル）
+  float tile_height_ = 1.0f;  // タイルの高さ（ピクセル）
+  float origin_x_ = 0.0f;     // 左上のワールド座標
+  float origin_y_ = 0.0f;
+  int row_words_ = 0;         // 1行あたりのワード数
+  int column_words_ = 0;      // 1列あたりのワード数
+  std::vector<Uint64> rows_;     // 行ごとのビット列（ビットxが列x）
+  std::vector<Uint64> columns_;  // 列ごとのビット列（ビットyが行y）
+  Uint64 version_ = 0;           // 変更の版
+  std::vector<TileChange> changes_;  // setSolid()の記録（版の順）
+  Uint64 change_log_floor_ = 0;      // この版より後の変更はすべてchanges_にある
+
+  mutable std::vector<SDL_FRect> render_rects_;  // render()の作業用バッファ（容量を再利用する）
+};
+
+}  // namespace MyGame
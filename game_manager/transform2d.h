@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cmath>
+#include <utility>
+
+namespace MyGame {
+
+/**
+ * @brief 2Dのワールド変換（平行移動・回転・スケール）
+ *
+ * 「スケール → 回転 → 平行移動」の順に適用するアフィン変換を、
+ * 分解済みの形（座標・角度・スケール・cos/sin）で保持します。
+ * cos/sinは合成時に一度だけ計算されるため、描画時に三角関数を呼ぶ必要がありません。
+ */
+struct Transform2D {
+  float x = 0.0f, y = 0.0f;              // 平行移動（ワールド座標）
+  float angle = 0.0f;                    // 回転角度（度数法）
+  float scale_x = 1.0f, scale_y = 1.0f;  // スケール
+  float cos_a = 1.0f, sin_a = 0.0f;      // 回転角度のcos/sin（キャッシュ）
+
+  /**
+   * @brief 変換行列の各要素を取得
+   *
+   * | a  c  x |
+   * | b  d  y |
+   */
+  float a() const { return cos_a * scale_x; }
+  float b() const { return sin_a * scale_x; }
+  float c() const { return -sin_a * scale_y; }
+  float d() const { return cos_a * scale_y; }
+
+  /**
+   * @brief ローカル座標にこの変換を適用
+   * @param local_x ローカルX座標
+   * @param local_y ローカルY座標
+   * @return 変換後の座標 {x, y}
+   */
+  std::pair<float, float> apply(float local_x, float local_y) const {
+    float scaled_x = local_x * scale_x;
+    float scaled_y = local_y * scale_y;
+    return {x + scaled_x * cos_a - scaled_y * sin_a,
+            y + scaled_x * sin_a + scaled_y * cos_a};
+  }
+
+  /**
+   * @brief 親の変換とローカル値から子の変換を合成
+   * @param parent 親のワールド変換
+   * @param local_x ローカルX座標
+   * @param local_y ローカルY座標
+   * @param local_angle ローカル回転角度（度数法）
+   * @param local_scale_x ローカルX方向スケール
+   * @param local_scale_y ローカルY方向スケール
+   * @return 子のワールド変換
+   *
+   * 座標は親の変換を適用し、角度は加算、スケールは乗算で合成します。
+   */
+  static Transform2D compose(const Transform2D& parent, float local_x,
+                             float local_y, float local_angle,
+                             float local_scale_x, float local_scale_y) {
+    Transform2D result;
+    auto [world_x, world_y] = parent.apply(local_x, local_y);
+    result.x = world_x;
+    result.y = world_y;
+    result.angle = parent.angle + local_angle;
+    result.scale_x = parent.scale_x * local_scale_x;
+    result.scale_y = parent.scale_y * local_scale_y;
+
+    // 角度が変わらない場合は三角関数を省略
+    if (local_angle == 0.0f) {
+      result.cos_a = parent.cos_a;
+      result.sin_a = parent.sin_a;
+    } else {
+      float rad = result.angle * (3.14159265358979323846f / 180.0f);
+      result.cos_a = std::cos(rad);
+      result.sin_a = std::sin(rad);
+    }
+    return result;
+  }
+
+  /**
+   * @brief 2つの変換の間を補間
+   * @param from t=0での変換
+   * @param to t=1での変換
+   * @param t 補間係数（0.0～1.0）
+   * @return 補間した変換
+   *
+   * 座標とスケールは線形、角度は近い方の向きに回るように補間します。
+   */
+  static Transform2D lerp(const Transform2D& from, const Transform2D& to, float t) {
+    Transform2D result;
+    result.x = from.x + (to.x - from.x) * t;
+    result.y = from.y + (to.y - from.y) * t;
+    result.scale_x = from.scale_x + (to.scale_x - from.scale_x) * t;
+    result.scale_y = from.scale_y + (to.scale_y - from.scale_y) * t;
+
+    // 角度が変わらない場合は三角関数を省略
+    if (from.angle == to.angle) {
+      result.angle = to.angle;
+      result.cos_a = to.cos_a;
+      result.sin_a = to.sin_a;
+    } else {
+      float diff = std::fmod(to.angle - from.angle, 360.0f);
+      if (diff > 180.0f) diff -= 360.0f;
+      if (diff < -180.0f) diff += 360.0f;
+      result.angle = from.angle + diff * t;
+      float rad = result.angle * (3.14159265358979323846f / 180.0f);
+      result.cos_a = std::cos(rad);
+      result.sin_a = std::sin(rad);
+    }
+    return result;
+  }
+};
+
+}  // namespace MyGame
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "entity_handle.h"
+
+namespace MyGame {
+
+/**
+ * @brief トゥイーンで変化させるプロパティ
+ */
+enum class TweenProperty : Uint8 {
+  Position,  // Locatorの座標 {x, y}
+  Angle,     // Rotaterの角度 {angle}（度数法、360度を超えて回せる）
+  Scale,     // Scalerのスケール {scale_x, scale_y}
+  Color,     // RectRenderer/RotatedRectRendererの色 {r, g, b, a}（0～255）
+  Pivot,     // RotatedRectRendererのピボット {pivot_x, pivot_y}
+};
+
+/**
+ * @brief イージング（時間の進み方）
+ *
+ * すべて f(t) = a*t^3 + b*t^2 + c*t の3次式で表し、係数だけをトゥイーンごとに持ちます。
+ * 種類による分岐がないため、全トゥイーンを1つのループでまとめて計算できます。
+ */
+enum class Easing : Uint8 {
+  Linear,      // 一定の速さ
+  QuadIn,      // 加速（2次）
+  QuadOut,     // 減速（2次）
+  CubicIn,     // 加速（3次）
+  CubicOut,    // 減速（3次）
+  SmoothStep,  // 加速してから減速
+  BackIn,      // 少し戻ってから加速
+  BackOut,     // 少し行き過ぎてから戻る
+};
+
+/**
+ * @brief トゥイーンの繰り返し方
+ */
+enum class TweenLoop : Uint8 {
+  None,      // 1回で終了
+  Repeat,    // 始点に戻って繰り返す
+  PingPong,  // 往復を繰り返す
+};
+
+/**
+ * @brief トゥイーンの値（プロパティに応じて先頭から1～4要素を使う）
+ */
+using TweenValue = std::array<float, 4>;
+
+/**
+ * @brief 色をトゥイーンの値に変換
+ * @param color 色
+ * @return {r, g, b, a}
+ */
+inline TweenValue toTweenValue(SDL_Color color) {
+  return {static_cast<float>(color.r), static_cast<float>(color.g),
+          static_cast<float>(color.b), static_cast<float>(color.a)};
+}
+
+/**
+ * @brief トゥイーンの追加設定
+ */
+struct TweenOptions {
+  Easing easing = Easing::Linear;  // イージング
+  TweenLoop loop = TweenLoop::None;  // 繰り返し方
+  Uint64 delay_ms = 0;  // 開始までの待ち時間（待っている間は始点の値を設定する）
+};
+
+/**
+ * @brief コンポーネントのプロパティをまとめて補間するトゥイーン（EntityManagerが所有）
+ *
+ * 各トゥイーンの状態を配列ごとに分けて（SoA）持ち、advance()では
+ * 時間とイージング、値の計算をそれぞれ全トゥイーン分の単純なループで行います。
+ * 最後に値をコンポーネントへ書き込み、終了したトゥイーンを開始順のまま詰めて取り除きます。
+ * 配列の容量は残るため、終了と開始を繰り返しても確保は発生しません。
+ *
+ * 使用例:
+ * @code
+ * auto& tweens = entity_manager.getTweens();
+ * tweens.start(handle, TweenProperty::Position, {100.0f, 100.0f}, {300.0f, 100.0f}, 500,
+ *              {Easing::CubicOut});
+ * tweens.start(handle, TweenProperty::Color, toTweenValue(from), toTweenValue(to), 1000,
+ *              {Easing::Linear, TweenLoop::PingPong});
+ * @endcode
+ *
+ * note: 同じエンティティ・プロパティのトゥイーンを重ねると、後から開始したものが優先されます。
+ *       置き換える場合は先にcancel()してください。
+ */
+class TweenSystem {
+ public:
+  TweenSystem() = default;
+  TweenSystem(const TweenSystem&) = delete;
+  TweenSystem& operator=(const TweenSystem&) = delete;
+
+  /**
+   * @brief トゥイーンを開始（最初の反映は次のadvance()）
+   * @param owner 対象のエンティティ
+   * @param property 変化させるプロパティ
+   * @param from 始点の値
+   * @param to 終点の値
+   * @param duration_ms 始点から終点までの時間（ミリ秒、0なら次のadvance()で終点にする）
+   * @param options イージング・繰り返し・開始の遅延
+   */
+  void start(EntityHandle owner, TweenProperty property, const TweenValue& from,
+             const TweenValue& to, Uint64 duration_ms, const TweenOptions& options = {}) {
+    const EasingCurve& curve = EASING_CURVES[static_cast<size_t>(options.easing)];
+    float duration = static_cast<float>(std::max<Uint64>(duration_ms, 1));
+
+    owners_.push_back(owner);
+    properties_.push_back(property);
+    elapsed_.push_back(-static_cast<float>(options.delay_ms));
+    inv_duration_.push_back(1.0f / duration);
+    period_.push_back(options.loop == TweenLoop::None       ? 0.0f
+                      : options.loop == TweenLoop::PingPong ? duration * 2.0f
+                                                            : duration);
+    mirror_.push_back(options.loop == TweenLoop::PingPong ? 1.0f : 0.0f);
+    ease_a_.push_back(curve.a);
+    ease_b_.push_back(curve.b);
+    ease_c_.push_back(curve.c);
+    eased_.push_back(0.0f);
+    finished_.push_back(0);
+    for (size_t k = 0; k < CHANNELS; ++k) {
+      from_[k].push_back(from[k]);
+      delta_[k].push_back(to[k] - from[k]);
+      value_[k].push_back(from[k]);
+    }
+  }
+
+  /**
+   * @brief エンティティのトゥイーンをすべて取り消す（値はその時点のまま）
+   * @param owner 対象のエンティティ
+   */
+  void cancel(EntityHandle owner) {
+    bool found = false;
+    for (size_t i = 0; i < owners_.size(); ++i) {
+      if (owners_[i] == owner) {
+        finished_[i] = 1;
+        found = true;
+      }
+    }
+    if (found) removeFinished();
+  }
+
+  /**
+   * @brief エンティティの指定したプロパティのトゥイーンを取り消す（値はその時点のまま）
+   * @param owner 対象のエンティティ
+   * @param property プロパティ
+   */
+  void cancel(EntityHandle owner, TweenProperty property) {
+    bool found = false;
+    for (size_t i = 0; i < owners_.size(); ++i) {
+      if (owners_[i] == owner && properties_[i] == property) {
+        finished_[i] = 1;
+        found = true;
+      }
+    }
+    if (found) removeFinished();
+  }
+
+  /**
+   * @brief 時間を進め、値をコンポーネントへ反映
+   * @param delta_ms 進める時間（ミリ秒）
+   * @param apply (EntityHandle, TweenProperty, const TweenValue&) -> bool。
+   *              値を書き込み、対象がなければfalseを返す（そのトゥイーンは取り除かれる）
+   */
+  template <typename Apply>
+  void advance(Uint64 delta_ms, Apply&& apply) {
+    const size_t count = owners_.size();
+    if (count == 0) return;
+    const float dt = static_cast<float>(delta_ms);
+
+    // 時間とイージング（繰り返しは周期で巻き戻し、往復の後半は折り返す）
+    float* elapsed = elapsed_.data();
+    float* eased = eased_.data();
+    Uint8* finished = finished_.data();
+    const float* inv_duration = inv_duration_.data();
+    const float* period = period_.data();
+    const float* mirror = mirror_.data();
+    const float* ease_a = ease_a_.data();
+    const float* ease_b = ease_b_.data();
+    const float* ease_c = ease_c_.data();
+    for (size_t i = 0; i < count; ++i) {
+      float e = elapsed[i] + dt;
+      float wrapped = period[i] > 0.0f && e >= period[i]
+                          ? e - period[i] * std::floor(e / period[i])
+                          : e;
+      elapsed[i] = wrapped;
+      float raw = std::max(wrapped * inv_duration[i], 0.0f);
+      float t = raw > 1.0f ? 1.0f - mirror[i] * (raw - 1.0f) : raw;
+      finished[i] = period[i] == 0.0f && raw >= 1.0f;
+      eased[i] = ((ease_a[i] * t + ease_b[i]) * t + ease_c[i]) * t;
+    }
+
+    // 値 = 始点 + 差分 * イージング
+    for (size_t k = 0; k < CHANNELS; ++k) {
+      float* value = value_[k].data();
+      const float* from = from_[k].data();
+      const float* delta = delta_[k].data();
+      for (size_t i = 0; i < count; ++i) {
+        value[i] = from[i] + delta[i] * eased[i];
+      }
+    }
+
+    // コンポーネントへの反映（開始順なので、重なったトゥイーンは後から開始したものが残る）
+    TweenValue out;
+    bool any_finished = false;
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t k = 0; k < CHANNELS; ++k) out[k] = value_[k][i];
+      if (!apply(owners_[i], properties_[i], out)) finished_[i] = 1;
+      any_finished |= finished_[i] != 0;
+    }
+
+    if (any_finished) removeFinished();
+  }
+
+  /**
+   * @brief すべてのトゥイーンを破棄（値はその時点のまま）
+   */
+  void clear() {
+    owners_.clear();
+    properties_.clear();
+    elapsed_.clear();
+    inv_duration_.clear();
+    period_.clear();
+    mirror_.clear();
+    ease_a_.clear();
+    ease_b_.clear();
+    ease_c_.clear();
+    eased_.clear();
+    finished_.clear();
+    for (size_t k = 0; k < CHANNELS; ++k) {
+      from_[k].clear();
+      delta_[k].clear();
+      value_[k].clear();
+    }
+  }
+
+  /**
+   * @brief 同時に実行するトゥイーン数の容量を事前確保
+   * @param capacity トゥイーン数
+   */
+  void reserve(size_t capacity) {
+    owners_.reserve(capacity);
+    properties_.reserve(capacity);
+    elapsed_.reserve(capacity);
+    inv_duration_.reserve(capacity);
+    period_.reserve(capacity);
+    mirror_.reserve(capacity);
+    ease_a_.reserve(capacity);
+    ease_b_.reserve(capacity);
+    ease_c_.reserve(capacity);
+    eased_.reserve(capacity);
+    finished_.reserve(capacity);
+    for (size_t k = 0; k < CHANNELS; ++k) {
+      from_[k].reserve(capacity);
+      delta_[k].reserve(capacity);
+      value_[k].reserve(capacity);
+    }
+  }
+
+  /**
+   * @brief 実行中（開始待ちを含む）のトゥイーン数を取得
+   */
+  size_t getCount() const { return owners_.size(); }
+
+ private:
+  static constexpr size_t CHANNELS = 4;
+
+  // イージングの係数（f(t) = a*t^3 + b*t^2 + c*t、f(0) = 0、f(1) = 1）
+  struct EasingCurve {
+    float a, b, c;
+  };
+  static constexpr float BACK = 1.70158f;  // Back系の行き過ぎの量
+  static constexpr EasingCurve EASING_CURVES[] = {
+      {0.0f, 0.0f, 1.0f},                               // Linear
+      {0.0f, 1.0f, 0.0f},                               // QuadIn: t^2
+      {0.0f, -1.0f, 2.0f},                              // QuadOut: 1-(1-t)^2
+      {1.0f, 0.0f, 0.0f},                               // CubicIn: t^3
+      {1.0f, -3.0f, 3.0f},                              // CubicOut: 1-(1-t)^3
+      {-2.0f, 3.0f, 0.0f},                              // SmoothStep: 3t^2-2t^3
+      {BACK + 1.0f, -BACK, 0.0f},                       // BackIn
+      {BACK + 1.0f, -2.0f * BACK - 3.0f, BACK + 3.0f},  // BackOut
+  };
+
+  /**
+   * @brief finished_が立っているトゥイーンを取り除き、残りを開始順のまま前へ詰める
+   *
+   * 重なったトゥイーンの優先順位は配列の順序で決まるため、末尾との入れ替えは使いません。
+   */
+  void removeFinished() {
+    const size_t count = owners_.size();
+    const Uint8* finished = finished_.data();
+    auto compact = [count, finished](auto& values) {
+      size_t kept = 0;
+      for (size_t i = 0; i < count; ++i) {
+        if (!finished[i]) values[kept++] = values[i];
+      }
+      values.resize(kept);
+    };
+    compact(owners_);
+    compact(properties_);
+    compact(elapsed_);
+    compact(inv_duration_);
+    compact(period_);
+    compact(mirror_);
+    compact(ease_a_);
+    compact(ease_b_);
+    compact(ease_c_);
+    compact(eased_);
+    for (size_t k = 0; k < CHANNELS; ++k) {
+      compact(from_[k]);
+      compact(delta_[k]);
+      compact(value_[k]);
+    }
+    finished_.assign(owners_.size(), 0);  // 残ったものはすべて未終了
+  }
+
+  std::vector<EntityHandle> owners_;       // 対象のエンティティ
+  std::vector<TweenProperty> properties_;  // 変化させるプロパティ
+  std::vector<float> elapsed_;       // 経過時間（ミリ秒、遅延中は負）
+  std::vector<float> inv_duration_;  // 1 / 時間
+  std::vector<float> period_;        // 繰り返しの周期（ミリ秒、繰り返さないなら0）
+  std::vector<float> mirror_;        // 往復なら1（周期の後半を折り返す）
+  std::vector<float> ease_a_;        // イージングの係数
+  std::vector<float> ease_b_;
+  std::vector<float> ease_c_;
+  std::vector<float> eased_;         // イージング後の進み具合（作業用）
+  std::vector<Uint8> finished_;      // 終了したか（作業用）
+  std::array<std::vector<float>, CHANNELS> from_;   // 始点の値
+  std::array<std::vector<float>, CHANNELS> delta_;  // 終点 - 始点
+  std::array<std::vector<float>, CHANNELS> value_;  // 計算した値（作業用）
+};
+
+}  // namespace MyGame
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace MyGame::Utilities {
+
+/**
+ * @brief フレームごとの処理時間を区間（フェーズ）別に計測するクラス
+ *
+ * activate()したプロファイラーに対して、Scopeで囲んだ区間の時間を加算します。
+ * 有効なプロファイラーがない場合、Scopeはポインタを1回読むだけで何もしません。
+ * フレームごとに記録した値から、平均・パーセンタイルをJSONで出力できます。
+ *
+ * note: メインスレッドからのみ使用してください（ワーカースレッドのScopeは対象外）
+ *
+ * 使用例:
+ * @code
+ * Utilities::FrameProfiler profiler;
+ * profiler.activate();
+ * for (int i = 0; i < 1000; ++i) {
+ *   profiler.beginFrame();
+ *   {
+ *     Utilities::FrameProfiler::Scope scope("update");
+ *     entity_manager.updateAll(16);
+ *   }
+ *   profiler.endFrame();
+ * }
+ * SDL_Log("%s", profiler.toJson().c_str());
+ * @endcode
+ */
+class FrameProfiler {
+ public:
+  /**
+   * @brief 区間の計測（コンストラクタからデストラクタまでの時間を加算）
+   */
+  class Scope {
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param phase 区間名（文字列リテラル、JSONのキーになるので英数字と._のみ）
+     */
+    explicit Scope(const char* phase) : profiler_(active_) {
+      if (profiler_) {
+        index_ = profiler_->phaseIndex(phase);
+        start_ = SDL_GetPerformanceCounter();
+      }
+    }
+
+    ~Scope() {
+      if (profiler_) {
+        profiler_->phases_[index_].current += SDL_GetPerformanceCounter() - start_;
+      }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    FrameProfiler* profiler_;
+    size_t index_ = 0;
+    Uint64 start_ = 0;
+  };
+
+  /**
+   * @brief 集計結果（ミリ秒、counterは値そのもの）
+   */
+  struct Summary {
+    double mean = 0.0;
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    double total = 0.0;
+  };
+
+  FrameProfiler() : frequency_(SDL_GetPerformanceFrequency()) {}
+
+  ~FrameProfiler() {
+    if (active_ == this) {
+      active_ = nullptr;
+    }
+  }
+
+  FrameProfiler(const FrameProfiler&) = delete;
+  FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+  /**
+   * @brief このプロファイラーを計測先にする
+   */
+  void activate() { active_ = this; }
+
+  /**
+   * @brief 計測を止める
+   */
+  static void deactivate() { active_ = nullptr; }
+
+  /**
+   * @brief 現在の計測先を取得
+   * @return プロファイラー（計測していない場合はnullptr）
+   */
+  static FrameProfiler* getActive() { return active_; }
+
+  /**
+   * @brief フレームの計測を開始（計測先になっていなければ何もしない）
+   */
+  void beginFrame() {
+    if (active_ != this) {
+      return;
+    }
+    frame_start_ = SDL_GetPerformanceCounter();
+    for (Phase& phase : phases_) {
+      phase.current = 0;
+    }
+  }
+
+  /**
+   * @brief フレームの計測を終了して記録（計測先になっていなければ何もしない）
+   */
+  void endFrame() {
+    if (active_ != this) {
+      return;
+    }
+    frame_times_.push_back(toMilliseconds(SDL_GetPerformanceCounter() - frame_start_));
+    for (Phase& phase : phases_) {
+      phase.samples.push_back(toMilliseconds(phase.current));
+    }
+    for (Counter& counter : counters_) {
+      counter.samples.push_back(counter.current);
+    }
+  }
+
+  /**
+   * @brief このフレームのカウンター値を設定（エンティティ数など）
+   * @param name カウンター名（文字列リテラル、Scopeの区間名と同じ制約）
+   * @param value 値
+   *
+   * 設定しなかったフレームは前回の値を記録します。
+   */
+  void setCounter(const char* name, double value) {
+    for (Counter& counter : counters_) {
+      if (counter.name == name || std::strcmp(counter.name, name) == 0) {
+        counter.current = value;
+        return;
+      }
+    }
+    counters_.push_back(Counter{name, value, std::vector<double>(frame_times_.size(), 0.0)});
+  }
+
+  /**
+   * @brief frames個のフレーム分の記録領域を事前確保（計測中の確保を避ける）
+   * @param frames フレーム数
+   */
+  void reserve(size_t frames) {
+    reserved_frames_ = frames;
+    frame_times_.reserve(frames);
+    for (Phase& phase : phases_) {
+      phase.samples.reserve(frames);
+    }
+    for (Counter& counter : counters_) {
+      counter.samples.reserve(frames);
+    }
+  }
+
+  /**
+   * @brief 記録したフレーム数を取得
+   */
+  size_t getFrameCount() const { return frame_times_.size(); }
+
+  /**
+   * @brief フレーム全体の時間を集計
+   */
+  Summary summarizeFrames() const { return summarize(frame_times_); }
+
+  /**
+   * @brief 区間の時間を集計
+   * @param phase 区間名
+   * @return 集計結果（記録がない場合はすべて0）
+   */
+  Summary summarizePhase(const char* phase) const {
+    for (const Phase& p : phases_) {
+      if (std::strcmp(p.name, phase) == 0) return summarize(p.samples);
+    }
+    return Summary{};
+  }
+
+  /**
+   * @brief 記録をすべて破棄（区間名とカウンター名も消える）
+   */
+  void clear() {
+    frame_times_.clear();
+    phases_.clear();
+    counters_.clear();
+  }
+
+  /**
+   * @brief 集計結果をJSONで取得
+   * @return {"frames", "frame_ms", "phases": {名前: 集計}, "counters": {名前: 集計}}
+   *
+   * 区間は最初に計測された順、カウンターは最初に設定された順に並びます。
+   */
+  std::string toJson() const {
+    std::string json = "{\"frames\": " + std::to_string(frame_times_.size());
+    json += ", \"frame_ms\": ";
+    appendSummary(json, summarizeFrames());
+
+    json += ", \"phases\": {";
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      json += i > 0 ? ", \"" : "\"";
+      json += phases_[i].name;
+      json += "\": ";
+      appendSummary(json, summarize(phases_[i].samples));
+    }
+
+    json += "}, \"counters\": {";
+    for (size_t i = 0; i < counters_.size(); ++i) {
+      json += i > 0 ? ", \"" : "\"";
+      json += counters_[i].name;
+      json += "\": ";
+      appendSummary(json, summarize(counters_[i].samples));
+    }
+    json += "}}";
+    return json;
+  }
+
+ private:
+  struct Phase {
+    const char* name;
+    std::vector<double> samples;  // フレームごとの合計（ミリ秒）
+    Uint64 current = 0;           // 計測中のフレームの合計（パフォーマンスカウンターの値）
+  };
+
+  struct Counter {
+    const char* name;
+    double current;
+    std::vector<double> samples;  // フレームごとの値
+  };
+
+  /**
+   * @brief 区間名から添字を取得（初出なら追加）
+   *
+   * 区間の数は少ないので線形探索します（文字列リテラルならポインタ比較で一致する）。
+   */
+  size_t phaseIndex(const char* name) {
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      if (phases_[i].name == name || std::strcmp(phases_[i].name, name) == 0) {
+        return i;
+      }
+    }
+    // 途中から現れた区間は、それまでのフレームを0として埋める
+    phases_.push_back(Phase{name, std::vector<double>(frame_times_.size(), 0.0)});
+    phases_.back().samples.reserve(reserved_frames_);
+    return phases_.size() - 1;
+  }
+
+  double toMilliseconds(Uint64 counter) const {
+    return static_cast<double>(counter) * 1000.0 / static_cast<double>(frequency_);
+  }
+
+  static Summary summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+
+    std::sort(samples.begin(), samples.end());
+    for (double sample : samples) {
+      summary.total += sample;
+    }
+    summary.mean = summary.total / static_cast<double>(samples.size());
+    summary.p50 = percentile(samples, 0.50);
+    summary.p90 = percentile(samples, 0.90);
+    summary.p99 = percentile(samples, 0.99);
+    summary.max = samples.back();
+    return summary;
+  }
+
+  /**
+   * @brief パーセンタイル（最近傍順位法、samplesは昇順）
+   */
+  static double percentile(const std::vector<double>& samples, double ratio) {
+    size_t rank = static_cast<size_t>(std::ceil(ratio * static_cast<double>(samples.size())));
+    return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+  }
+
+  static void appendSummary(std::string& json, const Summary& summary) {
+    char buffer[192];
+    SDL_snprintf(buffer, sizeof(buffer),
+                 "{\"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, "
+                 "\"max\": %.4f, \"total\": %.4f}",
+                 summary.mean, summary.p50, summary.p90, summary.p99, summary.max,
+                 summary.total);
+    json += buffer;
+  }
+
+  static inline FrameProfiler* active_ = nullptr;  // 計測先（非所有）
+
+  Uint64 frequency_;               // パフォーマンスカウンターの周波数
+  Uint64 frame_start_ = 0;         // 計測中のフレームの開始時刻
+  size_t reserved_frames_ = 0;     // 事前確保したフレーム数
+  std::vector<double> frame_times_;  // フレームごとの時間（ミリ秒）
+  std::vector<Phase> phases_;        // 区間ごとの記録（初出順）
+  std::vector<Counter> counters_;    // カウンターごとの記録（初出順）
+};
+
+}  // namespace MyGame::Utilities
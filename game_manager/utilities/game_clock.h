@@ -0,0 +1,57 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+namespace MyGame::Utilities {
+
+/**
+ * @brief ゲームの時刻（ミリ秒）
+ *
+ * 通常はSDL_GetTicks()をそのまま返します。
+ * 固定ステップにすると、advance()を呼ぶたびに一定量だけ進む時刻を返します
+ * （ヘッドレス実行やベンチマークで、実時間に依存せず同じフレーム列を再現するため）。
+ * ゲームの進行に使う時刻はSDL_GetTicks()ではなくこちらから取得してください。
+ */
+class GameClock {
+ public:
+  /**
+   * @brief 現在の時刻を取得
+   * @return ミリ秒
+   */
+  static Uint64 getTicks() { return fixed_step_ > 0 ? fixed_ticks_ : SDL_GetTicks(); }
+
+  /**
+   * @brief 現在の時刻をナノ秒で取得
+   * @return ナノ秒
+   */
+  static Uint64 getTicksNS() {
+    return fixed_step_ > 0 ? fixed_ticks_ * SDL_NS_PER_MS : SDL_GetTicksNS();
+  }
+
+  /**
+   * @brief 固定ステップに切り替える
+   * @param step_ms advance()1回で進む時間（ミリ秒、0なら実時間に戻す）
+   *
+   * 時刻は0から始まります。ゲーム実装を構築する前に呼んでください。
+   */
+  static void setFixedStep(Uint64 step_ms) {
+    fixed_step_ = step_ms;
+    fixed_ticks_ = 0;
+  }
+
+  /**
+   * @brief 固定ステップの時刻を1ステップ進める（実時間のときは何もしない）
+   */
+  static void advance() { fixed_ticks_ += fixed_step_; }
+
+  /**
+   * @brief 固定ステップかどうか
+   */
+  static bool isFixedStep() { return fixed_step_ > 0; }
+
+ private:
+  static inline Uint64 fixed_step_ = 0;   // 1ステップの時間（0なら実時間）
+  static inline Uint64 fixed_ticks_ = 0;  // 固定ステップの現在時刻
+};
+
+}  // namespace MyGame::Utilities
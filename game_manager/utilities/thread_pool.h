@@ -0,0 +1,225 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MyGame::Utilities {
+
+/**
+ * @brief ワークスティーリング方式のスレッドプール
+ *
+ * ワーカーごとにタスクのキューを持ち、自分のキューが空になると
+ * 他のワーカーのキューからタスクを盗んで実行します。
+ * wait()を呼んだスレッドも、待っている間はタスクの実行を手伝います。
+ *
+ * 使用例:
+ * @code
+ * Utilities::ThreadPool pool;
+ * pool.parallelFor(entities.size(), 1024, [&](size_t begin, size_t end) {
+ *   for (size_t i = begin; i < end; ++i) { ... }
+ * });
+ * @endcode
+ */
+class ThreadPool {
+ public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief 完了待ちのためのタスクのまとまり
+   */
+  struct TaskGroup {
+    std::atomic<size_t> remaining{0};  // 未完了のタスク数
+  };
+
+  /**
+   * @brief コンストラクタ
+   * @param thread_count ワーカースレッド数（0なら論理コア数-1、最低1）
+   */
+  explicit ThreadPool(size_t thread_count = 0) {
+    if (thread_count == 0) {
+      int cores = SDL_GetNumLogicalCPUCores();
+      thread_count = static_cast<size_t>(std::max(cores - 1, 1));
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+      queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+      workers_.emplace_back([this, i]() { workerLoop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  /**
+   * @brief ワーカースレッド数を取得
+   */
+  size_t getThreadCount() const { return workers_.size(); }
+
+  /**
+   * @brief 呼び出したスレッドが、このプールの何番目のワーカーかを取得
+   * @return ワーカーなら1～getThreadCount()、それ以外のスレッド（wait()で手伝うスレッドを含む）は0
+   *
+   * ワーカーごとのバッファに書き込み、後でまとめるときの添字に使います。
+   */
+  size_t getCurrentWorkerIndex() const {
+    return current_pool_ == this ? current_worker_index_ : 0;
+  }
+
+  /**
+   * @brief タスクをグループに追加して実行を依頼
+   * @param group 完了を待つためのグループ
+   * @param task 実行するタスク
+   */
+  void run(TaskGroup& group, Task task) {
+    group.remaining.fetch_add(1, std::memory_order_relaxed);
+    push([&group, task = std::move(task)]() {
+      task();
+      group.remaining.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  /**
+   * @brief グループのタスクがすべて完了するまで待つ
+   * @param group 待つグループ
+   *
+   * 待っている間、呼び出したスレッドもキューのタスクを実行します。
+   */
+  void wait(TaskGroup& group) {
+    size_t start = next_queue_.load(std::memory_order_relaxed);
+    while (group.remaining.load(std::memory_order_acquire) > 0) {
+      if (!runOne(start)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  /**
+   * @brief [0, count)を分割して並列に処理
+   * @param count 要素数
+   * @param grain_size 1タスクあたりの最小要素数
+   * @param body (begin, end)を受け取る関数
+   *
+   * 呼び出したスレッドも処理に参加し、すべての範囲が完了してから戻ります。
+   */
+  void parallelFor(size_t count, size_t grain_size,
+                   const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    grain_size = std::max<size_t>(grain_size, 1);
+    size_t max_tasks = getThreadCount() + 1;
+    size_t task_count = std::min(max_tasks, (count + grain_size - 1) / grain_size);
+    if (task_count <= 1) {
+      body(0, count);
+      return;
+    }
+
+    size_t chunk = (count + task_count - 1) / task_count;
+    TaskGroup group;
+    // 先頭以外の範囲をワーカーに任せ、先頭の範囲は呼び出したスレッドで処理する
+    for (size_t begin = chunk; begin < count; begin += chunk) {
+      size_t end = std::min(begin + chunk, count);
+      run(group, [&body, begin, end]() { body(begin, end); });
+    }
+    body(0, std::min(chunk, count));
+    wait(group);
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void push(Task task) {
+    {
+      // 待機判定と通知の間で起床を取りこぼさないようにロックを取る
+      // note: 取り出し側の減算より先に加算されるよう、キューに積む前に数える
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    size_t index =
+        next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+      std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+      queues_[index]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief タスクを1つ取り出して実行
+   * @param home 最初に調べるキュー（自分のキューは末尾から、他は先頭から取る）
+   * @return 実行した場合true
+   */
+  bool runOne(size_t home) {
+    Task task;
+    for (size_t n = 0; n < queues_.size(); ++n) {
+      Queue& queue = *queues_[(home + n) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) continue;
+      if (n == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      break;
+    }
+    if (!task) return false;
+
+    pending_.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+  }
+
+  void workerLoop(size_t index) {
+    current_pool_ = this;
+    current_worker_index_ = index + 1;
+    while (true) {
+      if (runOne(index)) continue;
+
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this]() {
+        return stopping_ || pending_.load(std::memory_order_relaxed) > 0;
+      });
+      if (stopping_ && pending_.load(std::memory_order_relaxed) == 0) {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;  // ワーカーごとのキュー
+  std::vector<std::thread> workers_;            // ワーカースレッド
+  std::atomic<size_t> next_queue_{0};           // 次に積むキュー（ラウンドロビン）
+  std::atomic<size_t> pending_{0};              // キューに積まれている未実行タスク数
+
+  static inline thread_local const ThreadPool* current_pool_ = nullptr;  // 実行中のワーカーの所属
+  static inline thread_local size_t current_worker_index_ = 0;         // 実行中のワーカーの番号（1から）
+
+  std::mutex sleep_mutex_;        // 待機用
+  std::condition_variable wake_;  // 待機中のワーカーを起こす
+  bool stopping_ = false;         // 終了要求
+};
+
+}  // namespace MyGame::Utilities
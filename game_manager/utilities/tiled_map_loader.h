@@ -0,0 +1,410 @@
+#pragma once
+
+#include <SDL3/SDL.h>
+
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MyGame {
+namespace Utilities {
+
+/**
+ * @brief Tiledのタイルレイヤー
+ */
+struct TiledTileLayer {
+  std::string name;
+  int width = 0;   // タイル数（横）
+  int height = 0;  // タイル数（縦）
+  std::vector<Uint32> tiles;  // 左上から行ごとのグローバルタイルID（反転フラグは除く、0は空）
+
+  /**
+   * @brief タイルのグローバルタイルIDを取得
+   * @return 範囲外なら0
+   */
+  Uint32 getTile(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) return 0;
+    return tiles[static_cast<size_t>(y) * width + x];
+  }
+};
+
+/**
+ * @brief Tiledのマップ（.tmj）のうち、タイルレイヤーに関わる部分
+ */
+struct TiledMap {
+  int width = 0;        // タイル数（横）
+  int height = 0;       // タイル数（縦）
+  int tile_width = 0;   // タイルの幅（ピクセル）
+  int tile_height = 0;  // タイルの高さ（ピクセル）
+  std::vector<TiledTileLayer> tile_layers;  // ファイル内の順（グループの中のレイヤーも含む）
+
+  /**
+   * @brief 名前でタイルレイヤーを探す
+   * @return 見つからなければnullptr
+   */
+  const TiledTileLayer* findTileLayer(std::string_view name) const {
+    for (const TiledTileLayer& layer : tile_layers) {
+      if (layer.name == name) return &layer;
+    }
+    return nullptr;
+  }
+};
+
+namespace detail {
+
+/**
+ * @brief .tmjを読むための最小限のJSONパーサー
+ *
+ * 必要なキーだけを取り出し、それ以外の値は読み飛ばします。
+ */
+class TiledJsonParser {
+ public:
+  explicit TiledJsonParser(std::string_view text) : text_(text) {}
+
+  bool parseMap(TiledMap& map) {
+    bool infinite = false;
+    bool ok = parseObject([&](std::string_view key) {
+      if (key == "width") return parseInt(map.width);
+      if (key == "height") return parseInt(map.height);
+      if (key == "tilewidth") return parseInt(map.tile_width);
+      if (key == "tileheight") return parseInt(map.tile_height);
+      if (key == "infinite") return parseBool(infinite);
+      if (key == "layers") return parseLayers(map);
+      return skipValue();
+    });
+    if (!ok) return false;
+    if (infinite) {
+      SDL_Log("Tiled map: infinite maps are not supported");
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief エラーの位置（先頭からの文字数）
+   */
+  size_t getPosition() const { return position_; }
+
+ private:
+  static constexpr Uint32 FLIP_FLAGS = 0xF0000000;  // タイルIDの上位4ビット（反転・回転）
+
+  bool parseLayers(TiledMap& map) {
+    return parseArray([&]() {
+      TiledTileLayer layer;
+      std::string type;
+      std::string encoding;
+      std::string compression;
+      std::string encoded;  // base64の場合の"data"（"encoding"は後に書かれることがある）
+      bool has_chunks = false;
+      bool ok = parseObject([&](std::string_view key) {
+        if (key == "type") return parseString(type);
+        if (key == "name") return parseString(layer.name);
+        if (key == "width") return parseInt(layer.width);
+        if (key == "height") return parseInt(layer.height);
+        if (key == "encoding") return parseString(encoding);
+        if (key == "compression") return parseString(compression);
+        if (key == "data") return parseData(layer.tiles, encoded);
+        if (key == "chunks") {
+          has_chunks = true;
+          return skipValue();
+        }
+        // グループレイヤーの中のレイヤー
+        if (key == "layers") return parseLayers(map);
+        return skipValue();
+      });
+      if (!ok || type != "tilelayer") return ok;
+
+      if (has_chunks || !compression.empty()) {
+        SDL_Log("Tiled map: layer '%s' uses chunks or compression (not supported)",
+                layer.name.c_str());
+        return false;
+      }
+      if (!encoded.empty()) {
+        if (encoding != "base64") {
+          SDL_Log("Tiled map: layer '%s' has unknown encoding '%s'", layer.name.c_str(),
+                  encoding.c_str());
+          return false;
+        }
+        decodeBase64(encoded, layer.tiles);
+      }
+      if (layer.width < 0 || layer.height < 0 ||
+          layer.tiles.size() != static_cast<size_t>(layer.width) * layer.height) {
+        SDL_Log("Tiled map: layer '%s' has %zu tiles for %dx%d", layer.name.c_str(),
+                layer.tiles.size(), layer.width, layer.height);
+        return false;
+      }
+      map.tile_layers.push_back(std::move(layer));
+      return true;
+    });
+  }
+
+  /**
+   * @brief タイルの配列を読む
+   * @param tiles 数値の配列の場合の読み込み先
+   * @param encoded 文字列（base64）の場合の読み込み先（レイヤーを読み終えてから変換する）
+   */
+  bool parseData(std::vector<Uint32>& tiles, std::string& encoded) {
+    skipSpaces();
+    if (peek() == '"') return parseString(encoded);
+    return parseArray([&]() {
+      double value = 0.0;
+      // 範囲外の値をUint32へキャストすると未定義動作になるので、読み込みを失敗させる
+      if (!parseNumber(value)) return false;
+      if (!(value >= 0.0 && value <= std::numeric_limits<Uint32>::max())) return false;
+      tiles.push_back(static_cast<Uint32>(value) & ~FLIP_FLAGS);
+      return true;
+    });
+  }
+
+  static void decodeBase64(std::string_view text, std::vector<Uint32>& tiles) {
+    std::vector<Uint8> bytes;
+    Uint32 buffer = 0;
+    int bits = 0;
+    for (char c : text) {
+      int value;
+      if (c >= 'A' && c <= 'Z') value = c - 'A';
+      else if (c >= 'a' && c <= 'z') value = c - 'a' + 26;
+      else if (c >= '0' && c <= '9') value = c - '0' + 52;
+      else if (c == '+') value = 62;
+      else if (c == '/') value = 63;
+      else continue;  // '='と空白
+      buffer = (buffer << 6) | static_cast<Uint32>(value);
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        bytes.push_back(static_cast<Uint8>(buffer >> bits));
+      }
+    }
+    // リトルエンディアンの32ビット整数の並び
+    for (size_t i = 0; i + 3 < bytes.size(); i += 4) {
+      Uint32 gid = bytes[i] | (bytes[i + 1] << 8) | (bytes[i + 2] << 16) |
+                   (static_cast<Uint32>(bytes[i + 3]) << 24);
+      tiles.push_back(gid & ~FLIP_FLAGS);
+    }
+  }
+
+  template <typename OnKey>
+  bool parseObject(OnKey&& on_key) {
+    if (!consume('{')) return false;
+    skipSpaces();
+    if (peek() == '}') return consume('}');
+    while (true) {
+      std::string key;
+      if (!parseString(key) || !consume(':') || !on_key(std::string_view(key))) return false;
+      skipSpaces();
+      if (peek() == '}') return consume('}');
+      if (!consume(',')) return false;
+    }
+  }
+
+  template <typename OnElement>
+  bool parseArray(OnElement&& on_element) {
+    if (!consume('[')) return false;
+    skipSpaces();
+    if (peek() == ']') return consume(']');
+    while (true) {
+      if (!on_element()) return false;
+      skipSpaces();
+      if (peek() == ']') return consume(']');
+      if (!consume(',')) return false;
+    }
+  }
+
+  bool parseString(std::string& out) {
+    if (!consume('"')) return false;
+    out.clear();
+    while (position_ < text_.size()) {
+      char c = text_[position_++];
+      if (c == '"') return true;
+      if (c == '\\') {
+        if (position_ >= text_.size()) return false;
+        char escaped = text_[position_++];
+        switch (escaped) {
+          case 'n': out += '\n'; break;
+          case 't': out += '\t'; break;
+          case 'r': out += '\r'; break;
+          case 'b': out += '\b'; break;
+          case 'f': out += '\f'; break;
+          case 'u':  // 名前の比較には使わないので、\uXXXXは'?'に置き換える
+            // 16進数4桁が続いていなければ不正な文字列として失敗させる
+            if (text_.size() - position_ < 4) return false;
+            for (size_t i = 0; i < 4; ++i) {
+              if (!isHexDigit(text_[position_ + i])) return false;
+            }
+            position_ += 4;
+            out += '?';
+            break;
+          default: out += escaped; break;
+        }
+      } else {
+        out += c;
+      }
+    }
+    return false;
+  }
+
+  static bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+  }
+
+  bool parseNumber(double& out) {
+    skipSpaces();
+    // 文字列が終端されているとは限らないので、数値の部分だけを写してから変換する
+    char buffer[64];
+    size_t length = 0;
+    while (position_ + length < text_.size() && length + 1 < sizeof(buffer)) {
+      char c = text_[position_ + length];
+      if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' ||
+            c == 'E')) {
+        break;
+      }
+      buffer[length++] = c;
+    }
+    buffer[length] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buffer, &end);
+    if (end == buffer) return false;
+    position_ += static_cast<size_t>(end - buffer);
+    return true;
+  }
+
+  bool parseInt(int& out) {
+    double value = 0.0;
+    if (!parseNumber(value)) return false;
+    // 範囲外（NaNを含む）の値をintへキャストすると未定義動作になるので、読み込みを失敗させる
+    if (!(value >= static_cast<double>(std::numeric_limits<int>::min()) &&
+          value <= static_cast<double>(std::numeric_limits<int>::max()))) {
+      return false;
+    }
+    out = static_cast<int>(value);
+    return true;
+  }
+
+  bool parseBool(bool& out) {
+    skipSpaces();
+    if (text_.substr(position_, 4) == "true") {
+      position_ += 4;
+      out = true;
+      return true;
+    }
+    if (text_.substr(position_, 5) == "false") {
+      position_ += 5;
+      out = false;
+      return true;
+    }
+    return false;
+  }
+
+  bool skipValue() {
+    skipSpaces();
+    switch (peek()) {
+      case '{':
+        return parseObject([&](std::string_view) { return skipValue(); });
+      case '[':
+        return parseArray([&]() { return skipValue(); });
+      case '"': {
+        std::string ignored;
+        return parseString(ignored);
+      }
+      case 't':
+      case 'f': {
+        bool ignored;
+        return parseBool(ignored);
+      }
+      case 'n':
+        if (text_.substr(position_, 4) != "null") return false;
+        position_ += 4;
+        return true;
+      default: {
+        double ignored;
+        return parseNumber(ignored);
+      }
+    }
+  }
+
+  bool consume(char expected) {
+    skipSpaces();
+    if (peek() != expected) return false;
+    ++position_;
+    return true;
+  }
+
+  char peek() const { return position_ < text_.size() ? text_[position_] : '\0'; }
+
+  void skipSpaces() {
+    while (position_ < text_.size() &&
+           (text_[position_] == ' ' || text_[position_] == '\n' || text_[position_] == '\r' ||
+            text_[position_] == '\t')) {
+      ++position_;
+    }
+  }
+
+  std::string_view text_;
+  size_t position_ = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Tiledのマップ（JSON形式）の文字列からタイルレイヤーを読み込む
+ * @param text .tmjファイルの内容
+ * @param out_map 読み込み先（失敗した場合の内容は不定）
+ * @return 成功した場合true
+ *
+ * タイルの配列は数値の配列と、圧縮なしのbase64に対応しています。
+ * 無限マップ（チャンク）と圧縮したレイヤーは読めません。
+ */
+inline bool parse_tiled_map(std::string_view text, TiledMap& out_map) {
+  out_map = TiledMap{};
+  detail::TiledJsonParser parser(text);
+  if (!parser.parseMap(out_map)) {
+    SDL_Log("Failed to parse Tiled map near offset %zu", parser.getPosition());
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Tiledのマップ（.tmj）ファイルからタイルレイヤーを読み込む
+ * @param filename ファイル名（実行ファイルのディレクトリからの相対パス）
+ * @param out_map 読み込み先
+ * @return 成功した場合true
+ *
+ * 使用例:
+ * @code
+ * Utilities::TiledMap map;
+ * if (Utilities::load_tiled_map("resources/maps/stage1.tmj", map)) {
+ *   const Utilities::TiledTileLayer* blocks = map.findTileLayer("blocks");
+ * }
+ * @endcode
+ */
+inline bool load_tiled_map(const char* filename, TiledMap& out_map) {
+  if (!filename) {
+    SDL_Log("Invalid parameters: filename is null");
+    return false;
+  }
+
+  char* path_raw = nullptr;
+  SDL_asprintf(&path_raw, "%s%s", SDL_GetBasePath(), filename);
+  std::unique_ptr<char, decltype(&SDL_free)> path(path_raw, &SDL_free);
+  if (!path) {
+    SDL_Log("Failed to allocate path string");
+    return false;
+  }
+
+  size_t size = 0;
+  void* file = SDL_LoadFile(path.get(), &size);
+  if (!file) {
+    SDL_Log("Failed to load Tiled map '%s': %s", filename, SDL_GetError());
+    return false;
+  }
+  bool ok = parse_tiled_map(std::string_view(static_cast<const char*>(file), size), out_map);
+  SDL_free(file);
+  return ok;
+}
+
+}  // namespace Utilities
+}  // namespace MyGame
@@ -0,0 +1,192 @@
+// note: build & run: cmake --build build --target headless_runner && ./build/headless_runner --frames 600
+//
+// ウィンドウを表示せずにゲーム実装を固定ステップでNフレーム実行し、計測結果をJSONで出力します。
+// SDLのoffscreenビデオドライバーとdummyオーディオドライバーを使うので、ディスプレイのないLinuxでも動きます。
+//
+// 使い方: headless_runner [--game test3|test2|snake] [--frames N] [--warmup N]
+//                         [--delta MS] [--seed N] [--out PATH]
+//
+// 乱数（SDL_rand）は毎回同じシードで初期化するので、同じ引数なら同じワールドを実行します。
+
+#include <SDL3/SDL.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "../game/snake.h"
+#include "../game/test_impl_2.h"
+#include "../game/test_impl_3.h"
+#include "../game_constant.h"
+#include "../game_manager/game_manager.h"
+#include "../game_manager/utilities/frame_profiler.h"
+#include "../game_manager/utilities/game_clock.h"
+
+namespace {
+
+struct Options {
+  std::string game = "test3";  // 実行するゲーム実装
+  size_t frames = 600;         // 計測するフレーム数
+  size_t warmup = 60;          // 計測前に捨てるフレーム数
+  Uint64 delta_ms = 16;        // 1フレームの時間（ミリ秒）
+  Uint64 seed = 1;             // SDL_rand()のシード（実行ごとに同じワールドにする）
+  std::string out;             // JSONの出力先（空なら標準出力）
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!value) {
+      SDL_Log("Missing value for %s", arg);
+      return false;
+    }
+    if (std::strcmp(arg, "--game") == 0) {
+      options.game = value;
+    } else if (std::strcmp(arg, "--frames") == 0) {
+      options.frames = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--warmup") == 0) {
+      options.warmup = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--delta") == 0) {
+      options.delta_ms = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--seed") == 0) {
+      options.seed = std::strtoull(value, nullptr, 10);
+    } else if (std::strcmp(arg, "--out") == 0) {
+      options.out = value;
+    } else {
+      SDL_Log("Unknown option: %s", arg);
+      return false;
+    }
+    ++i;
+  }
+  if (options.frames == 0 || options.delta_ms == 0) {
+    SDL_Log("--frames and --delta must be greater than 0");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief ゲーム実装を固定ステップで実行して計測
+ * @tparam GameType 実行するゲーム実装
+ * @return 成功した場合true
+ */
+template <typename GameType>
+  requires(MyGame::GameImplementation<GameType>)
+bool runGame(SDL_Renderer* renderer, const Options& options) {
+  using MyGame::Utilities::FrameProfiler;
+  using MyGame::Utilities::GameClock;
+
+  // ゲーム実装が構築時に読む時刻と乱数から固定する
+  GameClock::setFixedStep(options.delta_ms);
+  SDL_srand(options.seed);
+  MyGame::GameManager<GameType> game_manager(std::make_unique<GameType>(renderer));
+
+  FrameProfiler profiler;
+  profiler.reserve(options.frames);
+  Uint64 start = SDL_GetPerformanceCounter();
+
+  for (size_t frame = 0; frame < options.warmup + options.frames; ++frame) {
+    // ウォームアップが終わったら計測を開始
+    if (frame == options.warmup) {
+      profiler.activate();
+      start = SDL_GetPerformanceCounter();
+    }
+    const bool measuring = frame >= options.warmup;
+    GameClock::advance();
+    if (measuring) {
+      profiler.beginFrame();
+    }
+
+    SDL_AppResult result = SDL_APP_CONTINUE;
+    {
+      FrameProfiler::Scope scope("events");
+      SDL_Event event;
+      while (result == SDL_APP_CONTINUE && SDL_PollEvent(&event)) {
+        result = game_manager.handleSdlEvent(&event);
+      }
+    }
+    if (result == SDL_APP_CONTINUE) {
+      FrameProfiler::Scope scope("update");
+      result = game_manager.update();
+    }
+
+    if (measuring) {
+      profiler.endFrame();
+    }
+    if (result != SDL_APP_CONTINUE) {
+      SDL_Log("Game finished at frame %zu", frame);
+      break;
+    }
+  }
+  FrameProfiler::deactivate();
+  double wall_ms = static_cast<double>(SDL_GetPerformanceCounter() - start) * 1000.0 /
+                   static_cast<double>(SDL_GetPerformanceFrequency());
+
+  char header[256];
+  SDL_snprintf(header, sizeof(header),
+               "{\"game\": \"%s\", \"delta_ms\": %llu, \"warmup\": %zu, \"seed\": %llu, "
+               "\"wall_ms\": %.3f, \"profile\": ",
+               options.game.c_str(), static_cast<unsigned long long>(options.delta_ms),
+               options.warmup, static_cast<unsigned long long>(options.seed), wall_ms);
+  std::string json = header + profiler.toJson() + "}\n";
+
+  if (options.out.empty()) {
+    std::fputs(json.c_str(), stdout);
+    return true;
+  }
+  if (!SDL_SaveFile(options.out.c_str(), json.data(), json.size())) {
+    SDL_Log("Failed to write %s: %s", options.out.c_str(), SDL_GetError());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    return EXIT_FAILURE;
+  }
+
+  // 実際の表示・音声出力を使わない（環境変数で指定されていればそちらを優先）
+  SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+  SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+  SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+  if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO)) {
+    SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+    return EXIT_FAILURE;
+  }
+
+  SDL_Window* window = nullptr;
+  SDL_Renderer* renderer = nullptr;
+  if (!SDL_CreateWindowAndRenderer(MyGame::APP_TITLE, MyGame::CANVAS_WIDTH,
+                                   MyGame::CANVAS_HEIGHT, SDL_WINDOW_HIDDEN, &window,
+                                   &renderer)) {
+    SDL_Log("Couldn't create window/renderer: %s", SDL_GetError());
+    SDL_Quit();
+    return EXIT_FAILURE;
+  }
+  SDL_SetRenderLogicalPresentation(renderer, MyGame::CANVAS_WIDTH, MyGame::CANVAS_HEIGHT,
+                                   SDL_LOGICAL_PRESENTATION_LETTERBOX);
+
+  bool ok = false;
+  if (options.game == "test3") {
+    ok = runGame<MyGame::TestImpl3>(renderer, options);
+  } else if (options.game == "test2") {
+    ok = runGame<MyGame::TestImpl2>(renderer, options);
+  } else if (options.game == "snake") {
+    ok = runGame<MyGame::SnakeGame::SnakeGame>(renderer, options);
+  } else {
+    SDL_Log("Unknown game: %s", options.game.c_str());
+  }
+
+  SDL_DestroyRenderer(renderer);
+  SDL_DestroyWindow(window);
+  SDL_Quit();
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}